@@ -0,0 +1,67 @@
+/***********************************************************************************************************************
+*  OpenStudio(R), Copyright (c) 2020-2023, OpenStudio Coalition and other contributors. All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+*  following conditions are met:
+*
+*  (1) Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+*  disclaimer.
+*
+*  (2) Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+*  disclaimer in the documentation and/or other materials provided with the distribution.
+*
+*  (3) Neither the name of the copyright holder nor the names of any contributors may be used to endorse or promote products
+*  derived from this software without specific prior written permission from the respective party.
+*
+*  (4) Other than as required in clauses (1) and (2), distributions in any form of modifications or other derivative works
+*  may not use the "OpenStudio" trademark, "OS", "os", or any other confusingly similar designation without specific prior
+*  written permission from Alliance for Sustainable Energy, LLC.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER(S) AND ANY CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER(S), ANY CONTRIBUTORS, THE UNITED STATES GOVERNMENT, OR THE UNITED
+*  STATES DEPARTMENT OF ENERGY, NOR ANY OF THEIR EMPLOYEES, BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+*  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*  USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+*  STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+*  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************************************************************************/
+
+#include "LibraryListModel.hpp"
+
+namespace openstudio {
+
+LibraryListModel::LibraryListModel(const ModelDesignWizardLibraryIndex& index, NameFunction name, std::vector<int> ids, QObject* parent)
+  : QAbstractListModel(parent), m_index(index), m_name(name), m_ids(std::move(ids)) {
+  m_rows.reserve(static_cast<qsizetype>(m_ids.size()));
+  for (int row = 0; row < static_cast<int>(m_ids.size()); ++row) {
+    m_rows.insert(m_ids[static_cast<size_t>(row)], row + 1);
+  }
+}
+
+int LibraryListModel::rowCount(const QModelIndex& parent) const {
+  return parent.isValid() ? 0 : static_cast<int>(m_ids.size()) + 1;
+}
+
+QVariant LibraryListModel::data(const QModelIndex& index, int role) const {
+  if (!index.isValid() || index.row() <= 0 || index.row() > static_cast<int>(m_ids.size())) {
+    // The empty item: no name, and no id so that it reads as -1
+    return (role == Qt::DisplayRole || role == Qt::EditRole) && index.row() == 0 ? QVariant(QString()) : QVariant();
+  }
+  const int id = m_ids[static_cast<size_t>(index.row() - 1)];
+  switch (role) {
+    case Qt::DisplayRole:
+    case Qt::EditRole:
+      return (m_index.*m_name)(id);
+    case Qt::UserRole:
+      return id;
+    default:
+      return {};
+  }
+}
+
+int LibraryListModel::row(int id) const {
+  return m_rows.value(id, -1);
+}
+
+}  // namespace openstudio
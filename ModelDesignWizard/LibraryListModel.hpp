@@ -0,0 +1,74 @@
+/***********************************************************************************************************************
+*  OpenStudio(R), Copyright (c) 2020-2023, OpenStudio Coalition and other contributors. All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+*  following conditions are met:
+*
+*  (1) Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+*  disclaimer.
+*
+*  (2) Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+*  disclaimer in the documentation and/or other materials provided with the distribution.
+*
+*  (3) Neither the name of the copyright holder nor the names of any contributors may be used to endorse or promote products
+*  derived from this software without specific prior written permission from the respective party.
+*
+*  (4) Other than as required in clauses (1) and (2), distributions in any form of modifications or other derivative works
+*  may not use the "OpenStudio" trademark, "OS", "os", or any other confusingly similar designation without specific prior
+*  written permission from Alliance for Sustainable Energy, LLC.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER(S) AND ANY CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER(S), ANY CONTRIBUTORS, THE UNITED STATES GOVERNMENT, OR THE UNITED
+*  STATES DEPARTMENT OF ENERGY, NOR ANY OF THEIR EMPLOYEES, BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+*  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*  USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+*  STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+*  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************************************************************************/
+
+#ifndef OPENSTUDIO_LIBRARYLISTMODEL_HPP
+#define OPENSTUDIO_LIBRARYLISTMODEL_HPP
+
+#include "ModelDesignWizardLibraryIndex.hpp"
+
+#include <QAbstractListModel>
+#include <QHash>
+
+#include <vector>
+
+namespace openstudio {
+
+// A read-only list of library index ids for combo boxes, shared by all the combo boxes showing the same list: adding a
+// combo box costs a setModel, not a copy of the list. Row 0 is the empty item, with no id. The names are read from the
+// index when displayed, the index has to outlive the model.
+class LibraryListModel : public QAbstractListModel
+{
+  Q_OBJECT
+
+ public:
+  // Eg &ModelDesignWizardLibraryIndex::buildingTypeName
+  using NameFunction = const QString& (ModelDesignWizardLibraryIndex::*)(int) const;
+
+  LibraryListModel(const ModelDesignWizardLibraryIndex& index, NameFunction name, std::vector<int> ids, QObject* parent = nullptr);
+
+  virtual ~LibraryListModel() = default;
+
+  int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+
+  // The name for Qt::DisplayRole, the id for Qt::UserRole (QComboBox's itemData)
+  QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+  // Of id, -1 if it isn't in the list
+  int row(int id) const;
+
+ private:
+  const ModelDesignWizardLibraryIndex& m_index;
+  NameFunction m_name;
+  std::vector<int> m_ids;
+  QHash<int, int> m_rows;
+};
+
+}  // namespace openstudio
+
+#endif  // OPENSTUDIO_LIBRARYLISTMODEL_HPP
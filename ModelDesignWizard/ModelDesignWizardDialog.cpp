@@ -28,6 +28,8 @@
 ***********************************************************************************************************************/
 
 #include "ModelDesignWizardDialog.hpp"
+#include "ModelDesignWizardLibrary.hpp"
+#include "LibraryListModel.hpp"
 #include "Buttons.hpp"
 #include "OSQuantityEdit.hpp"
 #include "Assert.hpp"
@@ -39,7 +41,6 @@
 #include <QComboBox>
 #include <QGridLayout>
 #include <QCloseEvent>
-#include <QFile>
 #include <QLabel>
 #include <QMessageBox>
 #include <QPainter>
@@ -52,15 +53,14 @@
 #include <QTimer>
 #include <QStandardPaths>
 #include <QDialog>
-#include <QJsonObject>
-#include <QJsonDocument>
-#include <QJsonArray>
-#include <QJsonValue>
 #include <QDebug>
 #include <QLineEdit>
 #include <QDoubleValidator>
 #include <QLocale>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrentRun>
 
+#include <algorithm>
 #include <array>
 #include <fstream>
 #include <vector>
@@ -124,6 +124,33 @@ void LOG(LogLevel level, const std::string& message) {
   }
 }
 
+// The combo boxes get the library index id of each item as its data: that's what gets looked up, never the text.
+// -1 for the empty item
+int currentId(const QComboBox* comboBox) {
+  bool ok = false;
+  const int id = comboBox->currentData().toInt(&ok);
+  return ok ? id : -1;
+}
+
+// Compares ids, not names. The empty item for -1, or an id that isn't there
+void setCurrentId(QComboBox* comboBox, int id) {
+  const auto* model = qobject_cast<const LibraryListModel*>(comboBox->model());
+  comboBox->setCurrentIndex(std::max(0, model ? model->row(id) : comboBox->findData(id)));
+}
+
+// Runs on a worker thread. An empty index if the library can't be loaded
+ModelDesignWizardLibraryIndex loadLibraryIndex() {
+  ModelDesignWizardLibraryIndex index;
+  ModelDesignWizardLibrary library;
+  QString libraryError;
+  if (library.load(ModelDesignWizardLibrary::ResourcePath, &libraryError)) {
+    index.build(library);
+  } else {
+    LOG(LogLevel::Error, "Failed to load the embedded ModelDesignWizard library: " + libraryError.toStdString());
+  }
+  return index;
+}
+
 ModelDesignWizardDialog::ModelDesignWizardDialog(QWidget* parent)
   : OSDialog(false, parent),
     m_mainPaneStackedWidget(nullptr),
@@ -131,21 +158,20 @@ ModelDesignWizardDialog::ModelDesignWizardDialog(QWidget* parent)
     m_argumentsFailedTextEdit(nullptr),
     m_timer(nullptr),
     m_showAdvancedOutput(nullptr),
-    m_advancedOutputDialog(nullptr) {
+    m_advancedOutputDialog(nullptr),
+    m_libraryIndexWatcher(nullptr) {
+  m_startupTimer.start();
+
   setWindowTitle("Apply Measure Now");
   setWindowModality(Qt::ApplicationModal);
   setSizePolicy(QSizePolicy::Minimum, QSizePolicy::Minimum);
   setSizeGripEnabled(true);
 
-  // Load support JSON (has to be before createWidgets
-  QFile file(":/library/ModelDesignWizard.json");
-  if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-    auto supportJson = QJsonDocument::fromJson(QString(file.readAll()).toUtf8());
-    m_supportJsonObject = supportJson.object();
-    file.close();
-  } else {
-    LOG(LogLevel::Error, "Failed to open embedded ModelDesignWizard.json");
-  }
+  // Load the library and index it on a worker thread, while the widgets get created. The template selection page shows
+  // with its combo boxes disabled until it's done, see onLibraryIndexReady
+  m_libraryIndexWatcher = new QFutureWatcher<ModelDesignWizardLibraryIndex>(this);
+  connect(m_libraryIndexWatcher, &QFutureWatcher<ModelDesignWizardLibraryIndex>::finished, this, &ModelDesignWizardDialog::onLibraryIndexReady);
+  m_libraryIndexWatcher->setFuture(QtConcurrent::run(&loadLibraryIndex));
 
   // Set the Locale to C, so that "1234.56" is accepted, but not "1234,56", no matter the user's system locale
   const QLocale lo(QLocale::C);
@@ -199,13 +225,6 @@ QWidget* ModelDesignWizardDialog::createTemplateSelectionPage() {
     int col = 0;
     {
       m_standardTypeComboBox = new QComboBox();
-      qDebug() << "m_supportJsonObject.keys()=" << m_supportJsonObject.keys();
-      for (const QString& standardType : m_supportJsonObject.keys()) {
-        qDebug() << "Adding standardType=" << standardType;
-
-        m_standardTypeComboBox->addItem(standardType);
-      }
-      m_standardTypeComboBox->setCurrentIndex(0);
       mainGridLayout->addWidget(m_standardTypeComboBox, row, col++, 1, 1);
       const bool isConnected = connect(m_standardTypeComboBox, &QComboBox::currentTextChanged, this, &ModelDesignWizardDialog::onStandardTypeChanged);
     }
@@ -231,7 +250,12 @@ QWidget* ModelDesignWizardDialog::createTemplateSelectionPage() {
   m_useIPCheckBox->setChecked(m_isIP);
   connect(m_useIPCheckBox, &QCheckBox::stateChanged, this, [this](int state) { m_isIP = state == Qt::Checked; });
 
-  m_standardTypeComboBox->setCurrentText("DOE");
+  // Until the library is there
+  for (auto* comboBox : {m_standardTypeComboBox, m_targetStandardComboBox, m_primaryBuildingTypeComboBox}) {
+    comboBox->setPlaceholderText("Loading...");
+    comboBox->setEnabled(false);
+  }
+
   mainGridLayout->setRowStretch(mainGridLayout->rowCount(), 100);
 
   return widget;
@@ -242,7 +266,67 @@ void ModelDesignWizardDialog::onStandardTypeChanged(const QString& /*text*/) {
   populatePrimaryBuildingTypes();
 }
 
-void ModelDesignWizardDialog::populateStandardTypes() {}
+void ModelDesignWizardDialog::populateStandardTypes() {
+  m_standardTypeComboBox->blockSignals(true);
+
+  m_standardTypeComboBox->clear();
+
+  qDebug() << "m_libraryIndex.standardTypeCount()=" << m_libraryIndex.standardTypeCount();
+  for (int standardType = 0; standardType < m_libraryIndex.standardTypeCount(); ++standardType) {
+    qDebug() << "Adding standardType=" << m_libraryIndex.standardTypeName(standardType);
+
+    m_standardTypeComboBox->addItem(m_libraryIndex.standardTypeName(standardType), standardType);
+  }
+
+  m_standardTypeComboBox->setCurrentText("DOE");
+
+  m_standardTypeComboBox->blockSignals(false);
+}
+
+void ModelDesignWizardDialog::onLibraryIndexReady() {
+  m_libraryIndex = m_libraryIndexWatcher->future().takeResult();
+  m_libraryReadyMs = m_startupTimer.elapsed();
+
+  populateStandardTypes();
+  onStandardTypeChanged(m_standardTypeComboBox->currentText());
+  for (auto* comboBox : {m_standardTypeComboBox, m_targetStandardComboBox, m_primaryBuildingTypeComboBox}) {
+    comboBox->setEnabled(true);
+  }
+
+  // For quicker testing, TODO: REMOVE
+  m_targetStandardComboBox->setCurrentText("90.1-2019");
+  m_primaryBuildingTypeComboBox->setCurrentText("SecondarySchool");
+  // END TODO: REMOVE
+
+  reportStartupTimes();
+}
+
+void ModelDesignWizardDialog::paintEvent(QPaintEvent* event) {
+  OSDialog::paintEvent(event);
+  if (m_firstPaintMs < 0) {
+    m_firstPaintMs = m_startupTimer.elapsed();
+    reportStartupTimes();
+  }
+}
+
+void ModelDesignWizardDialog::reportStartupTimes() {
+  // Interactive once there's something on screen and the combo boxes are filled, whichever comes last
+  if (m_firstPaintMs < 0 || m_libraryReadyMs < 0 || m_interactiveMs >= 0) {
+    return;
+  }
+  m_interactiveMs = std::max(m_firstPaintMs, m_libraryReadyMs);
+  qInfo() << "ModelDesignWizardDialog: first paint after" << m_firstPaintMs << "ms, library ready after" << m_libraryReadyMs
+          << "ms, interactive after" << m_interactiveMs << "ms";
+  emit interactive();
+}
+
+qint64 ModelDesignWizardDialog::firstPaintMs() const {
+  return m_firstPaintMs;
+}
+
+qint64 ModelDesignWizardDialog::interactiveMs() const {
+  return m_interactiveMs;
+}
 
 void ModelDesignWizardDialog::onTargetStandardChanged(const QString& /*text*/) {
   disableOkButton(m_targetStandardComboBox->currentText().isEmpty() || m_primaryBuildingTypeComboBox->currentText().isEmpty());
@@ -255,10 +339,10 @@ void ModelDesignWizardDialog::populateTargetStandards() {
 
   m_targetStandardComboBox->addItem("");
 
-  const QString selectedStandardType = m_standardTypeComboBox->currentText();
+  const int selectedStandardType = currentId(m_standardTypeComboBox);
 
-  for (const auto& temp : m_supportJsonObject[selectedStandardType].toObject()["templates"].toArray()) {
-    m_targetStandardComboBox->addItem(temp.toString());
+  for (const int templateId : m_libraryIndex.templates(selectedStandardType)) {
+    m_targetStandardComboBox->addItem(m_libraryIndex.templateName(templateId), templateId);
   }
 
   m_targetStandardComboBox->setCurrentIndex(0);
@@ -278,49 +362,46 @@ void ModelDesignWizardDialog::onPrimaryBuildingTypeChanged(const QString& /*text
 void ModelDesignWizardDialog::populateBuildingTypeComboBox(QComboBox* comboBox) {
   comboBox->blockSignals(true);
 
-  comboBox->clear();
+  comboBox->setModel(buildingTypeModel(currentId(m_standardTypeComboBox)));
 
-  comboBox->addItem("");
+  comboBox->setCurrentIndex(0);
 
-  const QString selectedStandardType = m_standardTypeComboBox->currentText();
+  comboBox->blockSignals(false);
+}
 
-  for (const auto& temp : m_supportJsonObject[selectedStandardType].toObject()["building_types"].toArray()) {
-    comboBox->addItem(temp.toString());
+LibraryListModel* ModelDesignWizardDialog::buildingTypeModel(int standardType) {
+  LibraryListModel*& model = m_buildingTypeModels[standardType];
+  if (!model) {
+    model = new LibraryListModel(m_libraryIndex, &ModelDesignWizardLibraryIndex::buildingTypeName, m_libraryIndex.buildingTypes(standardType), this);
   }
+  return model;
+}
 
-  comboBox->setCurrentIndex(0);
-
-  comboBox->blockSignals(false);
+LibraryListModel* ModelDesignWizardDialog::spaceTypeModel(int templateId, int buildingType) {
+  LibraryListModel*& model = m_spaceTypeModels[{templateId, buildingType}];
+  if (!model) {
+    std::vector<int> spaceTypes;
+    // Nothing for -1
+    for (const auto& spaceTypeRatio : m_libraryIndex.spaceTypeRatios(templateId, buildingType)) {
+      spaceTypes.push_back(spaceTypeRatio.spaceType);
+    }
+    model = new LibraryListModel(m_libraryIndex, &ModelDesignWizardLibraryIndex::spaceTypeName, std::move(spaceTypes), this);
+  }
+  return model;
 }
 
 void ModelDesignWizardDialog::populatePrimaryBuildingTypes() {
   populateBuildingTypeComboBox(m_primaryBuildingTypeComboBox);
 }
 
-void ModelDesignWizardDialog::populateSpaceTypeComboBox(QComboBox* comboBox, QString buildingType) {
+void ModelDesignWizardDialog::populateSpaceTypeComboBox(QComboBox* comboBox, int buildingType) {
 
   comboBox->blockSignals(true);
 
-  comboBox->clear();
-
-  comboBox->addItem("");
-
-  if (buildingType.isEmpty()) {
-    buildingType = m_primaryBuildingTypeComboBox->currentText();
-  }
-  if (!buildingType.isEmpty()) {
-    const QString selectedStandardType = m_standardTypeComboBox->currentText();
-    const QString selectedStandard = m_targetStandardComboBox->currentText();
-
-    for (const QString& temp : m_supportJsonObject[selectedStandardType]
-                                 .toObject()["space_types"]
-                                 .toObject()[selectedStandard]
-                                 .toObject()[buildingType]
-                                 .toObject()
-                                 .keys()) {
-      comboBox->addItem(temp);
-    }
+  if (buildingType < 0) {
+    buildingType = currentId(m_primaryBuildingTypeComboBox);
   }
+  comboBox->setModel(spaceTypeModel(currentId(m_targetStandardComboBox), buildingType));
 
   comboBox->setCurrentIndex(0);
 
@@ -339,7 +420,7 @@ bool ModelDesignWizardDialog::isIP() const {
   return m_isIP;
 }
 
-void ModelDesignWizardDialog::addSpaceTypeRatioRow(const QString& buildingType, const QString& spaceType, double ratio) {
+void ModelDesignWizardDialog::addSpaceTypeRatioRow(int buildingType, int spaceType, double ratio) {
 
   qDebug() << "inside: " << m_spaceTypeRatiosMainLayout;
   qDebug() << "inside: " << m_spaceTypeRatiosMainLayout->rowCount();
@@ -409,7 +490,7 @@ void ModelDesignWizardDialog::removeSpaceTypeRatioRow(SpaceTypeRatioRow* row) {
   recalculateTotalBuildingRatio(true);
 }
 
-SpaceTypeRatioRow::SpaceTypeRatioRow(ModelDesignWizardDialog* parent, const QString& buildingType, const QString& spaceType, double ratio)
+SpaceTypeRatioRow::SpaceTypeRatioRow(ModelDesignWizardDialog* parent, int buildingType, int spaceType, double ratio)
   : buildingTypeComboBox(new QComboBox()),
     spaceTypeComboBox(new QComboBox()),
     spaceTypeRatioEdit(new openstudio::OSNonModelObjectQuantityEdit("", "", "", false)),
@@ -424,14 +505,16 @@ SpaceTypeRatioRow::SpaceTypeRatioRow(ModelDesignWizardDialog* parent, const QStr
 
   parent->spaceTypeRatiosMainLayout()->addWidget(buildingTypeComboBox, gridLayoutRowIndex, col++, 1, 1);
   parent->populateBuildingTypeComboBox(buildingTypeComboBox);
-  buildingTypeComboBox->setCurrentText(buildingType);
+  setCurrentId(buildingTypeComboBox, buildingType);
 
   parent->spaceTypeRatiosMainLayout()->addWidget(spaceTypeComboBox, gridLayoutRowIndex, col++, 1, 1);
-  parent->populateSpaceTypeComboBox(spaceTypeComboBox, buildingType);
-  spaceTypeComboBox->setCurrentText(spaceType);
+  parent->populateSpaceTypeComboBox(spaceTypeComboBox, currentId(buildingTypeComboBox));
+  setCurrentId(spaceTypeComboBox, spaceType);
   const bool isConnected =
     QComboBox::connect(buildingTypeComboBox, &QComboBox::currentTextChanged, spaceTypeComboBox,
-                       [this, parent](const QString& buildingType) { parent->populateSpaceTypeComboBox(spaceTypeComboBox, buildingType); });
+                       [this, parent](const QString& /*buildingType*/) {
+                         parent->populateSpaceTypeComboBox(spaceTypeComboBox, currentId(buildingTypeComboBox));
+                       });
 
   spaceTypeRatioEdit->setMinimumValue(0.0);
   spaceTypeRatioEdit->setMaximumValue(1.0);
@@ -586,35 +669,29 @@ void ModelDesignWizardDialog::populateSpaceTypeRatiosPage() {
     }
   }
 
-  const QString selectedStandardType = m_standardTypeComboBox->currentText();
-  const QString selectedStandard = m_targetStandardComboBox->currentText();
-  const QString selectedPrimaryBuildingType = m_primaryBuildingTypeComboBox->currentText();
+  const int selectedStandard = currentId(m_targetStandardComboBox);
+  const int primaryBuildingType = currentId(m_primaryBuildingTypeComboBox);
 
-  const QJsonObject defaultSpaceTypeRatios = m_supportJsonObject[selectedStandardType]
-                                               .toObject()["space_types"]
-                                               .toObject()[selectedStandard]
-                                               .toObject()[selectedPrimaryBuildingType]
-                                               .toObject();
-  for (QJsonObject::const_iterator it = defaultSpaceTypeRatios.constBegin(); it != defaultSpaceTypeRatios.constEnd(); ++it) {
+  for (const auto& defaultSpaceTypeRatio : m_libraryIndex.spaceTypeRatios(selectedStandard, primaryBuildingType)) {
     ++row;
     {
 #if 1
-      const QString spaceType = it.key();
-      const double ratio = it.value().toObject()["ratio"].toDouble();
+      const int spaceType = defaultSpaceTypeRatio.spaceType;
+      const double ratio = defaultSpaceTypeRatio.ratio;
       qDebug() << "before: " << m_spaceTypeRatiosMainLayout;
       qDebug() << "before: " << m_spaceTypeRatiosMainLayout->rowCount();
-      addSpaceTypeRatioRow(selectedPrimaryBuildingType, spaceType, ratio);
+      addSpaceTypeRatioRow(primaryBuildingType, spaceType, ratio);
 
 #elif 0
       auto* buildingTypeComboBox = new QComboBox();
       m_spaceTypeRatiosMainLayout->addWidget(buildingTypeComboBox, row, col++, 1, 1);
       populateBuildingTypeComboBox(buildingTypeComboBox);
-      buildingTypeComboBox->setCurrentText(selectedPrimaryBuildingType);
+      setCurrentId(buildingTypeComboBox, primaryBuildingType);
 
       auto* spaceTypeComboBox = new QComboBox();
       m_spaceTypeRatiosMainLayout->addWidget(spaceTypeComboBox, row, col++, 1, 1);
-      populateSpaceTypeComboBox(spaceTypeComboBox, selectedPrimaryBuildingType);
-      spaceTypeComboBox->setCurrentText(it.key());
+      populateSpaceTypeComboBox(spaceTypeComboBox, primaryBuildingType);
+      setCurrentId(spaceTypeComboBox, defaultSpaceTypeRatio.spaceType);
 
       auto* spaceTypeRatioEdit = new openstudio::OSNonModelObjectQuantityEdit("", "", "", false);
       spaceTypeRatioEdit->setMinimumValue(0.0);
@@ -622,7 +699,7 @@ void ModelDesignWizardDialog::populateSpaceTypeRatiosPage() {
       spaceTypeRatioEdit->enableClickFocus();
       connect(m_useIPCheckBox, &QCheckBox::stateChanged, spaceTypeRatioEdit, &OSNonModelObjectQuantityEdit::onUnitSystemChange);
 
-      spaceTypeRatioEdit->setDefault(it.value().toObject()["ratio"].toDouble());
+      spaceTypeRatioEdit->setDefault(defaultSpaceTypeRatio.ratio);
       m_spaceTypeRatiosMainLayout->addWidget(spaceTypeRatioEdit, row, col++, 1, 1);
 
       auto* spaceTypeFloorAreaEdit = new openstudio::OSNonModelObjectQuantityEdit("ft^2", "m^2", "ft^2", m_isIP);
@@ -635,7 +712,9 @@ void ModelDesignWizardDialog::populateSpaceTypeRatiosPage() {
       m_spaceTypeRatiosMainLayout->addWidget(deleteRowButton, row, col++, 1, 1);
 
       const bool isConnected = connect(buildingTypeComboBox, &QComboBox::currentTextChanged,
-                                       [this, &spaceTypeComboBox](const QString& text) { populateSpaceTypeComboBox(spaceTypeComboBox, text); });
+                                       [this, &spaceTypeComboBox, buildingTypeComboBox](const QString& /*text*/) {
+                                         populateSpaceTypeComboBox(spaceTypeComboBox, currentId(buildingTypeComboBox));
+                                       });
 #else
       // Put it in a widget so we can delete and hide
       auto* rowWidget = new QWidget();
@@ -644,12 +723,12 @@ void ModelDesignWizardDialog::populateSpaceTypeRatiosPage() {
       auto* buildingTypeComboBox = new QComboBox();
       hBoxLayout->addWidget(buildingTypeComboBox);
       populateBuildingTypeComboBox(buildingTypeComboBox);
-      buildingTypeComboBox->setCurrentText(selectedPrimaryBuildingType);
+      setCurrentId(buildingTypeComboBox, primaryBuildingType);
 
       auto* spaceTypeComboBox = new QComboBox();
       hBoxLayout->addWidget(spaceTypeComboBox);
-      populateSpaceTypeComboBox(spaceTypeComboBox, selectedPrimaryBuildingType);
-      spaceTypeComboBox->setCurrentText(it.key());
+      populateSpaceTypeComboBox(spaceTypeComboBox, primaryBuildingType);
+      setCurrentId(spaceTypeComboBox, defaultSpaceTypeRatio.spaceType);
 
       auto* spaceTypeRatioEdit = new QLineEdit();
       spaceTypeRatioEdit->setValidator(m_ratioValidator);
@@ -658,13 +737,15 @@ void ModelDesignWizardDialog::populateSpaceTypeRatiosPage() {
       auto* deleteRowButton = new openstudio::RemoveButton();
       hBoxLayout->addWidget(deleteRowButton);
 
-      spaceTypeRatioEdit->setText(QString::number(it.value().toObject()["ratio"].toDouble()));
+      spaceTypeRatioEdit->setText(QString::number(defaultSpaceTypeRatio.ratio));
 
       // Spans 1 row and 4 columns
       m_spaceTypeRatiosMainLayout->addWidget(rowWidget, row, 0, 1, 4);
 
       const bool isConnected = connect(buildingTypeComboBox, &QComboBox::currentTextChanged,
-                                       [this, &spaceTypeComboBox](const QString& text) { populateSpaceTypeComboBox(spaceTypeComboBox, text); });
+                                       [this, &spaceTypeComboBox, buildingTypeComboBox](const QString& /*text*/) {
+                                         populateSpaceTypeComboBox(spaceTypeComboBox, currentId(buildingTypeComboBox));
+                                       });
 #endif
     }
   }
@@ -767,11 +848,6 @@ void ModelDesignWizardDialog::createWidgets() {
 #elif defined(Q_OS_WIN)
   setWindowFlags(Qt::WindowCloseButtonHint | Qt::MSWindowsFixedSizeDialogHint);
 #endif
-
-  // For quicker testing, TODO: REMOVE
-  m_targetStandardComboBox->setCurrentText("90.1-2019");
-  m_primaryBuildingTypeComboBox->setCurrentText("SecondarySchool");
-  // END TODO: REMOVE
 }
 
 void ModelDesignWizardDialog::resizeEvent(QResizeEvent* event) {
@@ -31,17 +31,22 @@
 #define OPENSTUDIO_MODELDESIGNWIZARDDIALOG_HPP
 
 #include "OSDialog.hpp"
+#include "ModelDesignWizardLibraryIndex.hpp"
 
-#include <QJsonObject>
 #include <QDialog>
+#include <QElapsedTimer>
+#include <QHash>
 
 class QCheckBox;
 class QCloseEvent;
 class QComboBox;
 class QDoubleValidator;
+template <typename T>
+class QFutureWatcher;
 class QGridLayout;
 class QLabel;
 class QLineEdit;
+class QPaintEvent;
 class QProcess;
 class QPushButton;
 class QResizeEvent;
@@ -52,6 +57,7 @@ class QWidget;
 
 namespace openstudio {
 
+class LibraryListModel;
 class OSNonModelObjectQuantityEdit;
 class RemoveButton;
 class TextEditDialog;
@@ -67,7 +73,8 @@ class SpaceTypeRatioRow
 {
 
  public:
-  SpaceTypeRatioRow(ModelDesignWizardDialog* parent, const QString& buildingType = "", const QString& spaceType = "", double ratio = 0.0);
+  // buildingType and spaceType: ModelDesignWizardLibraryIndex ids, -1 to leave them empty
+  SpaceTypeRatioRow(ModelDesignWizardDialog* parent, int buildingType = -1, int spaceType = -1, double ratio = 0.0);
 
   QComboBox* buildingTypeComboBox;
   QComboBox* spaceTypeComboBox;
@@ -101,10 +108,15 @@ class ModelDesignWizardDialog : public OSDialog
   QSize sizeHint() const override;
 
   void populateBuildingTypeComboBox(QComboBox* comboBox);
-  void populateSpaceTypeComboBox(QComboBox* comboBox, QString buildingType = "");
+  // buildingType: a ModelDesignWizardLibraryIndex id, -1 for the primary building type
+  void populateSpaceTypeComboBox(QComboBox* comboBox, int buildingType = -1);
 
   double totalBuildingFloorArea() const;
 
+  // Since the dialog was constructed, -1 until it happens. Interactive: painted, with the library loaded in the combo boxes
+  qint64 firstPaintMs() const;
+  qint64 interactiveMs() const;
+
  public slots:
   void recalculateTotalBuildingRatio(bool forceToOne);
   void recalculateSpaceTypeFloorAreas();
@@ -122,6 +134,8 @@ class ModelDesignWizardDialog : public OSDialog
 
   void resizeEvent(QResizeEvent* event) override;  // Put back QDialog::resizeEvent so it can be resized
 
+  void paintEvent(QPaintEvent* event) override;
+
  private slots:
 
   void disableOkButton(bool disable);
@@ -135,6 +149,8 @@ class ModelDesignWizardDialog : public OSDialog
   void onStandardTypeChanged(const QString& text);
   void populateStandardTypes();
 
+  void onLibraryIndexReady();
+
   void onTargetStandardChanged(const QString& text);
   void populateTargetStandards();
 
@@ -151,6 +167,8 @@ class ModelDesignWizardDialog : public OSDialog
 
   void onUnitSystemChange(bool isIP);
 
+  void interactive();
+
  private:
   void createWidgets();
   QWidget* createTemplateSelectionPage();
@@ -160,9 +178,15 @@ class ModelDesignWizardDialog : public OSDialog
 
   void runMeasure();
 
-  void addSpaceTypeRatioRow(const QString& buildingType = "", const QString& spaceType = "", double ratio = 0.0);
+  void addSpaceTypeRatioRow(int buildingType = -1, int spaceType = -1, double ratio = 0.0);
   void removeSpaceTypeRatioRow(SpaceTypeRatioRow* row);
 
+  void reportStartupTimes();
+
+  // Shared by every combo box showing that list, made on first use
+  LibraryListModel* buildingTypeModel(int standardType);
+  LibraryListModel* spaceTypeModel(int templateId, int buildingType);
+
   QStackedWidget* m_mainPaneStackedWidget;
 
   QStackedWidget* m_rightPaneStackedWidget;
@@ -191,7 +215,16 @@ class ModelDesignWizardDialog : public OSDialog
 
   TextEditDialog* m_advancedOutputDialog;
 
-  QJsonObject m_supportJsonObject;
+  ModelDesignWizardLibraryIndex m_libraryIndex;
+  QFutureWatcher<ModelDesignWizardLibraryIndex>* m_libraryIndexWatcher;
+  // By standard type, and by (template, building type): a template is only in one standard type
+  QHash<int, LibraryListModel*> m_buildingTypeModels;
+  QHash<std::pair<int, int>, LibraryListModel*> m_spaceTypeModels;
+
+  QElapsedTimer m_startupTimer;
+  qint64 m_firstPaintMs = -1;
+  qint64 m_libraryReadyMs = -1;
+  qint64 m_interactiveMs = -1;
 
   QComboBox* m_standardTypeComboBox;
   QComboBox* m_targetStandardComboBox;
@@ -0,0 +1,241 @@
+/***********************************************************************************************************************
+*  OpenStudio(R), Copyright (c) 2020-2023, OpenStudio Coalition and other contributors. All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+*  following conditions are met:
+*
+*  (1) Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+*  disclaimer.
+*
+*  (2) Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+*  disclaimer in the documentation and/or other materials provided with the distribution.
+*
+*  (3) Neither the name of the copyright holder nor the names of any contributors may be used to endorse or promote products
+*  derived from this software without specific prior written permission from the respective party.
+*
+*  (4) Other than as required in clauses (1) and (2), distributions in any form of modifications or other derivative works
+*  may not use the "OpenStudio" trademark, "OS", "os", or any other confusingly similar designation without specific prior
+*  written permission from Alliance for Sustainable Energy, LLC.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER(S) AND ANY CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER(S), ANY CONTRIBUTORS, THE UNITED STATES GOVERNMENT, OR THE UNITED
+*  STATES DEPARTMENT OF ENERGY, NOR ANY OF THEIR EMPLOYEES, BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+*  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*  USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+*  STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+*  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************************************************************************/
+
+#include "ModelDesignWizardLibrary.hpp"
+#include "ModelDesignWizardLibraryFormat.hpp"
+
+#include <QObject>
+#include <QResource>
+#include <QtEndian>
+
+#include <bit>
+#include <cstddef>
+
+namespace openstudio {
+
+using namespace mdwlib;
+
+bool ModelDesignWizardLibrary::load(const QString& resourcePath, QString* error) {
+  const QResource resource(resourcePath);
+  QString message;
+  if (!resource.isValid()) {
+    message = QObject::tr("No such resource");
+  } else if (resource.compressionAlgorithm() != QResource::NoCompression) {
+    // It would have to be uncompressed into a copy, which is what this is avoiding
+    message = QObject::tr("The resource is compressed");
+  } else if (loadData(resource.data(), resource.size(), &message)) {
+    // The data of a compiled-in resource stays where it is for as long as the program runs
+    return true;
+  }
+  m_data = nullptr;
+  m_size = 0;
+  if (error) {
+    *error = QString("%1: %2").arg(resourcePath, message);
+  }
+  return false;
+}
+
+bool ModelDesignWizardLibrary::loadData(const uchar* data, qint64 size, QString* error) {
+  auto fail = [this, error](const QString& message) {
+    m_data = nullptr;
+    m_size = 0;
+    if (error) {
+      *error = message;
+    }
+    return false;
+  };
+
+  m_data = data;
+  m_size = static_cast<quint32>(size);
+  if (size < static_cast<qint64>(sizeof(Header)) || u32(offsetof(Header, magic)) != Magic) {
+    return fail(QObject::tr("Not a ModelDesignWizard library"));
+  }
+  if (u32(offsetof(Header, version)) != Version) {
+    return fail(QObject::tr("Version %1 of the library format, expected %2").arg(u32(offsetof(Header, version))).arg(Version));
+  }
+  if (u32(offsetof(Header, size)) != size) {
+    return fail(QObject::tr("Truncated library"));
+  }
+  return true;
+}
+
+bool ModelDesignWizardLibrary::isLoaded() const {
+  return m_data != nullptr;
+}
+
+qsizetype ModelDesignWizardLibrary::size() const {
+  return m_size;
+}
+
+quint32 ModelDesignWizardLibrary::u32(quint32 offset) const {
+  // Unaligned reads, resource data is only byte aligned
+  return qFromLittleEndian<quint32>(m_data + offset);
+}
+
+double ModelDesignWizardLibrary::f64(quint32 offset) const {
+  return std::bit_cast<double>(qFromLittleEndian<quint64>(m_data + offset));
+}
+
+QByteArrayView ModelDesignWizardLibrary::stringView(quint32 id) const {
+  const quint32 record = u32(offsetof(Header, stringsOffset)) + id * sizeof(StringRecord);
+  return {m_data + u32(record + offsetof(StringRecord, offset)), static_cast<qsizetype>(u32(record + offsetof(StringRecord, size)))};
+}
+
+QString ModelDesignWizardLibrary::string(quint32 id) const {
+  return QString::fromUtf8(stringView(id));
+}
+
+QStringList ModelDesignWizardLibrary::strings(quint32 count, quint32 offset) const {
+  QStringList result;
+  result.reserve(count);
+  for (quint32 i = 0; i < count; ++i) {
+    result << string(u32(offset + i * sizeof(quint32)));
+  }
+  return result;
+}
+
+quint32 ModelDesignWizardLibrary::findRecord(quint32 count, quint32 offset, quint32 recordSize, const QString& name) const {
+  // Every record starts with its name. A handful of records per level, a linear scan is all it takes
+  const QByteArray utf8 = name.toUtf8();
+  for (quint32 i = 0; i < count; ++i) {
+    const quint32 record = offset + i * recordSize;
+    if (stringView(u32(record)) == QByteArrayView(utf8)) {
+      return record;
+    }
+  }
+  return 0;
+}
+
+quint32 ModelDesignWizardLibrary::findStandardType(const QString& standardType) const {
+  if (!isLoaded()) {
+    return 0;
+  }
+  return findRecord(u32(offsetof(Header, standardTypeCount)), u32(offsetof(Header, standardTypesOffset)), sizeof(StandardTypeRecord),
+                    standardType);
+}
+
+quint32 ModelDesignWizardLibrary::findSpaceTypeBuilding(const QString& standardType, const QString& templateName,
+                                                        const QString& buildingType) const {
+  const quint32 standardTypeRecord = findStandardType(standardType);
+  if (standardTypeRecord == 0) {
+    return 0;
+  }
+  const quint32 templateRecord = findRecord(u32(standardTypeRecord + offsetof(StandardTypeRecord, spaceTypeTemplateCount)),
+                                            u32(standardTypeRecord + offsetof(StandardTypeRecord, spaceTypeTemplatesOffset)),
+                                            sizeof(SpaceTypeTemplateRecord), templateName);
+  if (templateRecord == 0) {
+    return 0;
+  }
+  return findRecord(u32(templateRecord + offsetof(SpaceTypeTemplateRecord, buildingCount)),
+                    u32(templateRecord + offsetof(SpaceTypeTemplateRecord, buildingsOffset)), sizeof(SpaceTypeBuildingRecord), buildingType);
+}
+
+QStringList ModelDesignWizardLibrary::standardTypes() const {
+  if (!isLoaded()) {
+    return {};
+  }
+  QStringList result;
+  const quint32 count = u32(offsetof(Header, standardTypeCount));
+  const quint32 offset = u32(offsetof(Header, standardTypesOffset));
+  for (quint32 i = 0; i < count; ++i) {
+    result << string(u32(offset + i * sizeof(StandardTypeRecord) + offsetof(StandardTypeRecord, name)));
+  }
+  return result;
+}
+
+QStringList ModelDesignWizardLibrary::templates(const QString& standardType) const {
+  const quint32 record = findStandardType(standardType);
+  if (record == 0) {
+    return {};
+  }
+  return strings(u32(record + offsetof(StandardTypeRecord, templateCount)), u32(record + offsetof(StandardTypeRecord, templatesOffset)));
+}
+
+QStringList ModelDesignWizardLibrary::buildingTypes(const QString& standardType) const {
+  const quint32 record = findStandardType(standardType);
+  if (record == 0) {
+    return {};
+  }
+  return strings(u32(record + offsetof(StandardTypeRecord, buildingTypeCount)), u32(record + offsetof(StandardTypeRecord, buildingTypesOffset)));
+}
+
+QStringList ModelDesignWizardLibrary::climateZones(const QString& standardType) const {
+  const quint32 record = findStandardType(standardType);
+  if (record == 0) {
+    return {};
+  }
+  return strings(u32(record + offsetof(StandardTypeRecord, climateZoneCount)), u32(record + offsetof(StandardTypeRecord, climateZonesOffset)));
+}
+
+QStringList ModelDesignWizardLibrary::spaceTypeNames(const QString& standardType, const QString& templateName,
+                                                     const QString& buildingType) const {
+  const quint32 record = findSpaceTypeBuilding(standardType, templateName, buildingType);
+  if (record == 0) {
+    return {};
+  }
+  QStringList result;
+  const quint32 count = u32(record + offsetof(SpaceTypeBuildingRecord, spaceTypeCount));
+  const quint32 offset = u32(record + offsetof(SpaceTypeBuildingRecord, spaceTypesOffset));
+  result.reserve(count);
+  for (quint32 i = 0; i < count; ++i) {
+    result << string(u32(offset + i * sizeof(SpaceTypeRecord) + offsetof(SpaceTypeRecord, name)));
+  }
+  return result;
+}
+
+std::vector<ModelDesignWizardLibrary::SpaceType> ModelDesignWizardLibrary::spaceTypes(const QString& standardType, const QString& templateName,
+                                                                                      const QString& buildingType) const {
+  const quint32 record = findSpaceTypeBuilding(standardType, templateName, buildingType);
+  if (record == 0) {
+    return {};
+  }
+  std::vector<SpaceType> result;
+  const quint32 count = u32(record + offsetof(SpaceTypeBuildingRecord, spaceTypeCount));
+  const quint32 offset = u32(record + offsetof(SpaceTypeBuildingRecord, spaceTypesOffset));
+  result.reserve(count);
+  for (quint32 i = 0; i < count; ++i) {
+    const quint32 spaceTypeRecord = offset + i * sizeof(SpaceTypeRecord);
+    const quint32 flags = u32(spaceTypeRecord + offsetof(SpaceTypeRecord, flags));
+    SpaceType& spaceType = result.emplace_back();
+    spaceType.name = string(u32(spaceTypeRecord + offsetof(SpaceTypeRecord, name)));
+    spaceType.ratio = f64(spaceTypeRecord + offsetof(SpaceTypeRecord, ratio));
+    spaceType.spaceTypeGen = (flags & SpaceTypeGen) != 0;
+    spaceType.isDefault = (flags & Default) != 0;
+    spaceType.circulation = (flags & Circulation) != 0;
+    if ((flags & HasStoryHeight) != 0) {
+      spaceType.storyHeight = f64(spaceTypeRecord + offsetof(SpaceTypeRecord, storyHeight));
+    }
+    if ((flags & HasWwr) != 0) {
+      spaceType.wwr = f64(spaceTypeRecord + offsetof(SpaceTypeRecord, wwr));
+    }
+  }
+  return result;
+}
+
+}  // namespace openstudio
@@ -0,0 +1,105 @@
+/***********************************************************************************************************************
+*  OpenStudio(R), Copyright (c) 2020-2023, OpenStudio Coalition and other contributors. All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+*  following conditions are met:
+*
+*  (1) Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+*  disclaimer.
+*
+*  (2) Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+*  disclaimer in the documentation and/or other materials provided with the distribution.
+*
+*  (3) Neither the name of the copyright holder nor the names of any contributors may be used to endorse or promote products
+*  derived from this software without specific prior written permission from the respective party.
+*
+*  (4) Other than as required in clauses (1) and (2), distributions in any form of modifications or other derivative works
+*  may not use the "OpenStudio" trademark, "OS", "os", or any other confusingly similar designation without specific prior
+*  written permission from Alliance for Sustainable Energy, LLC.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER(S) AND ANY CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER(S), ANY CONTRIBUTORS, THE UNITED STATES GOVERNMENT, OR THE UNITED
+*  STATES DEPARTMENT OF ENERGY, NOR ANY OF THEIR EMPLOYEES, BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+*  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*  USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+*  STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+*  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************************************************************************/
+
+#ifndef OPENSTUDIO_MODELDESIGNWIZARDLIBRARY_HPP
+#define OPENSTUDIO_MODELDESIGNWIZARDLIBRARY_HPP
+
+#include <QByteArrayView>
+#include <QString>
+#include <QStringList>
+
+#include <optional>
+#include <vector>
+
+namespace openstudio {
+
+// The standards library the wizard picks from (standard types, templates, building types and their space type ratios),
+// read in place from the compiled resource: load() only checks the header, every query reads straight from the
+// resource data. See ModelDesignWizardLibraryFormat.hpp for the layout.
+class ModelDesignWizardLibrary
+{
+ public:
+  struct SpaceType
+  {
+    QString name;
+    double ratio = 0.0;
+    bool spaceTypeGen = false;
+    bool isDefault = false;
+    bool circulation = false;
+    std::optional<double> storyHeight;
+    std::optional<double> wwr;
+  };
+
+  // Where CMake puts the compiled library, see library.qrc.in
+  static constexpr const char* ResourcePath = ":/library/ModelDesignWizard.mdwlib";
+
+  // False if the resource is missing, compressed, or not a library this build can read, with the reason in error
+  bool load(const QString& resourcePath = ResourcePath, QString* error = nullptr);
+
+  // Same, from a compiled library in memory: data is read in place, it has to stay there as long as the library is used
+  bool loadData(const uchar* data, qint64 size, QString* error = nullptr);
+
+  bool isLoaded() const;
+
+  // In bytes, of the resource
+  qsizetype size() const;
+
+  QStringList standardTypes() const;
+
+  QStringList templates(const QString& standardType) const;
+
+  QStringList buildingTypes(const QString& standardType) const;
+
+  QStringList climateZones(const QString& standardType) const;
+
+  // Empty if there's nothing for that combination
+  QStringList spaceTypeNames(const QString& standardType, const QString& templateName, const QString& buildingType) const;
+
+  std::vector<SpaceType> spaceTypes(const QString& standardType, const QString& templateName, const QString& buildingType) const;
+
+ private:
+  quint32 u32(quint32 offset) const;
+  double f64(quint32 offset) const;
+
+  QByteArrayView stringView(quint32 id) const;
+  QString string(quint32 id) const;
+  QStringList strings(quint32 count, quint32 offset) const;
+
+  // Offset of the record named name among the count records of recordSize at offset, 0 if there's none
+  quint32 findRecord(quint32 count, quint32 offset, quint32 recordSize, const QString& name) const;
+  quint32 findStandardType(const QString& standardType) const;
+  quint32 findSpaceTypeBuilding(const QString& standardType, const QString& templateName, const QString& buildingType) const;
+
+  const uchar* m_data = nullptr;
+  quint32 m_size = 0;
+};
+
+}  // namespace openstudio
+
+#endif  // OPENSTUDIO_MODELDESIGNWIZARDLIBRARY_HPP
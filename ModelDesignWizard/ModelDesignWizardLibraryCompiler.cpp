@@ -0,0 +1,86 @@
+/***********************************************************************************************************************
+*  OpenStudio(R), Copyright (c) 2020-2023, OpenStudio Coalition and other contributors. All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+*  following conditions are met:
+*
+*  (1) Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+*  disclaimer.
+*
+*  (2) Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+*  disclaimer in the documentation and/or other materials provided with the distribution.
+*
+*  (3) Neither the name of the copyright holder nor the names of any contributors may be used to endorse or promote products
+*  derived from this software without specific prior written permission from the respective party.
+*
+*  (4) Other than as required in clauses (1) and (2), distributions in any form of modifications or other derivative works
+*  may not use the "OpenStudio" trademark, "OS", "os", or any other confusingly similar designation without specific prior
+*  written permission from Alliance for Sustainable Energy, LLC.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER(S) AND ANY CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER(S), ANY CONTRIBUTORS, THE UNITED STATES GOVERNMENT, OR THE UNITED
+*  STATES DEPARTMENT OF ENERGY, NOR ANY OF THEIR EMPLOYEES, BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+*  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*  USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+*  STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+*  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************************************************************************/
+
+// Build step: compiles ModelDesignWizard.json into the binary library described in ModelDesignWizardLibraryFormat.hpp,
+// so the dialog doesn't have to parse 600 KB of JSON every time it opens.
+//
+// Usage: ModelDesignWizardLibraryCompiler ModelDesignWizard.json ModelDesignWizard.mdwlib
+
+#include "ModelDesignWizardLibraryWriter.hpp"
+
+#include <QByteArray>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QString>
+
+#include <cstdio>
+#include <limits>
+
+int main(int argc, char* argv[]) {
+  if (argc != 3) {
+    std::fprintf(stderr, "Usage: %s ModelDesignWizard.json ModelDesignWizard.mdwlib\n", argv[0]);
+    return 2;
+  }
+  const QString inputPath = QString::fromLocal8Bit(argv[1]);
+  const QString outputPath = QString::fromLocal8Bit(argv[2]);
+
+  QFile input(inputPath);
+  if (!input.open(QIODevice::ReadOnly)) {
+    std::fprintf(stderr, "Cannot open %s\n", qPrintable(inputPath));
+    return 1;
+  }
+  QJsonParseError parseError;
+  const QJsonDocument document = QJsonDocument::fromJson(input.readAll(), &parseError);
+  if (parseError.error != QJsonParseError::NoError) {
+    std::fprintf(stderr, "%s, offset %d: %s\n", qPrintable(inputPath), static_cast<int>(parseError.offset), qPrintable(parseError.errorString()));
+    return 1;
+  }
+  if (!document.isObject()) {
+    std::fprintf(stderr, "%s: expected an object of standard types\n", qPrintable(inputPath));
+    return 1;
+  }
+
+  const QByteArray blob = openstudio::compileLibrary(document.object());
+  if (blob.size() > std::numeric_limits<quint32>::max()) {
+    std::fprintf(stderr, "%s is too large for 32-bit offsets\n", qPrintable(inputPath));
+    return 1;
+  }
+
+  QDir().mkpath(QFileInfo(outputPath).absolutePath());
+  QSaveFile output(outputPath);
+  if (!output.open(QIODevice::WriteOnly) || output.write(blob) != blob.size() || !output.commit()) {
+    std::fprintf(stderr, "Cannot write %s\n", qPrintable(outputPath));
+    return 1;
+  }
+  return 0;
+}
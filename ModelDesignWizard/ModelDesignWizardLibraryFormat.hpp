@@ -0,0 +1,131 @@
+/***********************************************************************************************************************
+*  OpenStudio(R), Copyright (c) 2020-2023, OpenStudio Coalition and other contributors. All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+*  following conditions are met:
+*
+*  (1) Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+*  disclaimer.
+*
+*  (2) Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+*  disclaimer in the documentation and/or other materials provided with the distribution.
+*
+*  (3) Neither the name of the copyright holder nor the names of any contributors may be used to endorse or promote products
+*  derived from this software without specific prior written permission from the respective party.
+*
+*  (4) Other than as required in clauses (1) and (2), distributions in any form of modifications or other derivative works
+*  may not use the "OpenStudio" trademark, "OS", "os", or any other confusingly similar designation without specific prior
+*  written permission from Alliance for Sustainable Energy, LLC.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER(S) AND ANY CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER(S), ANY CONTRIBUTORS, THE UNITED STATES GOVERNMENT, OR THE UNITED
+*  STATES DEPARTMENT OF ENERGY, NOR ANY OF THEIR EMPLOYEES, BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+*  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*  USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+*  STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+*  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************************************************************************/
+
+#ifndef OPENSTUDIO_MODELDESIGNWIZARDLIBRARYFORMAT_HPP
+#define OPENSTUDIO_MODELDESIGNWIZARDLIBRARYFORMAT_HPP
+
+#include <QtGlobal>
+
+// Layout of the compiled library (ModelDesignWizard.mdwlib), written at build time from ModelDesignWizard.json by
+// ModelDesignWizardLibraryCompiler and read in place from the resource by ModelDesignWizardLibrary.
+//
+// Everything is little endian. Records are made of quint32 (and double for the numbers), offsets are in bytes from the
+// start of the blob, strings are ids into the string table. The resource data has no alignment guarantee, so the reader
+// never dereferences these structs in place, it reads each field at its offsetof.
+//
+//   Header
+//   StandardTypeRecord[standardTypeCount]                       "DEER", "DOE"
+//     quint32[templateCount], quint32[buildingTypeCount], ...   string ids, in the JSON's order
+//     SpaceTypeTemplateRecord[spaceTypeTemplateCount]            space_types/<template>
+//       SpaceTypeBuildingRecord[buildingCount]                   space_types/<template>/<building type>
+//         SpaceTypeRecord[spaceTypeCount]                        space_types/<template>/<building type>/<space type>
+//   StringRecord[stringCount], then the UTF-8 bytes
+//
+// Objects are written in key order, like QJsonObject iterates them.
+
+namespace openstudio {
+namespace mdwlib {
+
+inline constexpr quint32 Magic = 0x4c57444d;  // "MDWL"
+// Bump along with any change below
+inline constexpr quint32 Version = 1;
+
+struct Header
+{
+  quint32 magic;
+  quint32 version;
+  quint32 size;
+  quint32 stringCount;
+  quint32 stringsOffset;
+  quint32 standardTypeCount;
+  quint32 standardTypesOffset;
+  quint32 reserved;
+};
+
+struct StringRecord
+{
+  quint32 offset;
+  quint32 size;
+};
+
+struct StandardTypeRecord
+{
+  quint32 name;
+  quint32 templateCount;
+  quint32 templatesOffset;
+  quint32 buildingTypeCount;
+  quint32 buildingTypesOffset;
+  quint32 climateZoneCount;
+  quint32 climateZonesOffset;
+  quint32 spaceTypeTemplateCount;
+  quint32 spaceTypeTemplatesOffset;
+};
+
+struct SpaceTypeTemplateRecord
+{
+  quint32 name;
+  quint32 buildingCount;
+  quint32 buildingsOffset;
+};
+
+struct SpaceTypeBuildingRecord
+{
+  quint32 name;
+  // 0 for the building types that are 'false' in the JSON
+  quint32 spaceTypeCount;
+  quint32 spaceTypesOffset;
+};
+
+enum SpaceTypeFlag : quint32
+{
+  SpaceTypeGen = 1 << 0,
+  Default = 1 << 1,
+  Circulation = 1 << 2,
+  HasStoryHeight = 1 << 3,
+  HasWwr = 1 << 4,
+};
+
+struct SpaceTypeRecord
+{
+  quint32 name;
+  quint32 flags;
+  double ratio;
+  // Only meaningful with the matching Has* flag
+  double storyHeight;
+  double wwr;
+};
+
+static_assert(sizeof(Header) == 32);
+static_assert(sizeof(StandardTypeRecord) == 36);
+static_assert(sizeof(SpaceTypeRecord) == 32);
+
+}  // namespace mdwlib
+}  // namespace openstudio
+
+#endif  // OPENSTUDIO_MODELDESIGNWIZARDLIBRARYFORMAT_HPP
@@ -0,0 +1,149 @@
+/***********************************************************************************************************************
+*  OpenStudio(R), Copyright (c) 2020-2023, OpenStudio Coalition and other contributors. All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+*  following conditions are met:
+*
+*  (1) Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+*  disclaimer.
+*
+*  (2) Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+*  disclaimer in the documentation and/or other materials provided with the distribution.
+*
+*  (3) Neither the name of the copyright holder nor the names of any contributors may be used to endorse or promote products
+*  derived from this software without specific prior written permission from the respective party.
+*
+*  (4) Other than as required in clauses (1) and (2), distributions in any form of modifications or other derivative works
+*  may not use the "OpenStudio" trademark, "OS", "os", or any other confusingly similar designation without specific prior
+*  written permission from Alliance for Sustainable Energy, LLC.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER(S) AND ANY CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER(S), ANY CONTRIBUTORS, THE UNITED STATES GOVERNMENT, OR THE UNITED
+*  STATES DEPARTMENT OF ENERGY, NOR ANY OF THEIR EMPLOYEES, BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+*  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*  USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+*  STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+*  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************************************************************************/
+
+#include "ModelDesignWizardLibraryIndex.hpp"
+#include "ModelDesignWizardLibrary.hpp"
+
+namespace openstudio {
+
+static const std::vector<int> NoIds;
+
+void ModelDesignWizardLibraryIndex::build(const ModelDesignWizardLibrary& library) {
+  *this = ModelDesignWizardLibraryIndex();
+
+  for (const QString& standardTypeName : library.standardTypes()) {
+    const auto standardTypeId = static_cast<StandardTypeId>(m_standardTypes.size());
+    StandardType& standardType = m_standardTypes.emplace_back();
+    standardType.name = m_symbols.intern(standardTypeName);
+
+    const QStringList templateNames = library.templates(standardTypeName);
+    const QStringList buildingTypeNames = library.buildingTypes(standardTypeName);
+    for (const QString& templateName : templateNames) {
+      standardType.templates.push_back(static_cast<TemplateId>(m_templates.size()));
+      m_templates.push_back(Member{m_symbols.intern(templateName), standardTypeId, static_cast<int>(standardType.templates.size()) - 1});
+    }
+    for (const QString& buildingTypeName : buildingTypeNames) {
+      const auto buildingType = static_cast<BuildingTypeId>(m_buildingTypes.size());
+      const SymbolTable::Symbol name = m_symbols.intern(buildingTypeName);
+      standardType.buildingTypes.push_back(buildingType);
+      standardType.buildingTypeIds.insert(name, buildingType);
+      m_buildingTypes.push_back(Member{name, standardTypeId, static_cast<int>(standardType.buildingTypes.size()) - 1});
+    }
+
+    standardType.spaceTypeRanges.reserve(static_cast<size_t>(templateNames.size() * buildingTypeNames.size()));
+    for (const QString& templateName : templateNames) {
+      for (const QString& buildingTypeName : buildingTypeNames) {
+        Range& range = standardType.spaceTypeRanges.emplace_back();
+        range.begin = static_cast<int>(m_spaceTypeRatios.size());
+        for (const ModelDesignWizardLibrary::SpaceType& spaceType : library.spaceTypes(standardTypeName, templateName, buildingTypeName)) {
+          m_spaceTypeRatios.push_back(
+            SpaceTypeRatio{m_symbols.intern(spaceType.name), spaceType.ratio, spaceType.storyHeight, spaceType.circulation, spaceType.isDefault});
+        }
+        range.count = static_cast<int>(m_spaceTypeRatios.size()) - range.begin;
+      }
+    }
+  }
+}
+
+const SymbolTable& ModelDesignWizardLibraryIndex::symbols() const {
+  return m_symbols;
+}
+
+int ModelDesignWizardLibraryIndex::standardTypeCount() const {
+  return static_cast<int>(m_standardTypes.size());
+}
+
+int ModelDesignWizardLibraryIndex::templateCount() const {
+  return static_cast<int>(m_templates.size());
+}
+
+int ModelDesignWizardLibraryIndex::buildingTypeCount() const {
+  return static_cast<int>(m_buildingTypes.size());
+}
+
+const QString& ModelDesignWizardLibraryIndex::standardTypeName(StandardTypeId standardType) const {
+  return m_symbols.name(standardType >= 0 && standardType < standardTypeCount() ? m_standardTypes[static_cast<size_t>(standardType)].name
+                                                                                : SymbolTable::NoSymbol);
+}
+
+const QString& ModelDesignWizardLibraryIndex::templateName(TemplateId templateId) const {
+  return m_symbols.name(templateId >= 0 && templateId < templateCount() ? m_templates[static_cast<size_t>(templateId)].name : SymbolTable::NoSymbol);
+}
+
+const QString& ModelDesignWizardLibraryIndex::buildingTypeName(BuildingTypeId buildingType) const {
+  return m_symbols.name(buildingType >= 0 && buildingType < buildingTypeCount() ? m_buildingTypes[static_cast<size_t>(buildingType)].name
+                                                                                : SymbolTable::NoSymbol);
+}
+
+const QString& ModelDesignWizardLibraryIndex::spaceTypeName(SpaceTypeId spaceType) const {
+  return m_symbols.name(spaceType);
+}
+
+ModelDesignWizardLibraryIndex::StandardTypeId ModelDesignWizardLibraryIndex::standardTypeId(const QString& name) const {
+  const SymbolTable::Symbol symbol = m_symbols.find(name);
+  for (StandardTypeId standardType = 0; standardType < standardTypeCount(); ++standardType) {
+    if (m_standardTypes[static_cast<size_t>(standardType)].name == symbol) {
+      return standardType;
+    }
+  }
+  return -1;
+}
+
+ModelDesignWizardLibraryIndex::BuildingTypeId ModelDesignWizardLibraryIndex::buildingTypeId(StandardTypeId standardType, const QString& name) const {
+  if (standardType < 0 || standardType >= standardTypeCount()) {
+    return -1;
+  }
+  return m_standardTypes[static_cast<size_t>(standardType)].buildingTypeIds.value(m_symbols.find(name), -1);
+}
+
+const std::vector<ModelDesignWizardLibraryIndex::TemplateId>& ModelDesignWizardLibraryIndex::templates(StandardTypeId standardType) const {
+  return standardType >= 0 && standardType < standardTypeCount() ? m_standardTypes[static_cast<size_t>(standardType)].templates : NoIds;
+}
+
+const std::vector<ModelDesignWizardLibraryIndex::BuildingTypeId>& ModelDesignWizardLibraryIndex::buildingTypes(StandardTypeId standardType) const {
+  return standardType >= 0 && standardType < standardTypeCount() ? m_standardTypes[static_cast<size_t>(standardType)].buildingTypes : NoIds;
+}
+
+std::span<const ModelDesignWizardLibraryIndex::SpaceTypeRatio> ModelDesignWizardLibraryIndex::spaceTypeRatios(TemplateId templateId,
+                                                                                                             BuildingTypeId buildingType) const {
+  if (templateId < 0 || templateId >= templateCount() || buildingType < 0 || buildingType >= buildingTypeCount()) {
+    return {};
+  }
+  const Member& templateMember = m_templates[static_cast<size_t>(templateId)];
+  const Member& buildingTypeMember = m_buildingTypes[static_cast<size_t>(buildingType)];
+  if (templateMember.standardType != buildingTypeMember.standardType) {
+    return {};
+  }
+  const StandardType& standardType = m_standardTypes[static_cast<size_t>(templateMember.standardType)];
+  const auto rangeIndex = static_cast<size_t>(templateMember.index) * standardType.buildingTypes.size() + static_cast<size_t>(buildingTypeMember.index);
+  const Range& range = standardType.spaceTypeRanges[rangeIndex];
+  return std::span<const SpaceTypeRatio>(m_spaceTypeRatios).subspan(static_cast<size_t>(range.begin), static_cast<size_t>(range.count));
+}
+
+}  // namespace openstudio
@@ -0,0 +1,135 @@
+/***********************************************************************************************************************
+*  OpenStudio(R), Copyright (c) 2020-2023, OpenStudio Coalition and other contributors. All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+*  following conditions are met:
+*
+*  (1) Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+*  disclaimer.
+*
+*  (2) Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+*  disclaimer in the documentation and/or other materials provided with the distribution.
+*
+*  (3) Neither the name of the copyright holder nor the names of any contributors may be used to endorse or promote products
+*  derived from this software without specific prior written permission from the respective party.
+*
+*  (4) Other than as required in clauses (1) and (2), distributions in any form of modifications or other derivative works
+*  may not use the "OpenStudio" trademark, "OS", "os", or any other confusingly similar designation without specific prior
+*  written permission from Alliance for Sustainable Energy, LLC.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER(S) AND ANY CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER(S), ANY CONTRIBUTORS, THE UNITED STATES GOVERNMENT, OR THE UNITED
+*  STATES DEPARTMENT OF ENERGY, NOR ANY OF THEIR EMPLOYEES, BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+*  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*  USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+*  STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+*  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************************************************************************/
+
+#ifndef OPENSTUDIO_MODELDESIGNWIZARDLIBRARYINDEX_HPP
+#define OPENSTUDIO_MODELDESIGNWIZARDLIBRARYINDEX_HPP
+
+#include "SymbolTable.hpp"
+
+#include <QHash>
+#include <QString>
+
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace openstudio {
+
+class ModelDesignWizardLibrary;
+
+// What the wizard looks up in the library, built once with integer ids so that every lookup is an array access.
+// Ids are dense and start at 0, -1 is none. Templates and building types get an id per standard type they're in. Every
+// name, whatever it names, is interned once in symbols(), and a space type's id is the symbol of its name. The space type
+// ratios of each (template, building type) pair sit in one flat vector.
+class ModelDesignWizardLibraryIndex
+{
+ public:
+  using StandardTypeId = int;
+  using TemplateId = int;
+  using BuildingTypeId = int;
+  using SpaceTypeId = SymbolTable::Symbol;
+
+  struct SpaceTypeRatio
+  {
+    SpaceTypeId spaceType = -1;
+    double ratio = 0.0;
+    std::optional<double> storyHeight;
+    bool circulation = false;
+    bool isDefault = false;
+  };
+
+  void build(const ModelDesignWizardLibrary& library);
+
+  const SymbolTable& symbols() const;
+
+  int standardTypeCount() const;
+
+  int templateCount() const;
+
+  int buildingTypeCount() const;
+
+  const QString& standardTypeName(StandardTypeId standardType) const;
+
+  const QString& templateName(TemplateId templateId) const;
+
+  const QString& buildingTypeName(BuildingTypeId buildingType) const;
+
+  const QString& spaceTypeName(SpaceTypeId spaceType) const;
+
+  // Hashed, for names coming from outside the index. -1 if there's none by that name
+  StandardTypeId standardTypeId(const QString& name) const;
+
+  BuildingTypeId buildingTypeId(StandardTypeId standardType, const QString& name) const;
+
+  // In the library's order
+  const std::vector<TemplateId>& templates(StandardTypeId standardType) const;
+
+  const std::vector<BuildingTypeId>& buildingTypes(StandardTypeId standardType) const;
+
+  // Sorted by space type name, like the library. Empty for -1, or a pair the library has nothing for
+  std::span<const SpaceTypeRatio> spaceTypeRatios(TemplateId templateId, BuildingTypeId buildingType) const;
+
+ private:
+  // Of a (template, building type) pair in m_spaceTypeRatios
+  struct Range
+  {
+    int begin = 0;
+    int count = 0;
+  };
+
+  struct StandardType
+  {
+    SymbolTable::Symbol name = SymbolTable::NoSymbol;
+    std::vector<TemplateId> templates;
+    std::vector<BuildingTypeId> buildingTypes;
+    QHash<SymbolTable::Symbol, BuildingTypeId> buildingTypeIds;
+    // At the template's index * buildingTypes.size() + the building type's index. Per standard type: a template and a
+    // building type of different standard types never go together
+    std::vector<Range> spaceTypeRanges;
+  };
+
+  // A template or a building type
+  struct Member
+  {
+    SymbolTable::Symbol name = SymbolTable::NoSymbol;
+    StandardTypeId standardType = -1;
+    // In the standard type's templates or buildingTypes
+    int index = 0;
+  };
+
+  SymbolTable m_symbols;
+  std::vector<StandardType> m_standardTypes;
+  std::vector<Member> m_templates;
+  std::vector<Member> m_buildingTypes;
+  std::vector<SpaceTypeRatio> m_spaceTypeRatios;
+};
+
+}  // namespace openstudio
+
+#endif  // OPENSTUDIO_MODELDESIGNWIZARDLIBRARYINDEX_HPP
@@ -0,0 +1,212 @@
+/***********************************************************************************************************************
+*  OpenStudio(R), Copyright (c) 2020-2023, OpenStudio Coalition and other contributors. All rights reserved.
+*
+*  Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+*  following conditions are met:
+*
+*  (1) Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+*  disclaimer.
+*
+*  (2) Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+*  disclaimer in the documentation and/or other materials provided with the distribution.
+*
+*  (3) Neither the name of the copyright holder nor the names of any contributors may be used to endorse or promote products
+*  derived from this software without specific prior written permission from the respective party.
+*
+*  (4) Other than as required in clauses (1) and (2), distributions in any form of modifications or other derivative works
+*  may not use the "OpenStudio" trademark, "OS", "os", or any other confusingly similar designation without specific prior
+*  written permission from Alliance for Sustainable Energy, LLC.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER(S) AND ANY CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+*  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+*  DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER(S), ANY CONTRIBUTORS, THE UNITED STATES GOVERNMENT, OR THE UNITED
+*  STATES DEPARTMENT OF ENERGY, NOR ANY OF THEIR EMPLOYEES, BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+*  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+*  USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+*  STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+*  ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+***********************************************************************************************************************/
+
+#include "ModelDesignWizardLibraryWriter.hpp"
+#include "ModelDesignWizardLibraryFormat.hpp"
+
+#include <QHash>
+#include <QJsonArray>
+#include <QList>
+#include <QString>
+#include <QtEndian>
+
+#include <bit>
+#include <cstddef>
+#include <type_traits>
+
+namespace openstudio {
+namespace mdwlib {
+
+class LibraryWriter
+{
+ public:
+  QByteArray write(const QJsonObject& library);
+
+ private:
+  // Zero-filled room for size bytes at the end of the blob, 8-byte aligned, returns its offset
+  qsizetype reserve(qsizetype size);
+
+  template <typename T>
+  void put(qsizetype record, std::size_t field, T value);
+
+  quint32 string(const QString& value);
+
+  // The ids of an array of strings, with its count and offset stored in the record
+  void putStringList(qsizetype record, std::size_t countField, std::size_t offsetField, const QJsonArray& values);
+
+  void putSpaceTypeTemplates(qsizetype record, const QJsonObject& spaceTypes);
+
+  void putSpaceTypes(qsizetype record, const QJsonObject& spaceTypes);
+
+  void putStrings(qsizetype header);
+
+  QByteArray m_blob;
+  QHash<QString, quint32> m_stringIds;
+  QList<QByteArray> m_strings;
+};
+
+qsizetype LibraryWriter::reserve(qsizetype size) {
+  m_blob.append((8 - m_blob.size() % 8) % 8, '\0');
+  const qsizetype offset = m_blob.size();
+  m_blob.append(size, '\0');
+  return offset;
+}
+
+template <typename T>
+void LibraryWriter::put(qsizetype record, std::size_t field, T value) {
+  char* dest = m_blob.data() + record + static_cast<qsizetype>(field);
+  if constexpr (std::is_same_v<T, double>) {
+    qToLittleEndian(std::bit_cast<quint64>(value), dest);
+  } else {
+    qToLittleEndian(static_cast<quint32>(value), dest);
+  }
+}
+
+quint32 LibraryWriter::string(const QString& value) {
+  const auto it = m_stringIds.constFind(value);
+  if (it != m_stringIds.cend()) {
+    return *it;
+  }
+  const auto id = static_cast<quint32>(m_strings.size());
+  m_stringIds.insert(value, id);
+  m_strings.append(value.toUtf8());
+  return id;
+}
+
+void LibraryWriter::putStringList(qsizetype record, std::size_t countField, std::size_t offsetField, const QJsonArray& values) {
+  const qsizetype offset = reserve(values.size() * static_cast<qsizetype>(sizeof(quint32)));
+  for (qsizetype i = 0; i < values.size(); ++i) {
+    put(offset, i * sizeof(quint32), string(values[i].toString()));
+  }
+  put(record, countField, values.size());
+  put(record, offsetField, offset);
+}
+
+void LibraryWriter::putSpaceTypeTemplates(qsizetype record, const QJsonObject& spaceTypes) {
+  const qsizetype templates = reserve(spaceTypes.size() * static_cast<qsizetype>(sizeof(SpaceTypeTemplateRecord)));
+  put(record, offsetof(StandardTypeRecord, spaceTypeTemplateCount), spaceTypes.size());
+  put(record, offsetof(StandardTypeRecord, spaceTypeTemplatesOffset), templates);
+
+  qsizetype templateRecord = templates;
+  for (auto it = spaceTypes.constBegin(); it != spaceTypes.constEnd(); ++it, templateRecord += sizeof(SpaceTypeTemplateRecord)) {
+    const QJsonObject buildings = it.value().toObject();
+    const qsizetype buildingRecords = reserve(buildings.size() * static_cast<qsizetype>(sizeof(SpaceTypeBuildingRecord)));
+    put(templateRecord, offsetof(SpaceTypeTemplateRecord, name), string(it.key()));
+    put(templateRecord, offsetof(SpaceTypeTemplateRecord, buildingCount), buildings.size());
+    put(templateRecord, offsetof(SpaceTypeTemplateRecord, buildingsOffset), buildingRecords);
+
+    qsizetype buildingRecord = buildingRecords;
+    for (auto building = buildings.constBegin(); building != buildings.constEnd(); ++building, buildingRecord += sizeof(SpaceTypeBuildingRecord)) {
+      put(buildingRecord, offsetof(SpaceTypeBuildingRecord, name), string(building.key()));
+      // Some building types are just 'false' for some templates, they get no space types like toObject() gave them
+      putSpaceTypes(buildingRecord, building.value().toObject());
+    }
+  }
+}
+
+void LibraryWriter::putSpaceTypes(qsizetype record, const QJsonObject& spaceTypes) {
+  const qsizetype spaceTypeRecords = reserve(spaceTypes.size() * static_cast<qsizetype>(sizeof(SpaceTypeRecord)));
+  put(record, offsetof(SpaceTypeBuildingRecord, spaceTypeCount), spaceTypes.size());
+  put(record, offsetof(SpaceTypeBuildingRecord, spaceTypesOffset), spaceTypeRecords);
+
+  qsizetype spaceTypeRecord = spaceTypeRecords;
+  for (auto it = spaceTypes.constBegin(); it != spaceTypes.constEnd(); ++it, spaceTypeRecord += sizeof(SpaceTypeRecord)) {
+    const QJsonObject spaceType = it.value().toObject();
+    quint32 flags = 0;
+    if (spaceType["space_type_gen"].toBool()) {
+      flags |= SpaceTypeGen;
+    }
+    if (spaceType["default"].toBool()) {
+      flags |= Default;
+    }
+    if (spaceType["circ"].toBool()) {
+      flags |= Circulation;
+    }
+    if (spaceType.contains("story_height")) {
+      flags |= HasStoryHeight;
+    }
+    if (spaceType.contains("wwr")) {
+      flags |= HasWwr;
+    }
+    put(spaceTypeRecord, offsetof(SpaceTypeRecord, name), string(it.key()));
+    put(spaceTypeRecord, offsetof(SpaceTypeRecord, flags), flags);
+    put(spaceTypeRecord, offsetof(SpaceTypeRecord, ratio), spaceType["ratio"].toDouble());
+    put(spaceTypeRecord, offsetof(SpaceTypeRecord, storyHeight), spaceType["story_height"].toDouble());
+    put(spaceTypeRecord, offsetof(SpaceTypeRecord, wwr), spaceType["wwr"].toDouble());
+  }
+}
+
+void LibraryWriter::putStrings(qsizetype header) {
+  // Last, once every string is known
+  const qsizetype records = reserve(m_strings.size() * static_cast<qsizetype>(sizeof(StringRecord)));
+  put(header, offsetof(Header, stringCount), m_strings.size());
+  put(header, offsetof(Header, stringsOffset), records);
+
+  qsizetype record = records;
+  for (const QByteArray& value : m_strings) {
+    put(record, offsetof(StringRecord, offset), m_blob.size());
+    put(record, offsetof(StringRecord, size), value.size());
+    m_blob.append(value);
+    record += sizeof(StringRecord);
+  }
+}
+
+QByteArray LibraryWriter::write(const QJsonObject& library) {
+  const qsizetype header = reserve(sizeof(Header));
+  const qsizetype standardTypes = reserve(library.size() * static_cast<qsizetype>(sizeof(StandardTypeRecord)));
+  put(header, offsetof(Header, magic), Magic);
+  put(header, offsetof(Header, version), Version);
+  put(header, offsetof(Header, standardTypeCount), library.size());
+  put(header, offsetof(Header, standardTypesOffset), standardTypes);
+
+  qsizetype record = standardTypes;
+  for (auto it = library.constBegin(); it != library.constEnd(); ++it, record += sizeof(StandardTypeRecord)) {
+    const QJsonObject standardType = it.value().toObject();
+    put(record, offsetof(StandardTypeRecord, name), string(it.key()));
+    putStringList(record, offsetof(StandardTypeRecord, templateCount), offsetof(StandardTypeRecord, templatesOffset),
+                  standardType["templates"].toArray());
+    putStringList(record, offsetof(StandardTypeRecord, buildingTypeCount), offsetof(StandardTypeRecord, buildingTypesOffset),
+                  standardType["building_types"].toArray());
+    putStringList(record, offsetof(StandardTypeRecord, climateZoneCount), offsetof(StandardTypeRecord, climateZonesOffset),
+                  standardType["climate_zones"].toArray());
+    putSpaceTypeTemplates(record, standardType["space_types"].toObject());
+  }
+
+  putStrings(header);
+  put(header, offsetof(Header, size), m_blob.size());
+  return m_blob;
+}
+
+}  // namespace mdwlib
+
+QByteArray compileLibrary(const QJsonObject& library) {
+  return mdwlib::LibraryWriter().write(library);
+}
+
+}  // namespace openstudio
@@ -0,0 +1,70 @@
+// Startup cost of ModelDesignWizardDialog: loading the library the way the dialog used to (parsing the JSON), the way it
+// does now (the compiled library, read in place), and the dialog's own time to first paint and time to interactive, the
+// library being loaded on a worker thread meanwhile.
+//
+// Usage: QT_QPA_PLATFORM=offscreen DialogStartupBenchmark [iterations]
+
+#include "ModelDesignWizardDialog.hpp"
+#include "ModelDesignWizardLibrary.hpp"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <cstdio>
+#include <cstdlib>
+
+int main(int argc, char* argv[]) {
+  QApplication app(argc, argv);
+  const int iterations = argc > 1 ? std::atoi(argv[1]) : 20;
+
+  QElapsedTimer timer;
+
+  // Before: what the constructor did, on the same JSON the library is compiled from
+  qsizetype keyCount = 0;
+  timer.start();
+  for (int i = 0; i < iterations; ++i) {
+    QFile file(MDW_LIBRARY_JSON);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+      std::fprintf(stderr, "Cannot open %s\n", MDW_LIBRARY_JSON);
+      return 1;
+    }
+    const QJsonObject library = QJsonDocument::fromJson(QString(file.readAll()).toUtf8()).object();
+    keyCount += library.size();
+  }
+  const double jsonMs = timer.nsecsElapsed() / 1e6 / iterations;
+
+  // After
+  openstudio::ModelDesignWizardLibrary library;
+  QString error;
+  timer.restart();
+  for (int i = 0; i < iterations; ++i) {
+    if (!library.load(openstudio::ModelDesignWizardLibrary::ResourcePath, &error)) {
+      std::fprintf(stderr, "%s\n", qPrintable(error));
+      return 1;
+    }
+  }
+  const double libraryMs = timer.nsecsElapsed() / 1e6 / iterations;
+
+  qint64 firstPaintMs = 0;
+  qint64 interactiveMs = 0;
+  for (int i = 0; i < iterations; ++i) {
+    openstudio::ModelDesignWizardDialog dialog;
+    QEventLoop loop;
+    QObject::connect(&dialog, &openstudio::ModelDesignWizardDialog::interactive, &loop, &QEventLoop::quit);
+    dialog.show();
+    loop.exec();
+    firstPaintMs += dialog.firstPaintMs();
+    interactiveMs += dialog.interactiveMs();
+  }
+
+  std::printf("library, JSON:      %10.3f ms (%lld standard types, %lld bytes)\n", jsonMs, static_cast<long long>(keyCount / iterations),
+              static_cast<long long>(QFile(MDW_LIBRARY_JSON).size()));
+  std::printf("library, compiled:  %10.3f ms (%lld bytes)\n", libraryMs, static_cast<long long>(library.size()));
+  std::printf("dialog, first paint: %9.1f ms\n", static_cast<double>(firstPaintMs) / iterations);
+  std::printf("dialog, interactive: %9.1f ms\n", static_cast<double>(interactiveMs) / iterations);
+  return 0;
+}
@@ -0,0 +1,157 @@
+// Memory of the library as the dialog used to hold it (a QJsonObject, one QString per occurrence of a name) and as it
+// holds it now (the index, every name interned once in its SymbolTable), on catalogs made of copies of the library's
+// templates, plus the cost of comparing space type names as strings and as symbols.
+//
+// Usage: LibrarySymbolsBenchmark [copies]
+
+#include "ModelDesignWizardLibrary.hpp"
+#include "ModelDesignWizardLibraryIndex.hpp"
+#include "ModelDesignWizardLibraryWriter.hpp"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace openstudio;
+
+namespace {
+
+// Resident set size, -1 where there's no /proc to read it from
+qint64 residentBytes() {
+  QFile status("/proc/self/status");
+  if (!status.open(QIODevice::ReadOnly)) {
+    return -1;
+  }
+  for (const QByteArray& line : status.readAll().split('\n')) {
+    if (line.startsWith("VmRSS:")) {
+      return line.mid(6).trimmed().split(' ').value(0).toLongLong() * 1024;
+    }
+  }
+  return -1;
+}
+
+// Every template copies times over ("90.1-2019", "90.1-2019 (2)", ...) with the same building types and space types,
+// like a catalog with customer variants of each template
+QJsonObject scaledLibrary(const QJsonObject& library, int copies) {
+  QJsonObject result;
+  for (auto it = library.constBegin(); it != library.constEnd(); ++it) {
+    QJsonObject standardType = it.value().toObject();
+    const QJsonArray templates = standardType["templates"].toArray();
+    const QJsonObject spaceTypes = standardType["space_types"].toObject();
+    QJsonArray scaledTemplates;
+    QJsonObject scaledSpaceTypes;
+    for (int copy = 0; copy < copies; ++copy) {
+      const QString suffix = copy == 0 ? QString() : QString(" (%1)").arg(copy + 1);
+      for (const auto& templateName : templates) {
+        scaledTemplates.append(templateName.toString() + suffix);
+      }
+      for (auto templateIt = spaceTypes.constBegin(); templateIt != spaceTypes.constEnd(); ++templateIt) {
+        scaledSpaceTypes.insert(templateIt.key() + suffix, templateIt.value());
+      }
+    }
+    standardType["templates"] = scaledTemplates;
+    standardType["space_types"] = scaledSpaceTypes;
+    result.insert(it.key(), standardType);
+  }
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const int copies = argc > 1 ? std::atoi(argv[1]) : 50;
+
+  QFile file(MDW_LIBRARY_JSON);
+  if (!file.open(QIODevice::ReadOnly)) {
+    std::fprintf(stderr, "Cannot open %s\n", MDW_LIBRARY_JSON);
+    return 1;
+  }
+  QByteArray json;
+  QByteArray compiled;
+  {
+    const QJsonObject scaled = scaledLibrary(QJsonDocument::fromJson(file.readAll()).object(), copies);
+    json = QJsonDocument(scaled).toJson(QJsonDocument::Compact);
+    compiled = compileLibrary(scaled);
+  }
+  // In the application the compiled library is resource data, it's counted in neither
+  ModelDesignWizardLibrary library;
+  QString error;
+  if (!library.loadData(reinterpret_cast<const uchar*>(compiled.constData()), compiled.size(), &error)) {
+    std::fprintf(stderr, "%s\n", qPrintable(error));
+    return 1;
+  }
+
+  QElapsedTimer timer;
+  const qint64 residentBefore = residentBytes();
+  timer.start();
+  ModelDesignWizardLibraryIndex index;
+  index.build(library);
+  const qint64 indexNs = timer.nsecsElapsed();
+  const qint64 residentIndex = residentBytes();
+
+  timer.restart();
+  const QJsonObject jsonLibrary = QJsonDocument::fromJson(json).object();
+  const qint64 jsonNs = timer.nsecsElapsed();
+  const qint64 residentJson = residentBytes();
+
+  // Every space type of the catalog: by name as the JSON has them, and as symbols
+  std::vector<QString> names;
+  for (auto standardType = jsonLibrary.constBegin(); standardType != jsonLibrary.constEnd(); ++standardType) {
+    const QJsonObject spaceTypes = standardType.value().toObject()["space_types"].toObject();
+    for (auto templateIt = spaceTypes.constBegin(); templateIt != spaceTypes.constEnd(); ++templateIt) {
+      const QJsonObject buildings = templateIt.value().toObject();
+      for (auto building = buildings.constBegin(); building != buildings.constEnd(); ++building) {
+        for (const QString& name : building.value().toObject().keys()) {
+          names.push_back(name);
+        }
+      }
+    }
+  }
+  std::vector<SymbolTable::Symbol> symbols;
+  for (int standardType = 0; standardType < index.standardTypeCount(); ++standardType) {
+    for (const int templateId : index.templates(standardType)) {
+      for (const int buildingType : index.buildingTypes(standardType)) {
+        for (const auto& spaceTypeRatio : index.spaceTypeRatios(templateId, buildingType)) {
+          symbols.push_back(spaceTypeRatio.spaceType);
+        }
+      }
+    }
+  }
+
+  constexpr int Passes = 100;
+  const QString needle = QStringLiteral("Classroom");
+  long long nameMatches = 0;
+  timer.restart();
+  for (int pass = 0; pass < Passes; ++pass) {
+    for (const QString& name : names) {
+      nameMatches += name == needle ? 1 : 0;
+    }
+  }
+  const double nameNs = static_cast<double>(timer.nsecsElapsed()) / Passes / static_cast<double>(names.size());
+
+  const SymbolTable::Symbol needleSymbol = index.symbols().find(needle);
+  long long symbolMatches = 0;
+  timer.restart();
+  for (int pass = 0; pass < Passes; ++pass) {
+    for (const SymbolTable::Symbol symbol : symbols) {
+      symbolMatches += symbol == needleSymbol ? 1 : 0;
+    }
+  }
+  const double symbolNs = static_cast<double>(timer.nsecsElapsed()) / Passes / static_cast<double>(symbols.size());
+
+  std::printf("%d copies: %d templates, %zu space type entries, %d distinct names, JSON %.1f MB, compiled %.1f MB\n", copies,
+              index.templateCount(), symbols.size(), index.symbols().size(), json.size() / 1e6, compiled.size() / 1e6);
+  if (residentBefore >= 0) {
+    std::printf("  resident, index:       %10.1f MB (built in %.1f ms)\n", (residentIndex - residentBefore) / 1e6, indexNs / 1e6);
+    std::printf("  resident, QJsonObject: %10.1f MB (parsed in %.1f ms)\n", (residentJson - residentIndex) / 1e6, jsonNs / 1e6);
+  }
+  std::printf("  compare, QString:      %10.2f ns (%lld matches)\n", nameNs, nameMatches / Passes);
+  std::printf("  compare, symbol:       %10.2f ns (%lld matches)\n", symbolNs, symbolMatches / Passes);
+  return 0;
+}
@@ -0,0 +1,92 @@
+// Time to parse an EPW file with EpwFile vs reading it the obvious way (QTextStream, split on commas, toFloat)
+//
+// Usage: EpwBenchmark [iterations] [path.epw]
+
+#include "../epwfile.hpp"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+// Same result as EpwFile, minus the header blocks: row major floats
+qsizetype naiveLoad(const QString& path, std::vector<float>& values) {
+  values.clear();
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    return 0;
+  }
+  QTextStream stream(&file);
+  qsizetype rowCount = 0;
+  int lineNumber = 0;
+  while (!stream.atEnd()) {
+    const QString line = stream.readLine();
+    // 8 header lines
+    if (++lineNumber <= 8 || line.isEmpty()) {
+      continue;
+    }
+    const QStringList fields = line.split(',');
+    for (int field = 0; field < EpwFile::FieldCount; ++field) {
+      bool ok = false;
+      const float value = field < fields.size() ? fields[field].toFloat(&ok) : 0.0f;
+      values.push_back(ok ? value : NAN);
+    }
+    ++rowCount;
+  }
+  return rowCount;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const int iterations = argc > 1 ? std::atoi(argv[1]) : 1000;
+  const QString path = argc > 2 ? QString::fromLocal8Bit(argv[2]) : QStringLiteral(EPW_PATH);
+
+  // Both go through the file cache, the first iterations of each warm it up for the other
+  double naiveSink = 0.0;
+  qsizetype naiveRows = 0;
+  std::vector<float> naiveValues;
+  QElapsedTimer timer;
+  timer.start();
+  for (int i = 0; i < iterations; ++i) {
+    naiveRows = naiveLoad(path, naiveValues);
+    naiveSink += naiveValues.empty() ? 0.0 : naiveValues[EpwFile::DryBulbTemperature];
+  }
+  const qint64 naiveNs = timer.nsecsElapsed();
+
+  double epwSink = 0.0;
+  EpwFile epw;
+  timer.restart();
+  for (int i = 0; i < iterations; ++i) {
+    QString error;
+    if (!epw.load(path, &error)) {
+      std::fprintf(stderr, "%s\n", qPrintable(error));
+      return 1;
+    }
+    epwSink += epw.rowCount > 0 ? epw.column(EpwFile::DryBulbTemperature)[0] : 0.0;
+  }
+  const qint64 epwNs = timer.nsecsElapsed();
+
+  // Hourly mean dry bulb, so the values are all read at least once
+  double dryBulbSum = 0.0;
+  const float* dryBulb = epw.column(EpwFile::DryBulbTemperature);
+  for (qsizetype row = 0; row < epw.rowCount; ++row) {
+    dryBulbSum += dryBulb[row];
+  }
+
+  std::printf("%s: %s, %lld rows of %d fields, %zu ground temperature depths\n", qPrintable(path), qPrintable(epw.location.city),
+              static_cast<long long>(epw.rowCount), static_cast<int>(EpwFile::FieldCount), epw.groundTemperatures.size());
+  std::printf("  naive (%lld rows): %8.3f ms per file\n", static_cast<long long>(naiveRows), naiveNs / 1e6 / iterations);
+  std::printf("  EpwFile:           %8.3f ms per file\n", epwNs / 1e6 / iterations);
+  std::printf("  speedup:           %8.1fx\n", epwNs > 0 ? static_cast<double>(naiveNs) / static_cast<double>(epwNs) : 0.0);
+  std::printf("(mean dry bulb %.2f C, checksums %.1f / %.1f)\n", epw.rowCount > 0 ? dryBulbSum / epw.rowCount : 0.0, naiveSink, epwSink);
+  return 0;
+}
@@ -0,0 +1,263 @@
+// End to end ingestion benchmark: runs openstudio-standin through the JobScheduler exactly like the GUI does, with a log
+// view attached and following the tail, and reports for each scenario:
+//  - lines/s that made it through ingestion, and how many of them were suppressed from the live view to keep up
+//  - peak RSS during the run
+//  - GUI thread stalls: percentiles of the gaps between the ticks of a 1 ms timer on the GUI thread
+// degradedKeepsErrors checks that sampling the live view during a flood never drops an ERROR line.
+//
+// Usage: IngestionBenchmark [QtTest options], eg IngestionBenchmark -platform offscreen ingest:"socket logs"
+
+#include "../jobscheduler.hpp"
+#include "../runlogdelegate.hpp"
+#include "../runlogstore.hpp"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QListView>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QTimer>
+
+#if defined(Q_OS_UNIX)
+#  include <sys/resource.h>
+#endif
+
+#include <algorithm>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// Resets the kernel's peak RSS counter where we can (Linux), so each scenario gets its own peak
+void resetPeakRss() {
+#if defined(Q_OS_LINUX)
+  QFile clearRefs("/proc/self/clear_refs");
+  if (clearRefs.open(QIODevice::WriteOnly)) {
+    clearRefs.write("5");
+  }
+#endif
+}
+
+// In MB. Elsewhere than Linux it's the peak of the whole process so far
+double peakRssMb() {
+#if defined(Q_OS_LINUX)
+  QFile status("/proc/self/status");
+  if (status.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    for (const QByteArray& line : status.readAll().split('\n')) {
+      if (line.startsWith("VmHWM:")) {
+        return line.mid(6).trimmed().split(' ').first().toDouble() / 1024.0;
+      }
+    }
+  }
+#endif
+#if defined(Q_OS_UNIX)
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+#  if defined(Q_OS_MACOS)
+  return usage.ru_maxrss / (1024.0 * 1024.0);
+#  else
+  return usage.ru_maxrss / 1024.0;
+#  endif
+#else
+  return 0.0;
+#endif
+}
+
+// Records how late each tick of a 1 ms timer fires: anything the GUI thread does in one go shows up as a long gap
+class StallProbe
+{
+public:
+  StallProbe() {
+    m_timer.setTimerType(Qt::PreciseTimer);
+    m_timer.setInterval(1);
+    QObject::connect(&m_timer, &QTimer::timeout, [this]() {
+      const qint64 now = m_clock.nsecsElapsed();
+      m_gapsNs.push_back(now - m_lastTickNs);
+      m_lastTickNs = now;
+    });
+  }
+
+  void start() {
+    m_gapsNs.clear();
+    m_clock.start();
+    m_lastTickNs = 0;
+    m_timer.start();
+  }
+
+  void stop() {
+    m_timer.stop();
+  }
+
+  // In ms
+  double percentile(double p) {
+    if (m_gapsNs.empty()) {
+      return 0.0;
+    }
+    const size_t rank = std::min(m_gapsNs.size() - 1, static_cast<size_t>(p * static_cast<double>(m_gapsNs.size())));
+    std::nth_element(m_gapsNs.begin(), m_gapsNs.begin() + static_cast<std::ptrdiff_t>(rank), m_gapsNs.end());
+    return static_cast<double>(m_gapsNs[rank]) / 1e6;
+  }
+
+  double max() const {
+    return m_gapsNs.empty() ? 0.0 : static_cast<double>(*std::max_element(m_gapsNs.begin(), m_gapsNs.end())) / 1e6;
+  }
+
+private:
+  QTimer m_timer;
+  QElapsedTimer m_clock;
+  qint64 m_lastTickNs = 0;
+  std::vector<qint64> m_gapsNs;
+};
+
+}  // namespace
+
+class IngestionBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void ingest_data();
+    void ingest();
+    void degradedKeepsErrors();
+
+private:
+    QTemporaryDir m_runLogDirectory;
+};
+
+void IngestionBenchmark::initTestCase() {
+  // The JobSchedulers keep their measure schemas in the app data directory: not the user's one
+  QStandardPaths::setTestModeEnabled(true);
+  QVERIFY(QFile::exists(STANDIN_PATH));
+  QVERIFY(QFile::exists(WORKFLOW_PATH));
+  QVERIFY(m_runLogDirectory.isValid());
+}
+
+void IngestionBenchmark::ingest_data() {
+  QTest::addColumn<QString>("standinArgs");
+  QTest::addColumn<int>("jobs");
+
+  QTest::newRow("stdout") << "--flood 200000 --state-delay 0" << 1;
+  QTest::newRow("stdout, partial lines") << "--flood 200000 --state-delay 0 --partial-lines" << 1;
+  QTest::newRow("socket logs") << "--flood 200000 --state-delay 0 --socket-logs" << 1;
+  QTest::newRow("socket logs, partial frames") << "--flood 200000 --state-delay 0 --socket-logs --partial-lines" << 1;
+  QTest::newRow("no socket") << "--flood 200000 --state-delay 0 --ignore-socket" << 1;
+  QTest::newRow("noisy mix") << "--flood 200000 --state-delay 0 --mix 0,0,50,50" << 1;
+  QTest::newRow("paced, 50k lines/s") << "--flood 100000 --state-delay 0 --rate 50000" << 1;
+  QTest::newRow("4 jobs") << "--flood 100000 --state-delay 0" << 4;
+}
+
+void IngestionBenchmark::ingest() {
+  QFETCH(QString, standinArgs);
+  QFETCH(int, jobs);
+
+  qputenv("OPENSTUDIO_STANDIN_ARGS", standinArgs.toUtf8());
+
+  JobScheduler scheduler;
+  scheduler.setProgram(STANDIN_PATH);
+  scheduler.setRunLogDirectory(m_runLogDirectory.path());
+  scheduler.setMaxConcurrentJobs(jobs);
+  for (int i = 0; i < jobs; ++i) {
+    scheduler.addJob(WORKFLOW_PATH);
+  }
+
+  // Same view setup as the MainWindow, following the tail of the first job
+  QListView view;
+  view.setItemDelegate(new RunLogDelegate(view.font(), &view));
+  view.setUniformItemSizes(true);
+  view.setModel(scheduler.logModel(0));
+  QObject::connect(scheduler.logModel(0), &QAbstractItemModel::rowsInserted, &view, &QListView::scrollToBottom);
+  view.resize(800, 600);
+  view.show();
+
+  QSignalSpy finished(&scheduler, &JobScheduler::allJobsFinished);
+  StallProbe stalls;
+  resetPeakRss();
+
+  qint64 wallMs = 0;
+  QBENCHMARK_ONCE {
+    QElapsedTimer timer;
+    timer.start();
+    stalls.start();
+    scheduler.start();
+    QVERIFY(finished.wait(10 * 60 * 1000));
+    stalls.stop();
+    wallMs = timer.elapsed();
+  }
+
+  qint64 lines = 0;
+  qint64 suppressedLines = 0;
+  for (int row = 0; row < scheduler.rowCount(); ++row) {
+    QCOMPARE(scheduler.jobStatus(row), JobScheduler::JobStatus::Succeeded);
+    lines += scheduler.data(scheduler.index(row, JobScheduler::LinesColumn)).toLongLong();
+    suppressedLines += scheduler.suppressedLineCount(row);
+  }
+  const qint64 totalLines = lines + suppressedLines;
+
+  qInfo("%lld lines in %lld ms: %.0f lines/s, %lld suppressed from the live view, peak RSS %.1f MB", totalLines, wallMs,
+        wallMs > 0 ? totalLines * 1000.0 / wallMs : 0.0, suppressedLines, peakRssMb());
+  qInfo("GUI stalls (ms): p50 %.2f, p95 %.2f, p99 %.2f, max %.2f", stalls.percentile(0.50), stalls.percentile(0.95), stalls.percentile(0.99),
+        stalls.max());
+}
+
+void IngestionBenchmark::degradedKeepsErrors() {
+  // INFO lines with ERROR ones in between, on stdout while the run socket is up
+  qputenv("OPENSTUDIO_STANDIN_ARGS", "--flood 200000 --state-delay 0 --mix 0,95,0,5");
+
+  JobScheduler scheduler;
+  scheduler.setProgram(STANDIN_PATH);
+  scheduler.setRunLogDirectory(m_runLogDirectory.path());
+  scheduler.addJob(WORKFLOW_PATH);
+
+  QListView view;
+  view.setItemDelegate(new RunLogDelegate(view.font(), &view));
+  view.setUniformItemSizes(true);
+  view.setModel(scheduler.logModel(0));
+  QObject::connect(scheduler.logModel(0), &QAbstractItemModel::rowsInserted, &view, &QListView::scrollToBottom);
+  view.resize(800, 600);
+  view.show();
+
+  QSignalSpy finished(&scheduler, &JobScheduler::allJobsFinished);
+  scheduler.start();
+  QVERIFY(finished.wait(10 * 60 * 1000));
+  QCOMPARE(scheduler.jobStatus(0), JobScheduler::JobStatus::Succeeded);
+  if (scheduler.suppressedLineCount(0) == 0) {
+    QSKIP("The live view kept up, nothing was sampled");
+  }
+
+  // The store has every line: the flood's ERROR lines are the "<1>" ones
+  RunLogStore store;
+  QVERIFY(store.open(scheduler.logBasePath(0)));
+  qint64 floodErrors = 0;
+  qint64 storedErrors = 0;
+  for (qint64 line = 0; line < store.lineCount(); ++line) {
+    const QByteArrayView data = store.lineData(line);
+    if (std::string_view(data.data(), data.size()).find(" <1> ") != std::string_view::npos) {
+      ++floodErrors;
+    }
+    if (store.lineStyle(line) == LogStyle::Error) {
+      ++storedErrors;
+    }
+  }
+
+  RunLogModel* model = scheduler.logModel(0);
+  QCOMPARE(model->droppedLineCount(), qint64(0));
+  qint64 shownErrors = 0;
+  for (int row = 0; row < model->rowCount(); ++row) {
+    if (static_cast<LogStyle>(model->data(model->index(row), RunLogModel::StyleRole).toInt()) == LogStyle::Error) {
+      ++shownErrors;
+    }
+  }
+
+  qInfo("%lld ERROR lines in the flood, %lld stored as errors, %lld shown, %lld lines suppressed", floodErrors, storedErrors, shownErrors,
+        scheduler.suppressedLineCount(0));
+  QVERIFY(floodErrors > 0);
+  QCOMPARE(storedErrors, floodErrors);
+  QCOMPARE(shownErrors, floodErrors);
+}
+
+QTEST_MAIN(IngestionBenchmark)
+
+#include "ingestion_benchmark.moc"
@@ -0,0 +1,135 @@
+// Lines/second of the compiled LineClassifier vs the contains() / QString::compare() chain it replaced
+//
+// Usage: LineClassifierBenchmark [iterations]
+
+#include "../lineclassifier.hpp"
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QList>
+#include <QString>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+
+namespace {
+
+// Verbatim copy of the chain from MainWindow::readyReadStandardOutput, before it moved to classifyLine
+int legacyClassify(const QString& trimmedLine) {
+  if (trimmedLine.isEmpty()) {
+    return 0;
+  } else if ((trimmedLine.contains("DEBUG")) || (trimmedLine.contains("] <-2>"))) {
+    return 1;
+  } else if ((trimmedLine.contains("INFO")) || (trimmedLine.contains("] <-1>"))) {
+    return 2;
+  } else if ((trimmedLine.contains("WARN")) || (trimmedLine.contains("] <0>"))) {
+    return 3;
+  } else if ((trimmedLine.contains("ERROR")) || (trimmedLine.contains("] <1>"))) {
+    return 4;
+  } else if ((trimmedLine.contains("FATAL")) || (trimmedLine.contains("] <1>"))) {
+    return 5;
+  } else if (QString::compare(trimmedLine, "Starting state initialization", Qt::CaseInsensitive) == 0) {
+    return 6;
+  } else if (QString::compare(trimmedLine, "Started", Qt::CaseInsensitive) == 0) {
+    return 7;
+  } else if (QString::compare(trimmedLine, "Returned from state initialization", Qt::CaseInsensitive) == 0) {
+    return 8;
+  } else if (QString::compare(trimmedLine, "Starting state os_measures", Qt::CaseInsensitive) == 0) {
+    return 9;
+  } else if (QString::compare(trimmedLine, "Returned from state os_measures", Qt::CaseInsensitive) == 0) {
+    return 10;
+  } else if (QString::compare(trimmedLine, "Starting state translator", Qt::CaseInsensitive) == 0) {
+    return 11;
+  } else if (QString::compare(trimmedLine, "Returned from state translator", Qt::CaseInsensitive) == 0) {
+    return 12;
+  } else if (QString::compare(trimmedLine, "Starting state ep_measures", Qt::CaseInsensitive) == 0) {
+    return 13;
+  } else if (QString::compare(trimmedLine, "Returned from state ep_measures", Qt::CaseInsensitive) == 0) {
+    return 14;
+  } else if (QString::compare(trimmedLine, "Starting state preprocess", Qt::CaseInsensitive) == 0) {
+    return 15;
+  } else if (QString::compare(trimmedLine, "Returned from state preprocess", Qt::CaseInsensitive) == 0) {
+    return 16;
+  } else if (QString::compare(trimmedLine, "Starting state simulation", Qt::CaseInsensitive) == 0) {
+    return 17;
+  } else if (QString::compare(trimmedLine, "Returned from state simulation", Qt::CaseInsensitive) == 0) {
+    return 18;
+  } else if (QString::compare(trimmedLine, "Starting state reporting_measures", Qt::CaseInsensitive) == 0) {
+    return 19;
+  } else if (QString::compare(trimmedLine, "Returned from state reporting_measures", Qt::CaseInsensitive) == 0) {
+    return 20;
+  } else if (QString::compare(trimmedLine, "Starting state postprocess", Qt::CaseInsensitive) == 0) {
+    return 21;
+  } else if (QString::compare(trimmedLine, "Returned from state postprocess", Qt::CaseInsensitive) == 0) {
+    return 22;
+  } else if (QString::compare(trimmedLine, "Failure", Qt::CaseInsensitive) == 0) {
+    return 23;
+  } else if (QString::compare(trimmedLine, "Complete", Qt::CaseInsensitive) == 0) {
+    return 24;
+  } else if (trimmedLine.startsWith("Applying", Qt::CaseInsensitive)) {
+    return 25;
+  } else if (trimmedLine.startsWith("Applied", Qt::CaseInsensitive)) {
+    return 26;
+  }
+  return 27;
+}
+
+// Roughly the mix of a --verbose run: mostly DEBUG / INFO noise, some plain EnergyPlus output, a few state transitions
+QList<QByteArray> sampleLines() {
+  return {
+    "[12:34:56.789 DEBUG] [openstudio.model.Model] <-2> Adding object OS:Surface to workspace",
+    "[12:34:56.790 INFO] [openstudio.measure.OSRunner] <-1> Setting wall R-value to 45",
+    "[12:34:56.791 DEBUG] [utilities.idf.WorkspaceObject] <-2> Setting field 3 of OS:Construction",
+    "[12:34:56.792 WARN] [openstudio.model.Surface] <0> Surface has no construction",
+    "   ** Warning ** GetSurfaceData: CAUTION -- Interzone surfaces are occuring in the same zone(s).",
+    "Starting state os_measures",
+    "Applying IncreaseWallRValue",
+    "Applied IncreaseWallRValue",
+    "Returned from state os_measures",
+    "Starting state simulation",
+    "EnergyPlus Starting",
+    "Continuing Simulation at 01/21 for RUN PERIOD 1",
+    "Returned from state simulation",
+    "Complete",
+  };
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const int iterations = argc > 1 ? std::atoi(argv[1]) : 200000;
+
+  const QList<QByteArray> lines = sampleLines();
+  const qint64 lineCount = static_cast<qint64>(iterations) * lines.size();
+
+  // Both sides start from the raw bytes the process hands us, so the legacy one pays for the UTF-16 conversion too
+  long long legacySink = 0;
+  QElapsedTimer timer;
+  timer.start();
+  for (int i = 0; i < iterations; ++i) {
+    for (const QByteArray& line : lines) {
+      legacySink += legacyClassify(QString::fromUtf8(line).trimmed());
+    }
+  }
+  const qint64 legacyNs = timer.nsecsElapsed();
+
+  long long compiledSink = 0;
+  timer.restart();
+  for (int i = 0; i < iterations; ++i) {
+    for (const QByteArray& line : lines) {
+      const LineClass lineClass = classifyLine(std::string_view(line.constData(), line.size()));
+      compiledSink += static_cast<int>(lineClass.level) + static_cast<int>(lineClass.event) + static_cast<int>(lineClass.state);
+    }
+  }
+  const qint64 compiledNs = timer.nsecsElapsed();
+
+  auto linesPerSecond = [lineCount](qint64 ns) { return ns > 0 ? static_cast<double>(lineCount) * 1e9 / static_cast<double>(ns) : 0.0; };
+
+  std::printf("%lld lines classified\n", static_cast<long long>(lineCount));
+  std::printf("  legacy chain:  %8.1f ms  %14.0f lines/s\n", legacyNs / 1e6, linesPerSecond(legacyNs));
+  std::printf("  classifyLine:  %8.1f ms  %14.0f lines/s\n", compiledNs / 1e6, linesPerSecond(compiledNs));
+  std::printf("  speedup:       %8.1fx\n", compiledNs > 0 ? static_cast<double>(legacyNs) / static_cast<double>(compiledNs) : 0.0);
+  std::printf("(checksums %lld / %lld)\n", legacySink, compiledSink);
+  return 0;
+}
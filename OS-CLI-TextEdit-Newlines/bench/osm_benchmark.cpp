@@ -0,0 +1,89 @@
+// Load time of OsmFile on the test seed model, and on a model made of copies of it, plus the cost of a handle lookup
+//
+// Usage: OsmBenchmark [copies] [path.osm]
+
+#include "../osmfile.hpp"
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QString>
+#include <QTemporaryFile>
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+// The model, copies times over. Each copy gets the first 8 hex digits of its handles replaced by the copy number, so
+// the handles stay unique and the references inside a copy still point at the right objects
+QByteArray scaledModel(const QByteArray& model, int copies) {
+  QByteArray result;
+  result.reserve(model.size() * copies);
+  for (int copy = 0; copy < copies; ++copy) {
+    QByteArray scaled = model;
+    const QByteArray prefix = QByteArray::number(copy, 16).rightJustified(8, '0');
+    for (qsizetype i = scaled.indexOf('{'); i >= 0 && i + 37 < scaled.size(); i = scaled.indexOf('{', i + 1)) {
+      if (scaled[i + 37] == '}' && scaled[i + 9] == '-') {
+        scaled.replace(i + 1, 8, prefix);
+      }
+    }
+    result += scaled;
+    result += '\n';
+  }
+  return result;
+}
+
+void report(const QString& path, int iterations) {
+  OsmFile osm;
+  QString error;
+  QElapsedTimer timer;
+  timer.start();
+  for (int i = 0; i < iterations; ++i) {
+    if (!osm.load(path, &error)) {
+      std::fprintf(stderr, "%s\n", qPrintable(error));
+      std::exit(1);
+    }
+  }
+  const qint64 loadNs = timer.nsecsElapsed() / iterations;
+
+  std::vector<QByteArray> handles;
+  for (int object = 0; object < osm.objectCount(); object += 7) {
+    handles.push_back(osm.handle(object).toByteArray());
+  }
+  constexpr int Lookups = 1000000;
+  long long sink = 0;
+  timer.restart();
+  for (int i = 0; i < Lookups; ++i) {
+    sink += osm.objectByHandle(handles[static_cast<size_t>(i) % handles.size()]);
+  }
+  const qint64 lookupNs = timer.nsecsElapsed();
+
+  std::printf("%s: %.1f MB, %d objects, %lld types, %zu OS:Surface\n", qPrintable(path), QFile(path).size() / 1e6, osm.objectCount(),
+              static_cast<long long>(osm.types().size()), osm.objectsOfType("OS:Surface").size());
+  std::printf("  load:    %10.3f ms\n", loadNs / 1e6);
+  std::printf("  lookup:  %10.1f ns per handle (checksum %lld)\n", static_cast<double>(lookupNs) / Lookups, sink);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const int copies = argc > 1 ? std::atoi(argv[1]) : 100;
+  const QString path = argc > 2 ? QString::fromLocal8Bit(argv[2]) : QStringLiteral(OSM_PATH);
+
+  report(path, 100);
+
+  QFile file(path);
+  if (copies <= 1 || !file.open(QIODevice::ReadOnly)) {
+    return 0;
+  }
+  QTemporaryFile scaled;
+  if (!scaled.open() || scaled.write(scaledModel(file.readAll(), copies)) < 0 || !scaled.flush()) {
+    std::fprintf(stderr, "Could not write the scaled model\n");
+    return 1;
+  }
+  std::printf("%d copies:\n", copies);
+  report(scaled.fileName(), 5);
+  return 0;
+}
@@ -0,0 +1,95 @@
+// Cold vs warm CLI startup: runs the same batch of workflows on fresh openstudio-standin processes, then on the warm
+// workers of a WorkerPool, the stand-in "loading" for --startup-delay ms like the real CLI loads Ruby and its gems.
+// Reports the wall time of the batch and the startup time the pool saved.
+//
+// Usage: WorkerPoolBenchmark [QtTest options], eg WorkerPoolBenchmark -platform offscreen
+
+#include "../jobscheduler.hpp"
+
+#include <QFile>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QTest>
+
+class WorkerPoolBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void batch_data();
+    void batch();
+
+private:
+    QTemporaryDir m_runLogDirectory;
+};
+
+void WorkerPoolBenchmark::initTestCase() {
+  // The JobSchedulers keep their measure schemas in the app data directory: not the user's one
+  QStandardPaths::setTestModeEnabled(true);
+  QVERIFY(QFile::exists(STANDIN_PATH));
+  QVERIFY(QFile::exists(WORKFLOW_PATH));
+  QVERIFY(m_runLogDirectory.isValid());
+}
+
+void WorkerPoolBenchmark::batch_data() {
+  QTest::addColumn<bool>("warm");
+  QTest::addColumn<int>("startupDelayMs");
+  QTest::addColumn<int>("jobs");
+  QTest::addColumn<int>("concurrency");
+
+  QTest::newRow("cold, 1 s startup") << false << 1000 << 8 << 2;
+  QTest::newRow("warm, 1 s startup") << true << 1000 << 8 << 2;
+  QTest::newRow("cold, 3 s startup") << false << 3000 << 8 << 4;
+  QTest::newRow("warm, 3 s startup") << true << 3000 << 8 << 4;
+}
+
+void WorkerPoolBenchmark::batch() {
+  QFETCH(bool, warm);
+  QFETCH(int, startupDelayMs);
+  QFETCH(int, jobs);
+  QFETCH(int, concurrency);
+
+  // Picked up by the cold processes and by the workers alike
+  qputenv("OPENSTUDIO_STANDIN_ARGS", QByteArray("--state-delay 0 --startup-delay ") + QByteArray::number(startupDelayMs));
+
+  JobScheduler scheduler;
+  scheduler.setProgram(STANDIN_PATH);
+  scheduler.setRunLogDirectory(m_runLogDirectory.path());
+  scheduler.setMaxConcurrentJobs(concurrency);
+  QSignalSpy finished(&scheduler, &JobScheduler::allJobsFinished);
+
+  if (warm) {
+    scheduler.setWorkerProgram(STANDIN_PATH);
+    // The GUI starts the pool with the window, long before the first Run: don't count the warm up
+    for (int i = 0; i < concurrency; ++i) {
+      scheduler.addJob(WORKFLOW_PATH);
+    }
+    scheduler.start();
+    QVERIFY(finished.wait(60 * 1000));
+    scheduler.clearFinishedJobs();
+    finished.clear();
+  }
+
+  for (int i = 0; i < jobs; ++i) {
+    scheduler.addJob(WORKFLOW_PATH);
+  }
+
+  qint64 wallMs = 0;
+  QBENCHMARK_ONCE {
+    scheduler.start();
+    QVERIFY(finished.wait(10 * 60 * 1000));
+    wallMs = finished.first().first().toLongLong();
+  }
+
+  for (int row = 0; row < scheduler.rowCount(); ++row) {
+    QCOMPARE(scheduler.jobStatus(row), JobScheduler::JobStatus::Succeeded);
+  }
+  qInfo("%d jobs in %lld ms (%.0f ms per job), %lld ms of CLI startup saved", jobs, wallMs, static_cast<double>(wallMs) / jobs,
+        scheduler.startupSavedMs());
+}
+
+QTEST_MAIN(WorkerPoolBenchmark)
+
+#include "workerpool_benchmark.moc"
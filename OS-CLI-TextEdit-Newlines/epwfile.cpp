@@ -0,0 +1,335 @@
+#include "epwfile.hpp"
+#include "lineframer.hpp"
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QFile>
+#include <QObject>
+#include <QtAlgorithms>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+static constexpr float NaN = std::numeric_limits<float>::quiet_NaN();
+static constexpr int MonthCount = 12;
+// Depth, conductivity, density, specific heat, then the months
+static constexpr int GroundTemperatureFieldCount = 4 + MonthCount;
+// Name, start day of week, start date, end date
+static constexpr int DataPeriodFieldCount = 4;
+
+// Exact powers of ten as doubles, up to what a double holds exactly
+static constexpr double Pow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+static bool isDigit(char c) {
+  return static_cast<unsigned char>(c - '0') < 10;
+}
+
+// The bytes of word that are c (repeated 8 times in pattern) get their high bit set, the others are 0.
+// Exact, unlike the usual (x - 0x01...) & ~x which can flag the byte after a match
+static quint64 matchBytes(quint64 word, quint64 pattern) {
+  constexpr quint64 Low7 = 0x7F7F7F7F7F7F7F7FULL;
+  const quint64 x = word ^ pattern;
+  return ~(((x & Low7) + Low7) | x | Low7);
+}
+
+// Positions of the commas in [begin, end), up to maxCount of them. Looks at 8 bytes at a time: an EPW row has a comma
+// every 4 bytes or so, far too often for memchr's setup to pay off
+static int findCommas(const char* begin, const char* end, const char** commas, int maxCount) {
+  constexpr quint64 CommaPattern = 0x2C2C2C2C2C2C2C2CULL;
+  int count = 0;
+  const char* p = begin;
+  for (; end - p >= 8 && count < maxCount; p += 8) {
+    quint64 word;
+    std::memcpy(&word, p, sizeof(word));
+    // First byte in the lowest bits whatever the platform, so the matches come out in order
+    quint64 mask = matchBytes(qFromLittleEndian(word), CommaPattern);
+    while (mask != 0 && count < maxCount) {
+      commas[count++] = p + qCountTrailingZeroBits(mask) / 8;
+      mask &= mask - 1;
+    }
+  }
+  for (; p < end && count < maxCount; ++p) {
+    if (*p == ',') {
+      commas[count++] = p;
+    }
+  }
+  return count;
+}
+
+// EPW numbers are plain decimals ("-10.2", "999900", "0.0000"), parsed in place: strtod would need a terminated copy,
+// and goes through the locale. NaN for an empty field or anything that isn't a number
+static double parseNumber(const char* p, const char* end) {
+  while (p < end && *p == ' ') {
+    ++p;
+  }
+  while (end > p && (end[-1] == ' ' || end[-1] == '\r')) {
+    --end;
+  }
+  if (p == end) {
+    return NaN;
+  }
+
+  const bool negative = (*p == '-');
+  if (*p == '-' || *p == '+') {
+    ++p;
+  }
+  // Past 18 digits the rest can't change a float
+  constexpr quint64 MaxMantissa = 100000000000000000ULL;
+  quint64 mantissa = 0;
+  int exponent = 0;
+  bool hasDigits = false;
+  for (; p < end && isDigit(*p); ++p) {
+    hasDigits = true;
+    if (mantissa < MaxMantissa) {
+      mantissa = mantissa * 10 + static_cast<quint64>(*p - '0');
+    } else {
+      ++exponent;
+    }
+  }
+  if (p < end && *p == '.') {
+    ++p;
+    for (; p < end && isDigit(*p); ++p) {
+      hasDigits = true;
+      if (mantissa < MaxMantissa) {
+        mantissa = mantissa * 10 + static_cast<quint64>(*p - '0');
+        --exponent;
+      }
+    }
+  }
+  if (!hasDigits) {
+    return NaN;
+  }
+  if (p < end && (*p == 'e' || *p == 'E')) {
+    ++p;
+    const bool negativeExponent = (p < end && *p == '-');
+    if (p < end && (*p == '-' || *p == '+')) {
+      ++p;
+    }
+    if (p == end) {
+      return NaN;
+    }
+    int value = 0;
+    for (; p < end && isDigit(*p); ++p) {
+      value = std::min(value * 10 + (*p - '0'), 1000);
+    }
+    exponent += negativeExponent ? -value : value;
+  }
+  if (p != end) {
+    return NaN;
+  }
+
+  double value = static_cast<double>(mantissa);
+  if (exponent < 0 && exponent >= -22) {
+    value /= Pow10[-exponent];
+  } else if (exponent > 0 && exponent <= 22) {
+    value *= Pow10[exponent];
+  } else if (exponent != 0) {
+    value *= std::pow(10.0, exponent);
+  }
+  return negative ? -value : value;
+}
+
+static double parseNumber(QByteArrayView field) {
+  return parseNumber(field.data(), field.data() + field.size());
+}
+
+// Header lines are few and short, they're simply split
+static std::vector<QByteArrayView> splitFields(QByteArrayView line) {
+  std::vector<const char*> commas(static_cast<size_t>(line.size()));
+  const int commaCount = findCommas(line.data(), line.data() + line.size(), commas.data(), static_cast<int>(commas.size()));
+  std::vector<QByteArrayView> fields;
+  fields.reserve(static_cast<size_t>(commaCount) + 1);
+  const char* begin = line.data();
+  for (int i = 0; i < commaCount; ++i) {
+    fields.emplace_back(begin, commas[i] - begin);
+    begin = commas[i] + 1;
+  }
+  fields.emplace_back(begin, line.data() + line.size() - begin);
+  return fields;
+}
+
+static QByteArrayView fieldAt(const std::vector<QByteArrayView>& fields, size_t index) {
+  return index < fields.size() ? trimmedView(fields[index]) : QByteArrayView();
+}
+
+static QString textAt(const std::vector<QByteArrayView>& fields, size_t index) {
+  return QString::fromUtf8(fieldAt(fields, index));
+}
+
+static void parseDesignConditions(const std::vector<QByteArrayView>& fields, std::vector<EpwFile::DesignCondition>& conditions) {
+  // After the count: a source, then values after each of the Heating / Cooling / Extremes keywords, for each set
+  std::vector<float>* section = nullptr;
+  for (size_t i = 2; i < fields.size(); ++i) {
+    const QByteArrayView field = trimmedView(fields[i]);
+    if (!conditions.empty() && field == QByteArrayView("Heating")) {
+      section = &conditions.back().heating;
+    } else if (!conditions.empty() && field == QByteArrayView("Cooling")) {
+      section = &conditions.back().cooling;
+    } else if (!conditions.empty() && field == QByteArrayView("Extremes")) {
+      section = &conditions.back().extremes;
+    } else {
+      const double value = parseNumber(field);
+      if (std::isnan(value) && !field.isEmpty()) {
+        conditions.push_back(EpwFile::DesignCondition{QString::fromUtf8(field), {}, {}, {}});
+        section = nullptr;
+      } else if (section) {
+        section->push_back(static_cast<float>(value));
+      }
+    }
+  }
+}
+
+static void parseHeader(QByteArrayView line, EpwFile& epw) {
+  const std::vector<QByteArrayView> fields = splitFields(line);
+  const QByteArrayView keyword = fieldAt(fields, 0);
+  auto numberAt = [&fields](size_t index) { return parseNumber(fieldAt(fields, index)); };
+
+  if (keyword == QByteArrayView("LOCATION")) {
+    epw.location.city = textAt(fields, 1);
+    epw.location.stateProvince = textAt(fields, 2);
+    epw.location.country = textAt(fields, 3);
+    epw.location.dataSource = textAt(fields, 4);
+    epw.location.wmoNumber = textAt(fields, 5);
+    epw.location.latitude = numberAt(6);
+    epw.location.longitude = numberAt(7);
+    epw.location.timeZone = numberAt(8);
+    epw.location.elevation = numberAt(9);
+  } else if (keyword == QByteArrayView("DESIGN CONDITIONS")) {
+    parseDesignConditions(fields, epw.designConditions);
+  } else if (keyword == QByteArrayView("GROUND TEMPERATURES")) {
+    const double count = numberAt(1);
+    for (int depth = 0; depth < count; ++depth) {
+      const size_t first = 2 + static_cast<size_t>(depth) * GroundTemperatureFieldCount;
+      if (first + GroundTemperatureFieldCount > fields.size()) {
+        break;
+      }
+      EpwFile::GroundTemperature temperature;
+      temperature.depth = static_cast<float>(numberAt(first));
+      temperature.conductivity = static_cast<float>(numberAt(first + 1));
+      temperature.density = static_cast<float>(numberAt(first + 2));
+      temperature.specificHeat = static_cast<float>(numberAt(first + 3));
+      for (int month = 0; month < MonthCount; ++month) {
+        temperature.monthly[static_cast<size_t>(month)] = static_cast<float>(numberAt(first + 4 + static_cast<size_t>(month)));
+      }
+      epw.groundTemperatures.push_back(temperature);
+    }
+  } else if (keyword == QByteArrayView("DATA PERIODS")) {
+    const double count = numberAt(1);
+    const double recordsPerHour = numberAt(2);
+    epw.recordsPerHour = recordsPerHour >= 1 ? static_cast<int>(recordsPerHour) : 1;
+    for (int period = 0; period < count; ++period) {
+      const size_t first = 3 + static_cast<size_t>(period) * DataPeriodFieldCount;
+      if (first + DataPeriodFieldCount > fields.size()) {
+        break;
+      }
+      epw.dataPeriods.push_back(EpwFile::DataPeriod{textAt(fields, first), textAt(fields, first + 1), textAt(fields, first + 2), textAt(fields, first + 3)});
+    }
+  } else if (keyword.startsWith(QByteArrayView("COMMENTS"))) {
+    const QByteArrayView text = fields.size() > 1 ? line.sliced(fields[1].data() - line.data()) : QByteArrayView();
+    epw.comments << QString::fromUtf8(trimmedView(text));
+  }
+}
+
+bool EpwFile::load(const QString& filePath, QString* error) {
+  *this = EpwFile();
+  path = filePath;
+  auto fail = [error](const QString& message) {
+    if (error) {
+      *error = message;
+    }
+    return false;
+  };
+
+  QFile file(filePath);
+  if (!file.open(QIODevice::ReadOnly)) {
+    return fail(QObject::tr("Cannot open %1").arg(filePath));
+  }
+  // Mapped rather than read: the rows are parsed straight from the page cache
+  QByteArrayView content;
+  QByteArray readContent;
+  if (const uchar* mapped = file.size() > 0 ? file.map(0, file.size()) : nullptr) {
+    content = QByteArrayView(reinterpret_cast<const char*>(mapped), file.size());
+  } else {
+    readContent = file.readAll();
+    content = readContent;
+  }
+
+  const char* p = content.data();
+  const char* const end = p + content.size();
+  int lineNumber = 0;
+  bool hasLocation = false;
+  qsizetype capacity = 0;
+  const char* commas[FieldCount - 1];
+  while (p < end) {
+    const auto* newline = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+    const char* lineEnd = newline ? newline : end;
+    const char* const next = newline ? newline + 1 : end;
+    if (lineEnd != p && lineEnd[-1] == '\r') {
+      --lineEnd;
+    }
+    ++lineNumber;
+
+    if (capacity == 0) {
+      if (p == lineEnd || !isDigit(*p)) {
+        const QByteArrayView line(p, lineEnd - p);
+        hasLocation = hasLocation || line.startsWith(QByteArrayView("LOCATION"));
+        parseHeader(line, *this);
+        p = next;
+        continue;
+      }
+      if (!hasLocation) {
+        return fail(QObject::tr("%1 is not an EPW file: no LOCATION header").arg(filePath));
+      }
+      // One row per line from here on: the columns can be laid out once and for all
+      capacity = 1;
+      for (const char* q = p; (q = static_cast<const char*>(std::memchr(q, '\n', static_cast<size_t>(end - q)))) != nullptr; ++q) {
+        ++capacity;
+      }
+      values.resize(static_cast<size_t>(FieldCount * capacity));
+    }
+
+    if (p == lineEnd) {
+      p = next;
+      continue;
+    }
+    const int commaCount = findCommas(p, lineEnd, commas, FieldCount - 1);
+    if (commaCount < FieldCount - 1) {
+      return fail(QObject::tr("%1, line %2: %3 fields, an EPW data row has %4").arg(filePath).arg(lineNumber).arg(commaCount + 1).arg(int(FieldCount)));
+    }
+    float* const row = values.data() + rowCount;
+    const char* fieldBegin = p;
+    for (int field = 0; field < FieldCount; ++field) {
+      const char* fieldEnd = lineEnd;
+      if (field < FieldCount - 1) {
+        fieldEnd = commas[field];
+      } else if (const auto* extra = static_cast<const char*>(std::memchr(fieldBegin, ',', static_cast<size_t>(lineEnd - fieldBegin)))) {
+        // Anything past the last field is left alone
+        fieldEnd = extra;
+      }
+      row[field * capacity] = (field == DataSource) ? NaN : static_cast<float>(parseNumber(fieldBegin, fieldEnd));
+      fieldBegin = fieldEnd + 1;
+    }
+    ++rowCount;
+    p = next;
+  }
+
+  if (!hasLocation) {
+    return fail(QObject::tr("%1 is not an EPW file: no LOCATION header").arg(filePath));
+  }
+  // Blank lines were counted in, close the gaps between the columns
+  if (rowCount < capacity) {
+    for (int field = 1; field < FieldCount; ++field) {
+      std::copy_n(values.begin() + field * capacity, rowCount, values.begin() + field * rowCount);
+    }
+    values.resize(static_cast<size_t>(FieldCount * rowCount));
+  }
+  return true;
+}
+
+const float* EpwFile::column(Field field) const {
+  return values.data() + field * rowCount;
+}
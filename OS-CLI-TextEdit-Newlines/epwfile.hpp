@@ -0,0 +1,121 @@
+#ifndef EPWFILE_HPP
+#define EPWFILE_HPP
+
+#include <QString>
+#include <QStringList>
+
+#include <array>
+#include <vector>
+
+// An EPW weather file: its header blocks, and its hourly data as one float array per field.
+// Read through a memory map in a single pass: rows are cut with memchr, fields with a scan for commas 8 bytes at a
+// time, and numbers parsed in place, without ever copying a line or decoding it to UTF-16. A whole year takes well
+// under a millisecond (see EpwBenchmark).
+struct EpwFile
+{
+  // The fields of a data row, in file order
+  enum Field
+  {
+    Year,
+    Month,
+    Day,
+    Hour,
+    Minute,
+    // Flags such as "?9?9?9?9E0...", not a number: always NaN
+    DataSource,
+    DryBulbTemperature,
+    DewPointTemperature,
+    RelativeHumidity,
+    AtmosphericStationPressure,
+    ExtraterrestrialHorizontalRadiation,
+    ExtraterrestrialDirectNormalRadiation,
+    HorizontalInfraredRadiationIntensity,
+    GlobalHorizontalRadiation,
+    DirectNormalRadiation,
+    DiffuseHorizontalRadiation,
+    GlobalHorizontalIlluminance,
+    DirectNormalIlluminance,
+    DiffuseHorizontalIlluminance,
+    ZenithLuminance,
+    WindDirection,
+    WindSpeed,
+    TotalSkyCover,
+    OpaqueSkyCover,
+    Visibility,
+    CeilingHeight,
+    PresentWeatherObservation,
+    PresentWeatherCodes,
+    PrecipitableWater,
+    AerosolOpticalDepth,
+    SnowDepth,
+    DaysSinceLastSnowfall,
+    Albedo,
+    LiquidPrecipitationDepth,
+    LiquidPrecipitationQuantity,
+    FieldCount
+  };
+
+  struct Location
+  {
+    QString city;
+    QString stateProvince;
+    QString country;
+    QString dataSource;
+    QString wmoNumber;
+    double latitude = 0.0;
+    double longitude = 0.0;
+    // Hours from GMT
+    double timeZone = 0.0;
+    // m
+    double elevation = 0.0;
+  };
+
+  // One set of the DESIGN CONDITIONS line, values as they come after each keyword
+  struct DesignCondition
+  {
+    QString source;
+    std::vector<float> heating;
+    std::vector<float> cooling;
+    std::vector<float> extremes;
+  };
+
+  // NaN for the soil properties that aren't given
+  struct GroundTemperature
+  {
+    float depth = 0.0f;
+    float conductivity = 0.0f;
+    float density = 0.0f;
+    float specificHeat = 0.0f;
+    std::array<float, 12> monthly{};
+  };
+
+  struct DataPeriod
+  {
+    QString name;
+    QString startDayOfWeek;
+    // As written, eg " 1/ 1"
+    QString startDate;
+    QString endDate;
+  };
+
+  QString path;
+  Location location;
+  std::vector<DesignCondition> designConditions;
+  std::vector<GroundTemperature> groundTemperatures;
+  int recordsPerHour = 1;
+  std::vector<DataPeriod> dataPeriods;
+  // COMMENTS 1 and 2
+  QStringList comments;
+
+  // Column major: FieldCount columns of rowCount values. NaN where a field is empty
+  std::vector<float> values;
+  qsizetype rowCount = 0;
+
+  // False if the file can't be read or isn't an EPW, with the reason in error
+  bool load(const QString& path, QString* error = nullptr);
+
+  // rowCount values
+  const float* column(Field field) const;
+};
+
+#endif // EPWFILE_HPP
@@ -0,0 +1,123 @@
+#include "filehashcache.hpp"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <algorithm>
+
+FileHashCache::FileHashCache(const QString& path)
+    : m_path(path)
+{
+    load();
+}
+
+FileHashCache::~FileHashCache()
+{
+    save();
+}
+
+QByteArray FileHashCache::fileHash(const QString& path) {
+  QMutexLocker locker(&m_mutex);
+  return fileHashLocked(path);
+}
+
+QByteArray FileHashCache::measureHash(const QString& measureDir) {
+  const QDir dir(measureDir);
+  QStringList paths;
+  for (const QString& name : {QStringLiteral("measure.rb"), QStringLiteral("measure.xml")}) {
+    if (dir.exists(name)) {
+      paths << dir.filePath(name);
+    }
+  }
+  QDirIterator it(dir.filePath("resources"), QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+  while (it.hasNext()) {
+    paths << it.next();
+  }
+  // Directory listings come in no particular order
+  std::sort(paths.begin(), paths.end());
+
+  QCryptographicHash hash(QCryptographicHash::Sha256);
+  QMutexLocker locker(&m_mutex);
+  for (const QString& path : paths) {
+    hash.addData(dir.relativeFilePath(path).toUtf8());
+    hash.addData(QByteArrayView("\0", 1));
+    hash.addData(fileHashLocked(path));
+    hash.addData(QByteArrayView("\n"));
+  }
+  return hash.result().toHex();
+}
+
+QByteArray FileHashCache::programHash(const QString& program) {
+  const QString programPath = QDir::isAbsolutePath(program) ? program : QStandardPaths::findExecutable(program);
+  const QFileInfo programInfo(programPath);
+  return programPath.toUtf8() + ' ' + QByteArray::number(programInfo.size()) + ' ' + QByteArray::number(programInfo.lastModified().toMSecsSinceEpoch());
+}
+
+QByteArray FileHashCache::fileHashLocked(const QString& path) {
+  const QFileInfo info(path);
+  if (!info.isFile()) {
+    return QByteArray();
+  }
+  const QString absolutePath = info.absoluteFilePath();
+  const qint64 modifiedMs = info.lastModified().toMSecsSinceEpoch();
+  auto it = m_fileHashes.find(absolutePath);
+  if (it != m_fileHashes.end() && it->size == info.size() && it->modifiedMs == modifiedMs) {
+    return it->hash;
+  }
+
+  QFile file(absolutePath);
+  QCryptographicHash hash(QCryptographicHash::Sha256);
+  if (!file.open(QIODevice::ReadOnly) || !hash.addData(&file)) {
+    return QByteArray();
+  }
+  const QByteArray result = hash.result().toHex();
+  m_fileHashes.insert(absolutePath, FileHash{info.size(), modifiedMs, result});
+  m_changed = true;
+  return result;
+}
+
+void FileHashCache::load() {
+  QFile file(m_path);
+  if (!file.open(QIODevice::ReadOnly)) {
+    return;
+  }
+  const QJsonObject files = QJsonDocument::fromJson(file.readAll()).object().value("files").toObject();
+  for (auto it = files.begin(); it != files.end(); ++it) {
+    const QJsonObject object = it.value().toObject();
+    m_fileHashes.insert(it.key(), FileHash{object.value("size").toInteger(-1), object.value("mtime_ms").toInteger(-1),
+                                           object.value("sha256").toString().toLatin1()});
+  }
+}
+
+void FileHashCache::save() {
+  QMutexLocker locker(&m_mutex);
+  if (!m_changed) {
+    return;
+  }
+  QJsonObject files;
+  for (auto it = m_fileHashes.cbegin(); it != m_fileHashes.cend(); ++it) {
+    QJsonObject object;
+    object["size"] = it->size;
+    object["mtime_ms"] = it->modifiedMs;
+    object["sha256"] = QString::fromLatin1(it->hash);
+    files[it.key()] = object;
+  }
+  QJsonObject root;
+  root["version"] = 1;
+  root["files"] = files;
+
+  QDir().mkpath(QFileInfo(m_path).absolutePath());
+  QSaveFile file(m_path);
+  if (file.open(QIODevice::WriteOnly) && file.write(QJsonDocument(root).toJson(QJsonDocument::Compact)) >= 0 && file.commit()) {
+    m_changed = false;
+  }
+}
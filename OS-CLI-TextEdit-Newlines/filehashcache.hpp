@@ -0,0 +1,48 @@
+#ifndef FILEHASHCACHE_HPP
+#define FILEHASHCACHE_HPP
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+// Hex SHA-256 of the content of workflow inputs, remembered along with the file's size and mtime: a file only gets read
+// again once one of them changes, like make does. Kept in a JSON file across sessions.
+// Shared by the WorkflowResultCache and the WorkflowCheckpoints of all the jobs: every method is thread safe.
+class FileHashCache
+{
+public:
+    explicit FileHashCache(const QString& path);
+    ~FileHashCache();
+
+    FileHashCache(const FileHashCache&) = delete;
+    FileHashCache& operator=(const FileHashCache&) = delete;
+
+    // Empty if it isn't a readable file
+    QByteArray fileHash(const QString& path);
+    // measure.rb, measure.xml and everything under resources/: what the CLI runs. tests/ and docs/ are left out
+    QByteArray measureHash(const QString& measureDir);
+    // The CLI binary, by path, size and mtime only: it can be big, and a new one might not give the same results
+    static QByteArray programHash(const QString& program);
+
+    // Writes the hashes computed since the last time
+    void save();
+
+private:
+    struct FileHash
+    {
+      qint64 size = -1;
+      qint64 modifiedMs = -1;
+      QByteArray hash;
+    };
+
+    QByteArray fileHashLocked(const QString& path);
+    void load();
+
+    QString m_path;
+    QMutex m_mutex;
+    QHash<QString, FileHash> m_fileHashes;
+    bool m_changed = false;
+};
+
+#endif // FILEHASHCACHE_HPP
@@ -0,0 +1,641 @@
+#include "jobscheduler.hpp"
+#include "filehashcache.hpp"
+#include "measurelibrary.hpp"
+#include "resultcache.hpp"
+#include "runworker.hpp"
+#include "workerpool.hpp"
+#include "workflowcheckpoints.hpp"
+
+#include <QFile>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QLocale>
+#include <QSet>
+#include <QStandardPaths>
+#include <QThread>
+#include <QTimer>
+
+#if defined(Q_OS_MACOS)
+#  include <sys/sysctl.h>
+#endif
+
+#include <algorithm>
+#include <limits>
+
+static constexpr int LogDrainIntervalMs = 16;
+// Shared by all the jobs, so N busy jobs don't cost N times the layout work in a single frame
+static constexpr size_t MaxLogLinesPerFrame = 20000;
+static const QString PhaseHistoryFileName = QStringLiteral("phase_durations.json");
+static const QString FileHashesFileName = QStringLiteral("file_hashes.json");
+static const QString MeasureSchemasFileName = QStringLiteral("measure_schemas.json");
+
+int physicalCoreCount() {
+  static const int count = []() {
+    int cores = 0;
+#if defined(Q_OS_LINUX)
+    // One "physical id" / "core id" pair per physical core, the hyperthreads share it
+    QFile cpuinfo("/proc/cpuinfo");
+    if (cpuinfo.open(QIODevice::ReadOnly | QIODevice::Text)) {
+      QSet<QByteArray> uniqueCores;
+      QByteArray physicalId;
+      for (const QByteArray& line : cpuinfo.readAll().split('\n')) {
+        const int colon = line.indexOf(':');
+        if (colon < 0) {
+          continue;
+        }
+        const QByteArray key = line.left(colon).trimmed();
+        if (key == "physical id") {
+          physicalId = line.mid(colon + 1).trimmed();
+        } else if (key == "core id") {
+          uniqueCores.insert(physicalId + ':' + line.mid(colon + 1).trimmed());
+        }
+      }
+      cores = uniqueCores.size();
+    }
+#elif defined(Q_OS_MACOS)
+    int value = 0;
+    size_t size = sizeof(value);
+    if (sysctlbyname("hw.physicalcpu", &value, &size, nullptr, 0) == 0) {
+      cores = value;
+    }
+#endif
+    return cores > 0 ? cores : std::max(1, QThread::idealThreadCount());
+  }();
+  return count;
+}
+
+static QString jobStatusText(JobScheduler::JobStatus status) {
+  switch (status) {
+    case JobScheduler::JobStatus::Queued:
+      return QObject::tr("Queued");
+    case JobScheduler::JobStatus::Running:
+      return QObject::tr("Running");
+    case JobScheduler::JobStatus::Succeeded:
+      return QObject::tr("Succeeded");
+    case JobScheduler::JobStatus::Cached:
+      return QObject::tr("Cached");
+    case JobScheduler::JobStatus::Failed:
+      return QObject::tr("Failed");
+    case JobScheduler::JobStatus::Invalid:
+      return QObject::tr("Invalid");
+    case JobScheduler::JobStatus::Aborted:
+      return QObject::tr("Aborted");
+  }
+  return QString();
+}
+
+static QColor jobStatusColor(JobScheduler::JobStatus status) {
+  switch (status) {
+    case JobScheduler::JobStatus::Running:
+      return Qt::darkBlue;
+    case JobScheduler::JobStatus::Succeeded:
+      return Qt::darkGreen;
+    case JobScheduler::JobStatus::Cached:
+      return Qt::darkCyan;
+    case JobScheduler::JobStatus::Failed:
+    case JobScheduler::JobStatus::Invalid:
+    case JobScheduler::JobStatus::Aborted:
+      return Qt::darkRed;
+    case JobScheduler::JobStatus::Queued:
+      break;
+  }
+  return Qt::gray;
+}
+
+JobScheduler::JobScheduler(QObject *parent)
+    : QAbstractTableModel(parent),
+      m_runLogDirectory(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/runs"),
+      m_maxConcurrentJobs(physicalCoreCount())
+{
+    m_drainTimer = new QTimer(this);
+    m_drainTimer->setSingleShot(true);
+    m_drainTimer->setTimerType(Qt::PreciseTimer);
+    m_drainTimer->setInterval(LogDrainIntervalMs);
+    connect(m_drainTimer, &QTimer::timeout, this, &JobScheduler::drainLogs);
+
+    m_phaseHistory.load(phaseHistoryPath());
+    m_measureLibrary = std::make_unique<MeasureLibrary>(QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)).filePath(MeasureSchemasFileName));
+
+    m_workerPool = new WorkerPool(this);
+    connect(m_workerPool, &WorkerPool::workerIdle, this, [this]() {
+        if (m_waitingForWorker) {
+            startQueuedJobs();
+        }
+    });
+    connect(m_workerPool, &WorkerPool::jobFinished, this, &JobScheduler::onPoolJobFinished);
+    connect(m_workerPool, &WorkerPool::jobAborted, this,
+            [this](int /*workerId*/, qint64 latencyMs, bool forced, bool complete) { onProcessTreeStopped(latencyMs, forced, complete); });
+}
+
+JobScheduler::~JobScheduler()
+{
+    // Workers kill their process when they get deleted, which happens when their thread finishes. That includes the
+    // threads of finished and aborted jobs that haven't stopped yet: their workers may still be using the caches
+    const std::vector<QThread*> threads = m_threads;
+    for (QThread* thread : threads) {
+        thread->quit();
+        thread->wait();
+    }
+}
+
+int JobScheduler::rowCount(const QModelIndex& parent) const {
+  return parent.isValid() ? 0 : static_cast<int>(m_jobs.size());
+}
+
+int JobScheduler::columnCount(const QModelIndex& parent) const {
+  return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant JobScheduler::data(const QModelIndex& index, int role) const {
+  if (!index.isValid() || index.row() >= rowCount()) {
+    return QVariant();
+  }
+  const Job& job = *m_jobs[index.row()];
+
+  if (role == Qt::DisplayRole) {
+    switch (index.column()) {
+      case WorkflowColumn:
+        return QFileInfo(job.workflowJSONPath).fileName();
+      case StatusColumn:
+        return job.resumeStep > 0 ? tr("%1, resumed").arg(jobStatusText(job.status)) : jobStatusText(job.status);
+      case LinesColumn:
+        return job.lineCount;
+      case SuppressedColumn:
+        return job.suppressedLineCount > 0 ? QVariant(job.suppressedLineCount) : QVariant();
+      case TimeColumn: {
+        qint64 elapsedMs = job.elapsedMs;
+        if (job.status == JobStatus::Running) {
+          elapsedMs = job.timer.elapsed();
+        }
+        return elapsedMs < 0 ? QString() : QString::number(elapsedMs / 1000.0, 'f', 1) + " s";
+      }
+    }
+  } else if (role == Qt::ToolTipRole && index.column() == WorkflowColumn) {
+    return job.workflowJSONPath;
+  } else if (role == Qt::ToolTipRole && index.column() == StatusColumn && job.status == JobStatus::Cached) {
+    return tr("Restored from the result cache: identical to the run of %1, which took %2 s")
+      .arg(QLocale().toString(job.cachedRunCreatedAt, QLocale::ShortFormat))
+      .arg(job.cachedRunElapsedMs / 1000.0, 0, 'f', 1);
+  } else if (role == Qt::ToolTipRole && index.column() == StatusColumn && job.status == JobStatus::Invalid) {
+    return tr("Not run: %n problem(s) the CLI would fail on, see the log", nullptr, job.preflightErrorCount);
+  } else if (role == Qt::ToolTipRole && index.column() == StatusColumn && job.resumeStep > 0) {
+    return tr("Resumed from a checkpoint: the first %1 steps were the same as in an earlier run, and were skipped").arg(job.resumeStep);
+  } else if (role == Qt::ToolTipRole && index.column() == TimeColumn && job.startupSavedMs > 0) {
+    return tr("Ran on a warm worker, %1 s of CLI startup saved").arg(job.startupSavedMs / 1000.0, 0, 'f', 1);
+  } else if (role == Qt::ToolTipRole && index.column() == SuppressedColumn) {
+    return tr("DEBUG / INFO lines left out of the live log while it caught up with the run, the run log has all of them");
+  } else if (role == Qt::ForegroundRole && index.column() == StatusColumn) {
+    return jobStatusColor(job.status);
+  } else if (role == Qt::ForegroundRole && index.column() == SuppressedColumn) {
+    return logStyleColor(LogStyle::Suppressed);
+  } else if (role == Qt::TextAlignmentRole && (index.column() == LinesColumn || index.column() == SuppressedColumn || index.column() == TimeColumn)) {
+    return QVariant(Qt::AlignRight | Qt::AlignVCenter);
+  }
+  return QVariant();
+}
+
+QVariant JobScheduler::headerData(int section, Qt::Orientation orientation, int role) const {
+  if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+    return QAbstractTableModel::headerData(section, orientation, role);
+  }
+  switch (section) {
+    case WorkflowColumn:
+      return tr("Workflow");
+    case StatusColumn:
+      return tr("Status");
+    case LinesColumn:
+      return tr("Lines");
+    case SuppressedColumn:
+      return tr("Suppressed");
+    case TimeColumn:
+      return tr("Time");
+  }
+  return QVariant();
+}
+
+void JobScheduler::setProgram(const QString& program) {
+  m_program = program;
+}
+
+void JobScheduler::setWorkerProgram(const QString& program, const QStringList& arguments) {
+  m_workerPool->setSize(program.isEmpty() ? 0 : m_maxConcurrentJobs);
+  m_workerPool->setProgram(program, arguments);
+}
+
+QString JobScheduler::runLogDirectory() const {
+  return m_runLogDirectory;
+}
+
+void JobScheduler::setRunLogDirectory(const QString& runLogDirectory) {
+  m_runLogDirectory = runLogDirectory;
+  m_phaseHistory.load(phaseHistoryPath());
+  emit phaseHistoryChanged();
+}
+
+QString JobScheduler::cacheDirectory() const {
+  return m_cacheDirectory;
+}
+
+void JobScheduler::setCacheDirectory(const QString& cacheDirectory) {
+  // Running jobs hold on to the caches, and so do the workers of aborted ones until they're stopped
+  if (m_runningJobs > 0 || m_pendingCancels > 0 || cacheDirectory == m_cacheDirectory) {
+    return;
+  }
+  m_cacheDirectory = cacheDirectory;
+  m_resultCache.reset();
+  m_checkpoints.reset();
+  m_fileHashes.reset();
+  if (m_cacheDirectory.isEmpty()) {
+    return;
+  }
+  const QDir dir(m_cacheDirectory);
+  m_fileHashes = std::make_unique<FileHashCache>(dir.filePath(FileHashesFileName));
+  m_resultCache = std::make_unique<WorkflowResultCache>(dir.filePath("results"), m_fileHashes.get());
+  m_checkpoints = std::make_unique<WorkflowCheckpoints>(dir.filePath("checkpoints"), m_fileHashes.get(), m_measureLibrary.get());
+}
+
+int JobScheduler::maxConcurrentJobs() const {
+  return m_maxConcurrentJobs;
+}
+
+void JobScheduler::setMaxConcurrentJobs(int maxConcurrentJobs) {
+  m_maxConcurrentJobs = std::max(1, maxConcurrentJobs);
+  if (m_workerPool->isEnabled()) {
+    m_workerPool->setSize(m_maxConcurrentJobs);
+  }
+  // Raising it mid-run picks up more of the queue right away, lowering it just lets the extra jobs finish
+  if (m_runningJobs > 0) {
+    startQueuedJobs();
+  }
+}
+
+int JobScheduler::addJob(const QString& workflowJSONPath) {
+  const int row = rowCount();
+  beginInsertRows(QModelIndex(), row, row);
+  auto job = std::make_unique<Job>();
+  job->workflowJSONPath = workflowJSONPath;
+  job->logModel = new RunLogModel(RunLogModel::DefaultCapacity, this);
+  m_jobs.push_back(std::move(job));
+  endInsertRows();
+  return row;
+}
+
+void JobScheduler::start() {
+  if (m_runningJobs == 0) {
+    m_wallTimer.start();
+    m_startupSavedMs = 0;
+  }
+  startQueuedJobs();
+}
+
+void JobScheduler::abortAll() {
+  // Workers given back by the aborted jobs mustn't start the ones still queued
+  m_waitingForWorker = false;
+  if (m_pendingCancels == 0) {
+    m_cancelTimer.start();
+    m_cancelledJobs = 0;
+    m_coresReturned = 0;
+    m_forcedCancels = 0;
+  }
+  for (auto& job : m_jobs) {
+    if (job->status == JobStatus::Queued) {
+      finishJob(*job, JobStatus::Aborted);
+    } else if (job->status == JobStatus::Running) {
+      // Keep what already made it to the queue, the rest of the run's output is dropped
+      drainJob(*job, std::numeric_limits<size_t>::max());
+      job->logModel->appendLine(tr("Aborted"), LogStyle::ErrorH1);
+      RunWorker* worker = job->worker;
+      QThread* thread = job->thread;
+      // The job is done as far as everyone is concerned, its processes are still stopped in the background. Those of a
+      // job on a warm worker are stopped by the pool, see onProcessTreeStopped
+      const bool stopsProcessTree = (job->poolWorkerId < 0 || !job->poolJobSent);
+      ++m_pendingCancels;
+      // There won't be a runFinished: the thread is stopped once the processes are gone
+      connect(worker, &RunWorker::runAborted, this, [this, thread, stopsProcessTree](qint64 latencyMs, bool forced, bool complete) {
+        thread->quit();
+        if (stopsProcessTree) {
+          onProcessTreeStopped(latencyMs, forced, complete);
+        }
+      });
+      QMetaObject::invokeMethod(worker, &RunWorker::abortRun);
+      finishJob(*job, JobStatus::Aborted);
+    }
+  }
+}
+
+void JobScheduler::onProcessTreeStopped(qint64 latencyMs, bool forced, bool complete) {
+  qDebug() << "Aborted job stopped in" << latencyMs << "ms" << (forced ? "(killed)" : "") << (complete ? "" : ", some processes are left");
+  ++m_cancelledJobs;
+  // Each job keeps a core busy, see physicalCoreCount: it's only back once nothing of the job is left running
+  if (complete) {
+    ++m_coresReturned;
+  }
+  if (forced) {
+    ++m_forcedCancels;
+  }
+  if (--m_pendingCancels == 0) {
+    emit cancelFinished(m_cancelledJobs, m_coresReturned, m_forcedCancels, m_cancelTimer.elapsed());
+  }
+}
+
+void JobScheduler::clearFinishedJobs() {
+  // Aborted jobs' threads still report to us until their processes are gone
+  if (m_runningJobs > 0 || m_pendingCancels > 0) {
+    return;
+  }
+  beginResetModel();
+  for (auto& job : m_jobs) {
+    delete job->logModel;
+  }
+  m_jobs.clear();
+  endResetModel();
+}
+
+bool JobScheduler::isRunning() const {
+  return m_runningJobs > 0;
+}
+
+bool JobScheduler::isCancelling() const {
+  return m_pendingCancels > 0;
+}
+
+bool JobScheduler::hasQueuedJobs() const {
+  return std::any_of(m_jobs.cbegin(), m_jobs.cend(), [](const auto& job) { return job->status == JobStatus::Queued; });
+}
+
+QString JobScheduler::workflowJSONPath(int row) const {
+  return m_jobs[row]->workflowJSONPath;
+}
+
+JobScheduler::JobStatus JobScheduler::jobStatus(int row) const {
+  return m_jobs[row]->status;
+}
+
+RunLogModel* JobScheduler::logModel(int row) const {
+  return m_jobs[row]->logModel;
+}
+
+QString JobScheduler::logBasePath(int row) const {
+  return m_jobs[row]->logBasePath;
+}
+
+qint64 JobScheduler::suppressedLineCount(int row) const {
+  return m_jobs[row]->suppressedLineCount;
+}
+
+const RunTimeline& JobScheduler::timeline(int row) const {
+  return m_jobs[row]->timeline;
+}
+
+MeasureLibrary* JobScheduler::measureLibrary() const {
+  return m_measureLibrary.get();
+}
+
+const PhaseDurationHistory& JobScheduler::phaseHistory() const {
+  return m_phaseHistory;
+}
+
+qint64 JobScheduler::startupSavedMs() const {
+  return m_startupSavedMs;
+}
+
+void JobScheduler::startQueuedJobs() {
+  m_waitingForWorker = false;
+  for (auto& job : m_jobs) {
+    if (m_runningJobs >= m_maxConcurrentJobs) {
+      break;
+    }
+    if (job->status != JobStatus::Queued) {
+      continue;
+    }
+    int workerId = -1;
+    if (m_workerPool->isEnabled()) {
+      workerId = m_workerPool->acquireIdleWorker();
+      if (workerId < 0) {
+        // Picked up again as soon as a worker is idle
+        m_waitingForWorker = true;
+        break;
+      }
+    }
+    job->poolWorkerId = workerId;
+    startJob(*job);
+  }
+}
+
+void JobScheduler::startJob(Job& job) {
+  job.status = JobStatus::Running;
+  job.timer.start();
+  job.elapsedMs = -1;
+  job.lineCount = 0;
+  job.suppressedLineCount = 0;
+  job.restoredFromCache = false;
+  job.cachedRunCreatedAt = QDateTime();
+  job.cachedRunElapsedMs = -1;
+  job.logModel->clear();
+  job.timeline.start();
+  // eg runs/20221012-153012-042_3_compact
+  job.logBasePath = QDir(m_runLogDirectory)
+                      .filePath(QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss-zzz") + '_' + QString::number(rowOf(job)) + '_'
+                                + QFileInfo(job.workflowJSONPath).completeBaseName());
+  ++m_runningJobs;
+
+  // One thread per job: a chatty workflow can't hold back the ingestion of the others
+  job.thread = new QThread(this);
+  job.thread->setObjectName("RunWorker " + QFileInfo(job.workflowJSONPath).fileName());
+  job.worker = new RunWorker;
+  job.resumeStep = 0;
+  job.preflightErrorCount = 0;
+  job.worker->setMeasureLibrary(m_measureLibrary.get());
+  if (m_fileHashes) {
+    job.worker->setResultCache(m_resultCache.get(), m_checkpoints.get(), job.poolWorkerId >= 0 ? m_workerPool->program() : m_program);
+  }
+  job.worker->moveToThread(job.thread);
+  connect(job.thread, &QThread::finished, job.worker, &QObject::deleteLater);
+  connect(job.thread, &QThread::finished, job.thread, &QObject::deleteLater);
+  m_threads.push_back(job.thread);
+  connect(job.thread, &QObject::destroyed, this,
+          [this](QObject* thread) { m_threads.erase(std::remove(m_threads.begin(), m_threads.end(), thread), m_threads.end()); });
+  connect(job.worker, &RunWorker::batchesAvailable, this, &JobScheduler::onBatchesAvailable);
+  // Whatever the worker still has in flight is dropped with the job, rather than delivered to it once it's gone
+  job.context = std::make_unique<QObject>();
+  QObject* context = job.context.get();
+  Job* jobPtr = &job;
+  connect(job.worker, &RunWorker::workflowEvent, context,
+          [this, jobPtr](WorkflowEvent event, WorkflowState state, int stepIndex, const QString& text, qint64 msSinceStart) {
+            if (jobPtr->status != JobStatus::Running) {
+              return;
+            }
+            jobPtr->timeline.handleEvent(event, state, stepIndex, text, msSinceStart);
+            emit timelineChanged(rowOf(*jobPtr));
+          });
+  connect(job.worker, &RunWorker::restoredFromCache, context, [jobPtr](const QDateTime& createdAt, qint64 elapsedMs) {
+    jobPtr->restoredFromCache = true;
+    jobPtr->cachedRunCreatedAt = createdAt;
+    jobPtr->cachedRunElapsedMs = elapsedMs;
+  });
+  connect(job.worker, &RunWorker::workflowRefused, context, [jobPtr](int errorCount) { jobPtr->preflightErrorCount = errorCount; });
+  connect(job.worker, &RunWorker::resumedFromCheckpoint, context, [this, jobPtr](int skippedSteps) {
+    jobPtr->resumeStep = skippedSteps;
+    emitJobChanged(*jobPtr);
+  });
+  connect(job.worker, &RunWorker::runFinished, context,
+          [this, jobPtr](int exitCode, QProcess::ExitStatus status) { onJobFinished(*jobPtr, exitCode, status); });
+  job.thread->start();
+
+  RunWorker* worker = job.worker;
+  const QString program = m_program;
+  const QString workflowJSONPath = job.workflowJSONPath;
+  const QString logBasePath = job.logBasePath;
+  if (job.poolWorkerId >= 0) {
+    // The worker listens on the run socket, then the warm process gets the command line
+    job.poolJobSent = false;
+    job.startupSavedMs = std::max<qint64>(0, m_workerPool->startupMs(job.poolWorkerId));
+    m_startupSavedMs += job.startupSavedMs;
+    connect(job.worker, &RunWorker::pooledRunReady, context, [this, jobPtr](const QStringList& arguments) {
+      if (jobPtr->status != JobStatus::Running || jobPtr->poolWorkerId < 0) {
+        return;
+      }
+      m_workerPool->runJob(jobPtr->poolWorkerId, arguments);
+      jobPtr->poolJobSent = true;
+    });
+    QMetaObject::invokeMethod(worker, [worker, workflowJSONPath, logBasePath]() { worker->startPooledRun(workflowJSONPath, logBasePath); });
+  } else {
+    job.startupSavedMs = 0;
+    QMetaObject::invokeMethod(worker, [worker, program, workflowJSONPath, logBasePath]() {
+      worker->startRun(program, workflowJSONPath, logBasePath);
+    });
+  }
+
+  emitJobChanged(job);
+}
+
+void JobScheduler::onJobFinished(Job& job, int exitCode, QProcess::ExitStatus status) {
+  if (job.status != JobStatus::Running) {
+    // Aborted in the meantime
+    return;
+  }
+  // The worker published everything before emitting runFinished, so this gets the whole tail of the log
+  while (drainJob(job, MaxLogLinesPerFrame) > 0) {
+  }
+  job.thread->quit();
+  JobStatus jobStatus = job.preflightErrorCount > 0 ? JobStatus::Invalid : JobStatus::Failed;
+  if (exitCode == 0 && status == QProcess::NormalExit) {
+    jobStatus = job.restoredFromCache ? JobStatus::Cached : JobStatus::Succeeded;
+  }
+  finishJob(job, jobStatus);
+}
+
+void JobScheduler::finishJob(Job& job, JobStatus status) {
+  const bool wasRunning = (job.status == JobStatus::Running);
+  if (wasRunning) {
+    job.elapsedMs = job.timer.elapsed();
+    --m_runningJobs;
+  }
+  job.status = status;
+  // The thread deletes itself and the worker once it's done
+  job.thread = nullptr;
+  job.worker = nullptr;
+  if (job.poolWorkerId >= 0) {
+    if (!job.poolJobSent) {
+      // eg restored from the cache: the warm worker didn't save anything
+      m_startupSavedMs -= job.startupSavedMs;
+      job.startupSavedMs = 0;
+      m_workerPool->releaseWorker(job.poolWorkerId);
+    } else if (status == JobStatus::Aborted) {
+      m_workerPool->abortJob(job.poolWorkerId);
+    }
+    job.poolWorkerId = -1;
+    job.poolJobSent = false;
+  }
+  emitJobChanged(job);
+
+  if (wasRunning) {
+    job.timeline.finish(job.elapsedMs);
+    emit timelineChanged(rowOf(job));
+    // Failed and aborted runs stop anywhere, resumed ones skip steps: they would only skew the durations
+    if (status == JobStatus::Succeeded && job.resumeStep == 0) {
+      m_phaseHistory.addRun(job.timeline);
+      m_phaseHistory.save();
+      emit phaseHistoryChanged();
+    }
+  }
+
+  if (status != JobStatus::Aborted) {
+    startQueuedJobs();
+  }
+  if (m_runningJobs == 0 && !hasQueuedJobs()) {
+    emit allJobsFinished(m_wallTimer.elapsed());
+  }
+}
+
+void JobScheduler::onPoolJobFinished(int workerId, int exitCode, bool crashed) {
+  const auto it = std::find_if(m_jobs.cbegin(), m_jobs.cend(),
+                               [workerId](const auto& job) { return job->status == JobStatus::Running && job->poolWorkerId == workerId; });
+  if (it == m_jobs.cend()) {
+    return;
+  }
+  // Ends up in onJobFinished through runFinished, like a job with its own process
+  RunWorker* worker = (*it)->worker;
+  const QProcess::ExitStatus status = crashed ? QProcess::CrashExit : QProcess::NormalExit;
+  QMetaObject::invokeMethod(worker, [worker, exitCode, status]() { worker->finishPooledRun(exitCode, status); });
+}
+
+void JobScheduler::onBatchesAvailable() {
+  if (!m_drainTimer->isActive()) {
+    m_drainTimer->start();
+  }
+}
+
+void JobScheduler::drainLogs() {
+  size_t budget = MaxLogLinesPerFrame;
+  bool hasMore = false;
+  for (auto& job : m_jobs) {
+    if (job->status != JobStatus::Running) {
+      continue;
+    }
+    if (budget == 0) {
+      hasMore = true;
+      break;
+    }
+    // The last batch is taken whole, so a job can go over what's left of the budget
+    const size_t drained = drainJob(*job, budget);
+    budget = drained < budget ? budget - drained : 0;
+    hasMore = hasMore || (budget == 0);
+    // Lines and time keep moving while a job runs
+    emit dataChanged(index(rowOf(*job), LinesColumn), index(rowOf(*job), TimeColumn));
+  }
+  if (hasMore) {
+    // Leave the rest to the next frame, so the event loop gets to paint in between
+    m_drainTimer->start();
+  }
+}
+
+size_t JobScheduler::drainJob(Job& job, size_t maxLines) {
+  size_t drained = 0;
+  LogBatch batch;
+  while (drained < maxLines && job.worker && job.worker->popBatch(batch)) {
+    drained += batch.size();
+    job.logModel->appendLines(batch);
+  }
+  job.lineCount += static_cast<qint64>(drained);
+  if (job.worker) {
+    job.suppressedLineCount = job.worker->suppressedLineCount();
+  }
+  return drained;
+}
+
+int JobScheduler::rowOf(const Job& job) const {
+  const auto it = std::find_if(m_jobs.cbegin(), m_jobs.cend(), [&job](const auto& j) { return j.get() == &job; });
+  return static_cast<int>(std::distance(m_jobs.cbegin(), it));
+}
+
+void JobScheduler::emitJobChanged(const Job& job) {
+  const int row = rowOf(job);
+  emit dataChanged(index(row, 0), index(row, ColumnCount - 1));
+}
+
+QString JobScheduler::phaseHistoryPath() const {
+  return QDir(m_runLogDirectory).filePath(PhaseHistoryFileName);
+}
@@ -0,0 +1,202 @@
+#ifndef JOBSCHEDULER_HPP
+#define JOBSCHEDULER_HPP
+
+#include "runlogmodel.hpp"
+#include "runtimeline.hpp"
+
+#include <QAbstractTableModel>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QProcess>
+
+#include <memory>
+#include <vector>
+
+class QThread;
+class QTimer;
+class RunWorker;
+class FileHashCache;
+class MeasureLibrary;
+class WorkerPool;
+class WorkflowCheckpoints;
+class WorkflowResultCache;
+
+// Number of physical cores (not hardware threads), falls back to QThread::idealThreadCount()
+int physicalCoreCount();
+
+// Queue of workflows, up to maxConcurrentJobs() of them running at the same time. Each running job has its own CLI
+// process, run socket and ingestion thread (a RunWorker), and every job keeps its own log.
+// Doubles as the model of the per-job status table.
+class JobScheduler : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum class JobStatus
+    {
+      Queued,
+      Running,
+      Succeeded,
+      // Succeeded, with the outputs and log of an identical earlier run rather than by running
+      Cached,
+      Failed,
+      // Not run: the pre-flight validation found something the CLI would fail on
+      Invalid,
+      Aborted
+    };
+
+    enum Columns
+    {
+      WorkflowColumn,
+      StatusColumn,
+      LinesColumn,
+      SuppressedColumn,
+      TimeColumn,
+      ColumnCount
+    };
+
+    explicit JobScheduler(QObject *parent = nullptr);
+    ~JobScheduler();
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    // Path to the openstudio CLI
+    void setProgram(const QString& program);
+    // Runs the jobs on warm, long-lived workers of that program (see WorkerPool) instead of a fresh CLI process each.
+    // The pool follows maxConcurrentJobs(), and starts right away so the workers are ready by the time jobs come
+    void setWorkerProgram(const QString& program, const QStringList& arguments = QStringList());
+
+    // Where the on-disk log of every run goes, see RunLogStore
+    QString runLogDirectory() const;
+    void setRunLogDirectory(const QString& runLogDirectory);
+
+    // Where the WorkflowResultCache keeps the results of successful runs and the WorkflowCheckpoints the intermediate
+    // models, empty (the default) for neither: every job runs in full. Ignored while running or cancelling
+    QString cacheDirectory() const;
+    void setCacheDirectory(const QString& cacheDirectory);
+
+    int maxConcurrentJobs() const;
+    void setMaxConcurrentJobs(int maxConcurrentJobs);
+
+    // Returns the row of the new job, which starts as Queued
+    int addJob(const QString& workflowJSONPath);
+    // Starts as many queued jobs as allowed, more are started as running ones finish
+    void start();
+    // Every job is Aborted right away, their processes are stopped in the background: see cancelFinished
+    void abortAll();
+    // Removes the jobs that are done, does nothing while jobs are running or aborted ones are still being stopped
+    void clearFinishedJobs();
+
+    bool isRunning() const;
+    // Aborted jobs' processes aren't all gone yet, see cancelFinished
+    bool isCancelling() const;
+    bool hasQueuedJobs() const;
+
+    QString workflowJSONPath(int row) const;
+    JobStatus jobStatus(int row) const;
+    RunLogModel* logModel(int row) const;
+    // Base path of the job's RunLogStore, empty until the job is started
+    QString logBasePath(int row) const;
+    // Lines left out of the live log to keep up with a flood. They are all in the store
+    qint64 suppressedLineCount(int row) const;
+    // Phases and measures of the job's run, so far
+    const RunTimeline& timeline(int row) const;
+
+    // Schemas of the measures the workflows use, cached across sessions
+    MeasureLibrary* measureLibrary() const;
+
+    // Durations from every successful run, kept in the run log directory
+    const PhaseDurationHistory& phaseHistory() const;
+
+    // CLI startup time the warm workers spared the jobs started since start()
+    qint64 startupSavedMs() const;
+
+signals:
+    // Every queued job has run, wallTimeMs is measured from start()
+    void allJobsFinished(qint64 wallTimeMs);
+    // The processes of every job abortAll stopped are gone. coresReturned: jobs nothing is left running of, forcedCount:
+    // jobs that had to be killed. latencyMs is measured from abortAll
+    void cancelFinished(int jobCount, int coresReturned, int forcedCount, qint64 latencyMs);
+
+    void timelineChanged(int row);
+    void phaseHistoryChanged();
+
+private:
+    struct Job
+    {
+      QString workflowJSONPath;
+      QString logBasePath;
+      JobStatus status = JobStatus::Queued;
+      RunLogModel* logModel = nullptr;
+      QThread* thread = nullptr;
+      RunWorker* worker = nullptr;
+      // Receiver of the worker's signals about this job
+      std::unique_ptr<QObject> context;
+      QElapsedTimer timer;
+      qint64 elapsedMs = -1;
+      qint64 lineCount = 0;
+      qint64 suppressedLineCount = 0;
+      RunTimeline timeline;
+      // Warm worker running the job, -1 for a process of its own
+      int poolWorkerId = -1;
+      bool poolJobSent = false;
+      qint64 startupSavedMs = 0;
+      bool restoredFromCache = false;
+      // Original run of a Cached job
+      QDateTime cachedRunCreatedAt;
+      qint64 cachedRunElapsedMs = -1;
+      // Steps skipped by resuming from a checkpoint
+      int resumeStep = 0;
+      // Of an Invalid job
+      int preflightErrorCount = 0;
+    };
+
+    void startQueuedJobs();
+    void startJob(Job& job);
+    void onJobFinished(Job& job, int exitCode, QProcess::ExitStatus status);
+    void finishJob(Job& job, JobStatus status);
+    void onPoolJobFinished(int workerId, int exitCode, bool crashed);
+    // One aborted job's processes are gone
+    void onProcessTreeStopped(qint64 latencyMs, bool forced, bool complete);
+    void onBatchesAvailable();
+    void drainLogs();
+    // Moves whole batches from the job's queue into its log model until maxLines lines are moved, so the last one
+    // can go over. Returns how many were moved
+    size_t drainJob(Job& job, size_t maxLines);
+    int rowOf(const Job& job) const;
+    void emitJobChanged(const Job& job);
+    QString phaseHistoryPath() const;
+
+    std::vector<std::unique_ptr<Job>> m_jobs;
+    // Every job thread that's still around, the jobs forget theirs as soon as they're done
+    std::vector<QThread*> m_threads;
+    QString m_program;
+    QString m_runLogDirectory;
+    int m_maxConcurrentJobs;
+    int m_runningJobs = 0;
+    QElapsedTimer m_wallTimer;
+    QTimer* m_drainTimer;
+    PhaseDurationHistory m_phaseHistory;
+    WorkerPool* m_workerPool;
+    // Used by the checkpoints, goes last
+    std::unique_ptr<MeasureLibrary> m_measureLibrary;
+    QString m_cacheDirectory;
+    // Used by the other two, goes last
+    std::unique_ptr<FileHashCache> m_fileHashes;
+    std::unique_ptr<WorkflowResultCache> m_resultCache;
+    std::unique_ptr<WorkflowCheckpoints> m_checkpoints;
+    // Queued jobs are waiting for a worker to be idle
+    bool m_waitingForWorker = false;
+    qint64 m_startupSavedMs = 0;
+    // Aborted jobs whose processes aren't known to be gone yet, and what the ones that are told so far
+    int m_pendingCancels = 0;
+    int m_cancelledJobs = 0;
+    int m_coresReturned = 0;
+    int m_forcedCancels = 0;
+    QElapsedTimer m_cancelTimer;
+};
+
+#endif // JOBSCHEDULER_HPP
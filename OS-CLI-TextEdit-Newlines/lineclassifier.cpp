@@ -0,0 +1,247 @@
+#include "lineclassifier.hpp"
+
+#include <array>
+#include <cstddef>
+#include <limits>
+
+namespace {
+
+struct Phrase
+{
+  std::string_view text;  // lower case
+  WorkflowEvent event;
+  WorkflowState state;
+};
+
+constexpr std::array<Phrase, 19> phrases{{
+  {"starting state initialization", WorkflowEvent::StateStarted, WorkflowState::Initialization},
+  {"returned from state initialization", WorkflowEvent::StateReturned, WorkflowState::Initialization},
+  {"starting state os_measures", WorkflowEvent::StateStarted, WorkflowState::OsMeasures},
+  {"returned from state os_measures", WorkflowEvent::StateReturned, WorkflowState::OsMeasures},
+  {"starting state translator", WorkflowEvent::StateStarted, WorkflowState::Translator},
+  {"returned from state translator", WorkflowEvent::StateReturned, WorkflowState::Translator},
+  {"starting state ep_measures", WorkflowEvent::StateStarted, WorkflowState::EpMeasures},
+  {"returned from state ep_measures", WorkflowEvent::StateReturned, WorkflowState::EpMeasures},
+  {"starting state preprocess", WorkflowEvent::StateStarted, WorkflowState::Preprocess},
+  {"returned from state preprocess", WorkflowEvent::StateReturned, WorkflowState::Preprocess},
+  {"starting state simulation", WorkflowEvent::StateStarted, WorkflowState::Simulation},
+  {"returned from state simulation", WorkflowEvent::StateReturned, WorkflowState::Simulation},
+  {"starting state reporting_measures", WorkflowEvent::StateStarted, WorkflowState::ReportingMeasures},
+  {"returned from state reporting_measures", WorkflowEvent::StateReturned, WorkflowState::ReportingMeasures},
+  {"starting state postprocess", WorkflowEvent::StateStarted, WorkflowState::Postprocess},
+  {"returned from state postprocess", WorkflowEvent::StateReturned, WorkflowState::Postprocess},
+  {"started", WorkflowEvent::Started, WorkflowState::None},
+  {"failure", WorkflowEvent::Failure, WorkflowState::None},
+  {"complete", WorkflowEvent::Complete, WorkflowState::None},
+}};
+
+constexpr char toLower(char c) {
+  return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+constexpr bool equalsIgnoreCase(std::string_view text, std::string_view lowerCase) {
+  if (text.size() != lowerCase.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < text.size(); ++i) {
+    if (toLower(text[i]) != lowerCase[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+constexpr bool startsWithIgnoreCase(std::string_view text, std::string_view lowerCasePrefix) {
+  return text.size() >= lowerCasePrefix.size() && equalsIgnoreCase(text.substr(0, lowerCasePrefix.size()), lowerCasePrefix);
+}
+
+constexpr size_t minPhraseLength() {
+  size_t result = std::numeric_limits<size_t>::max();
+  for (const auto& phrase : phrases) {
+    result = phrase.text.size() < result ? phrase.text.size() : result;
+  }
+  return result;
+}
+
+constexpr size_t maxPhraseLength() {
+  size_t result = 0;
+  for (const auto& phrase : phrases) {
+    result = phrase.text.size() > result ? phrase.text.size() : result;
+  }
+  return result;
+}
+
+// Perfect hash: case folded FNV-1a, with a seed searched at compile time so that every phrase lands in its own slot
+constexpr size_t HashTableSize = 64;
+static_assert((HashTableSize & (HashTableSize - 1)) == 0, "HashTableSize must be a power of two");
+static_assert(HashTableSize >= phrases.size());
+
+constexpr uint32_t phraseHash(std::string_view text, uint32_t seed) {
+  uint32_t hash = 2166136261U ^ seed;
+  for (char c : text) {
+    hash ^= static_cast<uint8_t>(toLower(c));
+    hash *= 16777619U;
+  }
+  return hash;
+}
+
+constexpr bool isCollisionFree(uint32_t seed) {
+  std::array<bool, HashTableSize> used{};
+  for (const auto& phrase : phrases) {
+    const size_t slot = phraseHash(phrase.text, seed) & (HashTableSize - 1);
+    if (used[slot]) {
+      return false;
+    }
+    used[slot] = true;
+  }
+  return true;
+}
+
+constexpr uint32_t findSeed() {
+  for (uint32_t seed = 0; seed < 10000; ++seed) {
+    if (isCollisionFree(seed)) {
+      return seed;
+    }
+  }
+  return std::numeric_limits<uint32_t>::max();
+}
+
+constexpr uint32_t PhraseSeed = findSeed();
+static_assert(PhraseSeed != std::numeric_limits<uint32_t>::max(), "No collision free seed found, grow HashTableSize");
+
+constexpr std::array<int8_t, HashTableSize> buildSlots() {
+  std::array<int8_t, HashTableSize> slots{};
+  for (auto& slot : slots) {
+    slot = -1;
+  }
+  for (size_t i = 0; i < phrases.size(); ++i) {
+    slots[phraseHash(phrases[i].text, PhraseSeed) & (HashTableSize - 1)] = static_cast<int8_t>(i);
+  }
+  return slots;
+}
+
+constexpr std::array<int8_t, HashTableSize> phraseSlots = buildSlots();
+constexpr size_t MinPhraseLength = minPhraseLength();
+constexpr size_t MaxPhraseLength = maxPhraseLength();
+
+constexpr unsigned levelBit(LineLevel level) {
+  return 1U << (static_cast<int>(level) - static_cast<int>(LineLevel::Debug));
+}
+
+bool matchesAt(std::string_view line, size_t pos, std::string_view keyword) {
+  return line.compare(pos, keyword.size(), keyword) == 0;
+}
+
+}  // namespace
+
+LineLevel classifyLevel(std::string_view line) {
+  // Bits are ordered by precedence (Debug first), so the lowest bit set is what the old if / else if chain would pick
+  unsigned found = 0;
+  const size_t size = line.size();
+  for (size_t i = 0; i < size; ++i) {
+    switch (line[i]) {
+      case 'D':
+        if (matchesAt(line, i, "DEBUG")) {
+          return LineLevel::Debug;
+        }
+        break;
+      case 'I':
+        if (matchesAt(line, i, "INFO")) {
+          found |= levelBit(LineLevel::Info);
+        }
+        break;
+      case 'W':
+        if (matchesAt(line, i, "WARN")) {
+          found |= levelBit(LineLevel::Warn);
+        }
+        break;
+      case 'E':
+        if (matchesAt(line, i, "ERROR")) {
+          found |= levelBit(LineLevel::Error);
+        }
+        break;
+      case 'F':
+        if (matchesAt(line, i, "FATAL")) {
+          found |= levelBit(LineLevel::Fatal);
+        }
+        break;
+      case ']': {
+        // "] <N>" with N in [-2, 2]
+        size_t pos = i + 1;
+        if (pos + 2 < size && line[pos] == ' ' && line[pos + 1] == '<') {
+          pos += 2;
+          const bool negative = line[pos] == '-';
+          pos += negative ? 1 : 0;
+          if (pos + 1 < size && line[pos] >= '0' && line[pos] <= '2' && line[pos + 1] == '>') {
+            const int value = negative ? -(line[pos] - '0') : (line[pos] - '0');
+            if (value == static_cast<int>(LineLevel::Debug)) {
+              return LineLevel::Debug;
+            }
+            if (!(negative && value == 0)) {
+              found |= levelBit(static_cast<LineLevel>(value));
+            }
+          }
+        }
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
+  for (int level = static_cast<int>(LineLevel::Debug); level <= static_cast<int>(LineLevel::Fatal); ++level) {
+    if ((found & levelBit(static_cast<LineLevel>(level))) != 0) {
+      return static_cast<LineLevel>(level);
+    }
+  }
+  return LineLevel::None;
+}
+
+LineClass classifyLine(std::string_view line) {
+  LineClass result;
+
+  result.level = classifyLevel(line);
+  if (result.level != LineLevel::None) {
+    return result;
+  }
+
+  if (line.size() >= MinPhraseLength && line.size() <= MaxPhraseLength) {
+    const int8_t index = phraseSlots[phraseHash(line, PhraseSeed) & (HashTableSize - 1)];
+    if (index >= 0 && equalsIgnoreCase(line, phrases[index].text)) {
+      result.event = phrases[index].event;
+      result.state = phrases[index].state;
+      return result;
+    }
+  }
+
+  if (startsWithIgnoreCase(line, "applying")) {
+    result.event = WorkflowEvent::Applying;
+  } else if (startsWithIgnoreCase(line, "applied")) {
+    result.event = WorkflowEvent::Applied;
+  }
+  return result;
+}
+
+std::string_view workflowStateName(WorkflowState state) {
+  switch (state) {
+    case WorkflowState::Initialization:
+      return "initialization";
+    case WorkflowState::OsMeasures:
+      return "os_measures";
+    case WorkflowState::Translator:
+      return "translator";
+    case WorkflowState::EpMeasures:
+      return "ep_measures";
+    case WorkflowState::Preprocess:
+      return "preprocess";
+    case WorkflowState::Simulation:
+      return "simulation";
+    case WorkflowState::ReportingMeasures:
+      return "reporting_measures";
+    case WorkflowState::Postprocess:
+      return "postprocess";
+    case WorkflowState::None:
+      break;
+  }
+  return {};
+}
@@ -0,0 +1,64 @@
+#ifndef LINECLASSIFIER_HPP
+#define LINECLASSIFIER_HPP
+
+#include <cstdint>
+#include <string_view>
+
+// Same values as the CLI's LogLevel (the "] <N>" tag of a log line)
+enum class LineLevel : int8_t
+{
+  None = -4,  // not a log line
+  Trace = -3,
+  Debug = -2,
+  Info = -1,
+  Warn = 0,
+  Error = 1,
+  Fatal = 2
+};
+
+// DLM: coordinate with openstudio-workflow-gem\lib\openstudio\workflow\adapters\output\socket.rb
+enum class WorkflowState : uint8_t
+{
+  None,
+  Initialization,
+  OsMeasures,
+  Translator,
+  EpMeasures,
+  Preprocess,
+  Simulation,
+  ReportingMeasures,
+  Postprocess,
+};
+
+enum class WorkflowEvent : uint8_t
+{
+  None,
+  StateStarted,   // "Starting state <state>"
+  StateReturned,  // "Returned from state <state>"
+  Started,
+  Failure,
+  Complete,
+  Applying,  // "Applying <measure>"
+  Applied,   // "Applied <measure>"
+};
+
+struct LineClass
+{
+  LineLevel level = LineLevel::None;
+  WorkflowEvent event = WorkflowEvent::None;
+  WorkflowState state = WorkflowState::None;
+};
+
+// Sorts a trimmed line of CLI output in a single pass, replacing the chain of contains() / QString::compare() calls.
+// A line that carries a log level keyword (DEBUG, INFO, WARN, ERROR, FATAL) or tag ("] <-2>" ... "] <2>") only gets a
+// level, with the same precedence as the old chain (DEBUG wins over INFO, etc.). Otherwise it's matched (case insensitive)
+// against the workflow phrases through a perfect hash computed at compile time.
+LineClass classifyLine(std::string_view line);
+
+// Only looks at the level keywords / tags
+LineLevel classifyLevel(std::string_view line);
+
+// The name the CLI uses for the state, eg "os_measures". Empty for None
+std::string_view workflowStateName(WorkflowState state);
+
+#endif // LINECLASSIFIER_HPP
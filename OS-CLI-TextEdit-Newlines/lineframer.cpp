@@ -0,0 +1,25 @@
+#include "lineframer.hpp"
+
+static bool isAsciiSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+QByteArrayView trimmedView(QByteArrayView line) {
+  const char* begin = line.data();
+  const char* end = begin + line.size();
+  while (begin != end && isAsciiSpace(*begin)) {
+    ++begin;
+  }
+  while (end != begin && isAsciiSpace(*(end - 1))) {
+    --end;
+  }
+  return QByteArrayView(begin, end - begin);
+}
+
+void LineFramer::reset() {
+  m_tail.clear();
+}
+
+qsizetype LineFramer::pendingSize() const {
+  return m_tail.size();
+}
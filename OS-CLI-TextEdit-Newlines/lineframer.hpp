@@ -0,0 +1,81 @@
+#ifndef LINEFRAMER_HPP
+#define LINEFRAMER_HPP
+
+#include <QByteArray>
+#include <QByteArrayView>
+
+#include <cstring>
+
+// Splits a byte stream (QProcess channel, socket...) into lines without copying or decoding it.
+// Whatever follows the last '\n' of a chunk is kept and prepended to the next one, so a line that straddles two reads
+// comes out whole. Lines are handed out as views (no '\n', trailing '\r' stripped) that are only valid during the callback.
+class LineFramer
+{
+public:
+    template <typename OnLine>
+    void feed(QByteArrayView chunk, OnLine&& onLine);
+
+    // End of stream: hand out the unterminated last line, if any
+    template <typename OnLine>
+    void finish(OnLine&& onLine);
+
+    void reset();
+
+    qsizetype pendingSize() const;
+
+private:
+    template <typename OnLine>
+    static void emitLine(const char* begin, const char* end, OnLine& onLine);
+
+    QByteArray m_tail;
+};
+
+// ASCII whitespace trim, without going through QString
+QByteArrayView trimmedView(QByteArrayView line);
+
+template <typename OnLine>
+void LineFramer::emitLine(const char* begin, const char* end, OnLine& onLine) {
+  if (end != begin && *(end - 1) == '\r') {
+    --end;
+  }
+  onLine(QByteArrayView(begin, end - begin));
+}
+
+template <typename OnLine>
+void LineFramer::feed(QByteArrayView chunk, OnLine&& onLine) {
+  const char* pos = chunk.data();
+  const char* const end = pos + chunk.size();
+
+  if (!m_tail.isEmpty()) {
+    const auto* newline = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+    if (newline == nullptr) {
+      m_tail.append(pos, end - pos);
+      return;
+    }
+    m_tail.append(pos, newline - pos);
+    emitLine(m_tail.constData(), m_tail.constData() + m_tail.size(), onLine);
+    m_tail.resize(0);  // keeps the capacity around for the next straddling line
+    pos = newline + 1;
+  }
+
+  // memchr is the libc's vectorized scan, much faster than walking the bytes ourselves
+  while (pos < end) {
+    const auto* newline = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+    if (newline == nullptr) {
+      m_tail.append(pos, end - pos);
+      return;
+    }
+    emitLine(pos, newline, onLine);
+    pos = newline + 1;
+  }
+}
+
+template <typename OnLine>
+void LineFramer::finish(OnLine&& onLine) {
+  if (!m_tail.isEmpty()) {
+    emitLine(m_tail.constData(), m_tail.constData() + m_tail.size(), onLine);
+  }
+  m_tail.clear();
+}
+
+#endif // LINEFRAMER_HPP
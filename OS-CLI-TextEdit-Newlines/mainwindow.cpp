@@ -1,11 +1,69 @@
 #include "mainwindow.hpp"
-
+#include "measurelibrary.hpp"
+#include "runlogdelegate.hpp"
+#include "timelinewidget.hpp"
+#include "workflowfiles.hpp"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QFutureWatcher>
 #include <QGridLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QListView>
+#include <QScrollBar>
+#include <QSpinBox>
+#include <QStandardPaths>
+#include <QTableView>
+#include <QTableWidget>
+#include <QTabWidget>
 #include <QToolButton>
-#include <QTextEdit>
-#include <QProcess>
-#include <QTcpServer>
-#include <QTcpSocket>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
+
+// The OPENSTUDIO_CLI environment variable can point to another CLI, eg the openstudio-standin built alongside
+static QString openstudioCLIPath() {
+  return qEnvironmentVariable("OPENSTUDIO_CLI", "/Applications/OpenStudio-3.4.0/bin/openstudio");
+}
+
+// When set, jobs run on warm workers of that program instead, see WorkerPool. eg the openstudio-standin built alongside
+static QString openstudioWorkerPath() {
+  return qEnvironmentVariable("OPENSTUDIO_CLI_WORKER");
+}
+
+static QString cacheDirectory() {
+  return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/cache";
+}
+
+static const QString defaultWorkflowJSONPath("/Users/julien/Software/QtTestBed/OS-CLI-TextEdit-Newlines/test/compact.osw");
+
+static constexpr RunLogIndex::StyleMask styleBit(LogStyle style) {
+  return RunLogIndex::StyleMask(1u << static_cast<int>(style));
+}
+
+// Level filter buttons, and the styles each one shows
+static const struct
+{
+  const char* label;
+  RunLogIndex::StyleMask styles;
+} LogLevelFilters[] = {
+  {"Debug", styleBit(LogStyle::Debug)},
+  {"Info", styleBit(LogStyle::Info)},
+  {"Warn", styleBit(LogStyle::Warn)},
+  {"Error", RunLogIndex::StyleMask(styleBit(LogStyle::Error) | styleBit(LogStyle::Fatal) | styleBit(LogStyle::ErrorH1) | styleBit(LogStyle::ErrorH2)
+                                   | styleBit(LogStyle::ErrorText) | styleBit(LogStyle::Stderr))},
+  {"Other", RunLogIndex::StyleMask(styleBit(LogStyle::Normal) | styleBit(LogStyle::H1) | styleBit(LogStyle::H2))},
+};
+
+// Shorter terms have no trigram to rule lines out with, and would match about everything anyway
+static constexpr int MinSearchTermLength = 3;
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -31,243 +89,390 @@ MainWindow::MainWindow(QWidget *parent)
     mainLayout->addWidget(m_playButton, 0, 0);
     connect(m_playButton, &QToolButton::clicked, this, &MainWindow::playButtonClicked);
 
-    m_textInfo = new QTextEdit();
-    m_textInfo->setReadOnly(true);
-    mainLayout->addWidget(m_textInfo, 1, 0, 1, 4);
-
-    m_runProcess = new QProcess(this);
-    connect(m_runProcess, &QProcess::finished, this, &MainWindow::onRunProcessFinished);
-    connect(m_runProcess, &QProcess::errorOccurred, this, &MainWindow::onRunProcessErrored);
-    connect(m_runProcess, &QProcess::readyReadStandardError, this, &MainWindow::readyReadStandardError);
-    connect(m_runProcess, &QProcess::readyReadStandardOutput, this, &MainWindow::readyReadStandardOutput);
-
-    m_runTcpServer = new QTcpServer();
-    m_runTcpServer->listen();
-    connect(m_runTcpServer, &QTcpServer::newConnection, this, &MainWindow::onNewConnection);
+    m_addWorkflowsButton = new QToolButton();
+    m_addWorkflowsButton->setText(tr("Add Workflows..."));
+    mainLayout->addWidget(m_addWorkflowsButton, 0, 1);
+    connect(m_addWorkflowsButton, &QToolButton::clicked, this, &MainWindow::addWorkflowsClicked);
+
+    m_openRunLogButton = new QToolButton();
+    m_openRunLogButton->setText(tr("Open Run Log..."));
+    mainLayout->addWidget(m_openRunLogButton, 0, 2);
+    connect(m_openRunLogButton, &QToolButton::clicked, this, &MainWindow::openRunLogClicked);
+
+    m_jobScheduler = new JobScheduler(this);
+    m_jobScheduler->setProgram(openstudioCLIPath());
+    m_jobScheduler->setWorkerProgram(openstudioWorkerPath());
+    connect(m_jobScheduler, &JobScheduler::allJobsFinished, this, &MainWindow::onAllJobsFinished);
+    connect(m_jobScheduler, &JobScheduler::cancelFinished, this, &MainWindow::onCancelFinished);
+
+    // Defaults to one job per physical core: E+ is compute bound, hyperthreads don't buy much
+    m_concurrencySpinBox = new QSpinBox();
+    m_concurrencySpinBox->setPrefix(tr("Parallel jobs: "));
+    m_concurrencySpinBox->setRange(1, std::max(64, physicalCoreCount()));
+    m_concurrencySpinBox->setValue(m_jobScheduler->maxConcurrentJobs());
+    mainLayout->addWidget(m_concurrencySpinBox, 0, 3);
+    connect(m_concurrencySpinBox, &QSpinBox::valueChanged, m_jobScheduler, &JobScheduler::setMaxConcurrentJobs);
+
+    // Identical workflows (same OSW, seed, weather, measures and CLI) get their previous results back instead of running,
+    // and the others skip the steps they share with an earlier run
+    m_reuseResultsButton = new QToolButton();
+    m_reuseResultsButton->setText(tr("Reuse Results"));
+    m_reuseResultsButton->setCheckable(true);
+    m_reuseResultsButton->setChecked(true);
+    m_reuseResultsButton->setToolTip(tr("Restore the outputs and log of an identical earlier run rather than running the workflow again,\n"
+                                        "and resume changed workflows from the last step they have in common with an earlier run.\n"
+                                        "Cached in %1")
+                                       .arg(cacheDirectory()));
+    mainLayout->addWidget(m_reuseResultsButton, 0, 4);
+
+    m_statusLabel = new QLabel();
+    mainLayout->addWidget(m_statusLabel, 0, 5);
+
+    m_jobsView = new QTableView();
+    m_jobsView->setModel(m_jobScheduler);
+    m_jobsView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_jobsView->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_jobsView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_jobsView->verticalHeader()->hide();
+    m_jobsView->verticalHeader()->setDefaultSectionSize(m_jobsView->fontMetrics().height() + 4);
+    m_jobsView->horizontalHeader()->setSectionResizeMode(JobScheduler::WorkflowColumn, QHeaderView::Stretch);
+    m_jobsView->setMaximumHeight(150);
+    mainLayout->addWidget(m_jobsView, 1, 0, 1, 6);
+    connect(m_jobsView->selectionModel(), &QItemSelectionModel::currentRowChanged, this,
+            [this](const QModelIndex& current) { showJobLog(current.row()); });
+
+    m_tabWidget = new QTabWidget();
+    mainLayout->addWidget(m_tabWidget, 2, 0, 1, 6);
+    mainLayout->setRowStretch(2, 1);
+
+    // Log tab: level / search filters over the log view
+    auto * logPage = new QWidget();
+    auto * logLayout = new QVBoxLayout(logPage);
+    logLayout->setContentsMargins(0, 0, 0, 0);
+    logLayout->setSpacing(5);
+    m_tabWidget->addTab(logPage, tr("Log"));
+
+    m_logView = new QListView();
+    m_logView->setItemDelegate(new RunLogDelegate(m_logView->font(), m_logView));
+    // Every row has the same height, so the view only ever lays out and paints what is on screen
+    m_logView->setUniformItemSizes(true);
+    m_logView->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    m_logView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_logView->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+    auto * filterLayout = new QHBoxLayout();
+    for (const auto& filter : LogLevelFilters) {
+        auto * button = new QToolButton();
+        button->setText(tr(filter.label));
+        button->setCheckable(true);
+        button->setChecked(true);
+        filterLayout->addWidget(button);
+        connect(button, &QToolButton::toggled, this, &MainWindow::applyLogFilter);
+        m_logLevelButtons.push_back(button);
+    }
+    m_searchLineEdit = new QLineEdit();
+    m_searchLineEdit->setPlaceholderText(tr("Search (%1+ characters)").arg(MinSearchTermLength));
+    m_searchLineEdit->setClearButtonEnabled(true);
+    filterLayout->addWidget(m_searchLineEdit, 1);
+    connect(m_searchLineEdit, &QLineEdit::textChanged, this, &MainWindow::applyLogFilter);
+    logLayout->addLayout(filterLayout);
+    logLayout->addWidget(m_logView, 1);
+
+    // Timeline tab: the phases and measures of the selected job, and how long they take over past runs
+    auto * timelinePage = new QWidget();
+    auto * timelineLayout = new QVBoxLayout(timelinePage);
+    timelineLayout->setContentsMargins(0, 0, 0, 0);
+    timelineLayout->setSpacing(5);
+    m_tabWidget->addTab(timelinePage, tr("Timeline"));
+
+    m_timelineWidget = new TimelineWidget();
+    timelineLayout->addWidget(m_timelineWidget);
+    connect(m_jobScheduler, &JobScheduler::timelineChanged, this, [this](int row) {
+        if (row == m_jobsView->currentIndex().row()) {
+            m_timelineWidget->setTimeline(&m_jobScheduler->timeline(row));
+        }
+    });
+
+    timelineLayout->addWidget(new QLabel(tr("Durations over past successful runs")));
+    m_phaseStatisticsTable = new QTableWidget(0, 5);
+    m_phaseStatisticsTable->setHorizontalHeaderLabels({tr("Phase / Measure"), tr("Runs"), tr("Last"), tr("p50"), tr("p95")});
+    m_phaseStatisticsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_phaseStatisticsTable->setSelectionMode(QAbstractItemView::NoSelection);
+    m_phaseStatisticsTable->verticalHeader()->hide();
+    m_phaseStatisticsTable->verticalHeader()->setDefaultSectionSize(m_phaseStatisticsTable->fontMetrics().height() + 4);
+    m_phaseStatisticsTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    timelineLayout->addWidget(m_phaseStatisticsTable, 1);
+    connect(m_jobScheduler, &JobScheduler::phaseHistoryChanged, this, &MainWindow::updatePhaseStatistics);
+    updatePhaseStatistics();
+
+    // Measures tab: the measures the workflows can use, and their arguments
+    auto * measuresPage = new QWidget();
+    auto * measuresLayout = new QVBoxLayout(measuresPage);
+    measuresLayout->setContentsMargins(0, 0, 0, 0);
+    measuresLayout->setSpacing(5);
+    m_tabWidget->addTab(measuresPage, tr("Measures"));
+
+    m_measuresLabel = new QLabel();
+    measuresLayout->addWidget(m_measuresLabel);
+    m_measuresTree = new QTreeWidget();
+    m_measuresTree->setHeaderLabels({tr("Measure / Argument"), tr("Type"), tr("Default"), tr("Min"), tr("Max"), tr("Required")});
+    m_measuresTree->setUniformRowHeights(true);
+    m_measuresTree->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+    measuresLayout->addWidget(m_measuresTree, 1);
+    m_measuresScanWatcher = new QFutureWatcher<MeasureLibrary::ScanResult>(this);
+    connect(m_measuresScanWatcher, &QFutureWatcherBase::finished, this, &MainWindow::onMeasuresScanned);
+    scanMeasures();
+
+    m_storedLogModel = new RunLogStoreModel(this);
 }
 
-
-
 MainWindow::~MainWindow()
 {
+    // The scan uses the scheduler's measure library, which goes away with the children
+    m_measuresScanWatcher->waitForFinished();
 }
 
-void MainWindow::onNewConnection() {
-  m_runSocket = m_runTcpServer->nextPendingConnection();
-  connect(m_runSocket, &QTcpSocket::readyRead, this, &MainWindow::onRunDataReady);
+RunLogIndex::StyleMask MainWindow::logStyleMask() const {
+  RunLogIndex::StyleMask styleMask = 0;
+  bool allChecked = true;
+  for (size_t i = 0; i < m_logLevelButtons.size(); ++i) {
+    if (m_logLevelButtons[i]->isChecked()) {
+      styleMask |= LogLevelFilters[i].styles;
+    } else {
+      allChecked = false;
+    }
+  }
+  return allChecked ? RunLogIndex::AllStyles : styleMask;
 }
 
-void MainWindow::playButtonClicked(bool t_checked) {
-
-  if (t_checked) {
-    // run
-
-    unsigned port = m_runTcpServer->serverPort();
-    m_hasSocketConnexion = (port != 0);
-    // NOTE: temp test, uncomment to see fallback to stdout
-    // m_hasSocketConnexion = false;
-
-    QStringList arguments;
-    arguments << "--verbose";
+QString MainWindow::logSearchTerm() const {
+  const QString term = m_searchLineEdit->text().trimmed();
+  return term.size() < MinSearchTermLength ? QString() : term;
+}
 
-    QString workflowJSONPath("/Users/julien/Software/QtTestBed/OS-CLI-TextEdit-Newlines/test/compact.osw");
+bool MainWindow::isLogFiltered() const {
+  return logStyleMask() != RunLogIndex::AllStyles || !logSearchTerm().isEmpty();
+}
 
-    if (m_hasSocketConnexion) {
-      arguments << "run"
-                << "-s" << QString::number(port) << "-w" << workflowJSONPath;
-    } else {
-      arguments << "run"
-                << "--show-stdout"
-                // << "--style-stdout"
-                // << "--add-timings"
-                << "-w" << workflowJSONPath;
-    }
-    qDebug() << "run arguments = " << arguments.join(";");
+void MainWindow::applyLogFilter() {
+  QElapsedTimer timer;
+  timer.start();
 
-    m_textInfo->clear();
+  const QModelIndex current = m_jobsView->currentIndex();
+  if (current.isValid()) {
+    // Switches between the live ring buffer and the store as needed
+    showJobLog(current.row());
+  } else if (m_logView->model() == m_storedLogModel) {
+    m_storedLogModel->setFilter(logStyleMask(), logSearchTerm());
+  }
+  qDebug() << "Log filter applied in" << timer.elapsed() << "ms," << (m_logView->model() ? m_logView->model()->rowCount() : 0) << "lines shown";
+}
 
-    if (!m_hasSocketConnexion) {
-      m_textInfo->setTextColor(Qt::red);
-      m_textInfo->setFontPointSize(15);
-      m_textInfo->append("Could not open socket connection to OpenStudio CLI.");
-      m_textInfo->setFontPointSize(12);
-      m_textInfo->append("Falling back to stdout/stderr parsing, live updates might be slower.");
+void MainWindow::showJobLog(int row) {
+  if (row < 0 || row >= m_jobScheduler->rowCount()) {
+    showLogModel(nullptr);
+    m_timelineWidget->setTimeline(nullptr);
+    return;
+  }
+  m_timelineWidget->setTimeline(&m_jobScheduler->timeline(row));
+
+  // The ring buffer only has the tail of a long run, and misses what was suppressed during floods: the store has all of it.
+  // Filtering is always done on the store
+  const JobScheduler::JobStatus status = m_jobScheduler->jobStatus(row);
+  const bool isDone = (status != JobScheduler::JobStatus::Queued) && (status != JobScheduler::JobStatus::Running);
+  RunLogModel* liveLogModel = m_jobScheduler->logModel(row);
+  const bool isIncomplete = liveLogModel->droppedLineCount() > 0 || m_jobScheduler->suppressedLineCount(row) > 0;
+  // A job restored from the cache only has a short note live, its whole log is the cached store
+  const bool useStore = isLogFiltered() || (isDone && isIncomplete) || status == JobScheduler::JobStatus::Cached;
+  if (useStore && m_storedLogModel->open(m_jobScheduler->logBasePath(row))) {
+    m_storedLogModel->setFilter(logStyleMask(), logSearchTerm());
+    showLogModel(m_storedLogModel);
+    if (status == JobScheduler::JobStatus::Running) {
+      // The worker flushes the store before handing lines to the GUI, so whenever the live log grows, so does the store
+      m_storeRefreshConnections[0] = connect(liveLogModel, &QAbstractItemModel::rowsInserted, m_storedLogModel, &RunLogStoreModel::refresh);
+      m_storeRefreshConnections[1] = connect(liveLogModel, &QAbstractItemModel::modelReset, m_storedLogModel, &RunLogStoreModel::refresh);
     }
-
-    m_runProcess->start("/Applications/OpenStudio-3.4.0/bin/openstudio", arguments);
-  } else {
-    // stop running
-    qDebug() << "Kill Simulation";
-    m_textInfo->setTextColor(Qt::red);
-    m_textInfo->setFontPointSize(18);
-    m_textInfo->append("Aborted");
-    m_runProcess->blockSignals(true);
-    m_runProcess->kill();
-    m_runProcess->blockSignals(false);
+    return;
   }
+  showLogModel(liveLogModel);
 }
 
-void MainWindow::readyReadStandardOutput() {
-
-  auto appendErrorText = [&](const QString& text) {
-    m_textInfo->setTextColor(Qt::red);
-    m_textInfo->setFontPointSize(18);
-    m_textInfo->append(text);
-  };
-
-  auto appendNormalText = [&](const QString& text) {
-    m_textInfo->setTextColor(Qt::black);
-    m_textInfo->setFontPointSize(12);
-    m_textInfo->append(text);
-  };
+void MainWindow::showLogModel(QAbstractItemModel* logModel) {
+  disconnect(m_logAboutToInsertConnection);
+  disconnect(m_logInsertedConnection);
+  for (const auto& connection : m_storeRefreshConnections) {
+    disconnect(connection);
+  }
 
-  auto appendH1Text = [&](const QString& text) {
-    m_textInfo->setTextColor(Qt::black);
-    m_textInfo->setFontPointSize(18);
-    m_textInfo->append(text);
-  };
+  m_logView->setModel(logModel);
+  if (!logModel) {
+    return;
+  }
 
-  auto appendH2Text = [&](const QString& text) {
-    m_textInfo->setTextColor(Qt::black);
-    m_textInfo->setFontPointSize(15);
-    m_textInfo->append(text);
-  };
+  // Only follow the tail if the user hasn't scrolled up to read something
+  m_logAboutToInsertConnection = connect(logModel, &QAbstractItemModel::rowsAboutToBeInserted, this, [this]() {
+    const QScrollBar* scrollBar = m_logView->verticalScrollBar();
+    m_logWasAtBottom = scrollBar->value() == scrollBar->maximum();
+  });
+  m_logInsertedConnection = connect(logModel, &QAbstractItemModel::rowsInserted, this, [this]() {
+    if (m_logWasAtBottom) {
+      m_logView->scrollToBottom();
+    }
+  });
+  m_logView->scrollToBottom();
+}
 
-  QString data = m_runProcess->readAllStandardOutput();
-  QStringList lines = data.split("\n");
-
-
-  for (const auto& line : lines) {
-    //std::cout << data.toStdString() << std::endl;
-
-    QString trimmedLine = line.trimmed();
-
-    // DLM: coordinate with openstudio-workflow-gem\lib\openstudio\workflow\adapters\output\socket.rb
-    if (trimmedLine.isEmpty()) {
-      continue;
-    } else if ((trimmedLine.contains("DEBUG")) || (trimmedLine.contains("] <-2>"))) {
-      m_textInfo->setFontPointSize(10);
-      m_textInfo->setTextColor(Qt::lightGray);
-      m_textInfo->append(trimmedLine);
-    } else if ((trimmedLine.contains("INFO")) || (trimmedLine.contains("] <-1>"))) {
-      m_textInfo->setFontPointSize(10);
-      m_textInfo->setTextColor(Qt::gray);
-      m_textInfo->append(trimmedLine);
-    } else if ((trimmedLine.contains("WARN")) || (trimmedLine.contains("] <0>"))) {
-      m_textInfo->setFontPointSize(12);
-      m_textInfo->setTextColor(Qt::darkYellow);
-      m_textInfo->append(trimmedLine);
-    } else if ((trimmedLine.contains("ERROR")) || (trimmedLine.contains("] <1>"))) {
-      m_textInfo->setFontPointSize(12);
-      m_textInfo->setTextColor(Qt::darkRed);
-      m_textInfo->append(trimmedLine);
-    } else if ((trimmedLine.contains("FATAL")) || (trimmedLine.contains("] <1>"))) {
-      m_textInfo->setFontPointSize(14);
-      m_textInfo->setTextColor(Qt::red);
-      m_textInfo->append(trimmedLine);
-
-    } else if (!m_hasSocketConnexion) {
-      // For socket fall back. Avoid doing all these compare if we know we don't need to
-      if (QString::compare(trimmedLine, "Starting state initialization", Qt::CaseInsensitive) == 0) {
-        appendH1Text("Initializing workflow.");
-      } else if (QString::compare(trimmedLine, "Started", Qt::CaseInsensitive) == 0) {
-        // no-op
-      } else if (QString::compare(trimmedLine, "Returned from state initialization", Qt::CaseInsensitive) == 0) {
-        // no-op
-      } else if (QString::compare(trimmedLine, "Starting state os_measures", Qt::CaseInsensitive) == 0) {
-        appendH1Text("Processing OpenStudio Measures.");
-      } else if (QString::compare(trimmedLine, "Returned from state os_measures", Qt::CaseInsensitive) == 0) {
-        // no-op
-      } else if (QString::compare(trimmedLine, "Starting state translator", Qt::CaseInsensitive) == 0) {
-        appendH1Text("Translating the OpenStudio Model to EnergyPlus.");
-      } else if (QString::compare(trimmedLine, "Returned from state translator", Qt::CaseInsensitive) == 0) {
-        // no-op
-      } else if (QString::compare(trimmedLine, "Starting state ep_measures", Qt::CaseInsensitive) == 0) {
-        appendH1Text("Processing EnergyPlus Measures.");
-      } else if (QString::compare(trimmedLine, "Returned from state ep_measures", Qt::CaseInsensitive) == 0) {
-        // no-op
-      } else if (QString::compare(trimmedLine, "Starting state preprocess", Qt::CaseInsensitive) == 0) {
-        // ignore this state
-      } else if (QString::compare(trimmedLine, "Returned from state preprocess", Qt::CaseInsensitive) == 0) {
-        // ignore this state
-      } else if (QString::compare(trimmedLine, "Starting state simulation", Qt::CaseInsensitive) == 0) {
-        appendH1Text("Starting Simulation.");
-      } else if (QString::compare(trimmedLine, "Returned from state simulation", Qt::CaseInsensitive) == 0) {
-        // no-op
-      } else if (QString::compare(trimmedLine, "Starting state reporting_measures", Qt::CaseInsensitive) == 0) {
-        appendH1Text("Processing Reporting Measures.");
-      } else if (QString::compare(trimmedLine, "Returned from state reporting_measures", Qt::CaseInsensitive) == 0) {
-        // no-op
-      } else if (QString::compare(trimmedLine, "Starting state postprocess", Qt::CaseInsensitive) == 0) {
-        appendH1Text("Gathering Reports.");
-      } else if (QString::compare(trimmedLine, "Returned from state postprocess", Qt::CaseInsensitive) == 0) {
-        // no-op
-      } else if (QString::compare(trimmedLine, "Failure", Qt::CaseInsensitive) == 0) {
-        appendErrorText("Failed.");
-      } else if (QString::compare(trimmedLine, "Complete", Qt::CaseInsensitive) == 0) {
-        appendH1Text("Completed.");
-      } else if (trimmedLine.startsWith("Applying", Qt::CaseInsensitive)) {
-        appendH2Text(line);
-      } else if (trimmedLine.startsWith("Applied", Qt::CaseInsensitive)) {
-        // no-op
-      } else {
-        appendNormalText(trimmedLine);
+void MainWindow::updatePhaseStatistics() {
+  const std::vector<PhaseDurationHistory::Stats> statistics = m_jobScheduler->phaseHistory().statistics();
+  m_phaseStatisticsTable->setRowCount(static_cast<int>(statistics.size()));
+  for (int row = 0; row < static_cast<int>(statistics.size()); ++row) {
+    const PhaseDurationHistory::Stats& stats = statistics[row];
+    const QString values[] = {stats.key, QString::number(stats.count), formatDuration(stats.lastMs), formatDuration(stats.p50Ms),
+                              formatDuration(stats.p95Ms)};
+    for (int column = 0; column < 5; ++column) {
+      auto * item = new QTableWidgetItem(values[column]);
+      if (column > 0) {
+        item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
       }
-    } else {  // m_hasSocketConnexion: we know it's stdout and not important socket info, so we put that in gray
-      m_textInfo->setFontPointSize(10);
-      m_textInfo->setTextColor(Qt::gray);
-      m_textInfo->append(trimmedLine);
+      m_phaseStatisticsTable->setItem(row, column, item);
     }
   }
 }
 
-void MainWindow::readyReadStandardError() {
-  auto appendErrorText = [&](const QString& text) {
-    m_textInfo->setTextColor(Qt::darkRed);
-    m_textInfo->setFontPointSize(18);
-    m_textInfo->append(text);
-  };
+void MainWindow::addWorkflowsClicked() {
+  const QStringList paths = QFileDialog::getOpenFileNames(this, tr("Add Workflows"), QString(), tr("Workflows (*.osw)"));
+  for (const QString& path : paths) {
+    m_jobScheduler->addJob(path);
+  }
+  if (!paths.isEmpty()) {
+    scanMeasures();
+  }
+  if (m_jobScheduler->isRunning()) {
+    // Already going: they just join the queue
+    m_jobScheduler->start();
+  }
+}
 
-  QString data = m_runProcess->readAllStandardError();
-  QStringList lines = data.split("\n");
+void MainWindow::openRunLogClicked() {
+  QString path = QFileDialog::getOpenFileName(this, tr("Open Run Log"), m_jobScheduler->runLogDirectory(), tr("Run logs (*.logidx)"));
+  if (path.isEmpty()) {
+    return;
+  }
+  path.chop(QStringLiteral(".logidx").size());
+
+  m_jobsView->setCurrentIndex(QModelIndex());
+  QElapsedTimer timer;
+  timer.start();
+  if (!m_storedLogModel->open(path)) {
+    m_statusLabel->setText(tr("Could not open run log %1").arg(path));
+    return;
+  }
+  m_storedLogModel->setFilter(logStyleMask(), logSearchTerm());
+  showLogModel(m_storedLogModel);
+  m_statusLabel->setText(tr("%1 lines opened in %2 ms").arg(m_storedLogModel->rowCount()).arg(timer.elapsed()));
+}
 
-  for (const auto& line : lines) {
+void MainWindow::playButtonClicked(bool t_checked) {
 
-    QString trimmedLine = line.trimmed();
+  if (t_checked) {
+    // run
+    if (!m_jobScheduler->hasQueuedJobs()) {
+      // The log models go away with their jobs
+      showJobLog(-1);
+      m_jobScheduler->clearFinishedJobs();
+      m_jobScheduler->addJob(defaultWorkflowJSONPath);
+    }
+    if (!m_jobsView->currentIndex().isValid()) {
+      m_jobsView->selectRow(0);
+    }
 
-    if (trimmedLine.isEmpty()) {
-      continue;
-    } else {
-      appendErrorText("stderr: " + line);
+    // Only switched between runs, the running jobs and the ones still being cancelled hold on to the cache
+    if (!m_jobScheduler->isRunning() && !m_jobScheduler->isCancelling()) {
+      m_jobScheduler->setCacheDirectory(m_reuseResultsButton->isChecked() ? cacheDirectory() : QString());
     }
+
+    m_statusLabel->setText(tr("Running..."));
+    m_jobScheduler->start();
+  } else {
+    // stop running
+    qDebug() << "Kill Simulations";
+    m_jobScheduler->abortAll();
+    m_statusLabel->setText(tr("Cancelling..."));
   }
 }
 
-void MainWindow::onRunProcessErrored(QProcess::ProcessError error) {
-  m_textInfo->setTextColor(Qt::red);
-  m_textInfo->setFontPointSize(18);
-  QString text = tr("onRunProcessErrored: Simulation failed to run, QProcess::ProcessError: ") + QString::number(error);
-  m_textInfo->append(text);
+void MainWindow::onAllJobsFinished(qint64 wallTimeMs) {
+  QString status = tr("Finished in %1 s").arg(wallTimeMs / 1000.0, 0, 'f', 1);
+  if (m_jobScheduler->startupSavedMs() > 0) {
+    status += tr(", %1 s of CLI startup saved by warm workers").arg(m_jobScheduler->startupSavedMs() / 1000.0, 0, 'f', 1);
+  }
+  m_statusLabel->setText(status);
+
+  m_playButton->setChecked(false);
 }
 
-void MainWindow::onRunProcessFinished(int exitCode, QProcess::ExitStatus status) {
-  if (status == QProcess::NormalExit) {
-    qDebug() << "run finished, exit code = " << exitCode;
+void MainWindow::onCancelFinished(int jobCount, int coresReturned, int forcedCount, qint64 latencyMs) {
+  QString status = tr("Cancelled %n job(s) in %1 ms, %2 cores returned", nullptr, jobCount).arg(latencyMs).arg(coresReturned);
+  if (forcedCount > 0) {
+    status += tr(" (%n had to be killed)", nullptr, forcedCount);
   }
-
-  if (exitCode != 0 || status == QProcess::CrashExit) {
-    m_textInfo->setTextColor(Qt::red);
-    m_textInfo->setFontPointSize(18);
-    m_textInfo->append(tr("Simulation failed to run, with exit code ") + QString::number(exitCode));
+  if (coresReturned < jobCount) {
+    status += tr(", %n still had processes running past the deadline", nullptr, jobCount - coresReturned);
   }
+  m_statusLabel->setText(status);
+}
 
-  m_playButton->setChecked(false);
+void MainWindow::scanMeasures() {
+  QStringList workflowPaths{defaultWorkflowJSONPath};
+  for (int row = 0; row < m_jobScheduler->rowCount(); ++row) {
+    workflowPaths << m_jobScheduler->workflowJSONPath(row);
+  }
+  QStringList directories;
+  for (const QString& workflowPath : workflowPaths) {
+    WorkflowFiles files;
+    if (files.load(workflowPath)) {
+      directories << files.measureSearchDirs();
+    }
+  }
 
-  if (m_runSocket) {
-    delete m_runSocket;
+  if (m_measuresScanWatcher->isRunning()) {
+    m_measuresRescan = true;
+    return;
   }
-  m_runSocket = nullptr;
+  // Only the measure.xml files that changed since the last time get parsed, on all cores. With a cold cache that's
+  // every one of them: not something to wait for on the GUI thread
+  m_measuresLabel->setText(tr("Listing measures..."));
+  MeasureLibrary* measureLibrary = m_jobScheduler->measureLibrary();
+  m_measuresScanWatcher->setFuture(QtConcurrent::run([measureLibrary, directories]() { return measureLibrary->scan(directories); }));
 }
 
-void MainWindow::onRunDataReady() {
+void MainWindow::onMeasuresScanned() {
+  if (m_measuresRescan) {
+    m_measuresRescan = false;
+    scanMeasures();
+    return;
+  }
+  const MeasureLibrary::ScanResult result = m_measuresScanWatcher->result();
+  m_measuresLabel->setText(tr("%1 measures, %2 parsed, listed in %3 ms").arg(result.schemas.size()).arg(result.parsedCount).arg(result.elapsedMs));
+
+  auto valueText = [](const QJsonValue& value) {
+    if (value.isBool()) {
+      return value.toBool() ? QStringLiteral("true") : QStringLiteral("false");
+    }
+    return value.isDouble() ? QString::number(value.toDouble()) : value.toString();
+  };
+  m_measuresTree->clear();
+  for (const auto& schema : result.schemas) {
+    auto * measureItem = new QTreeWidgetItem(m_measuresTree, {QFileInfo(schema->directory).fileName(), measureTypeName(schema->measureType)});
+    measureItem->setToolTip(0, schema->error.isEmpty() ? schema->displayName + '\n' + schema->directory : schema->error);
+    if (!schema->error.isEmpty()) {
+      measureItem->setForeground(0, Qt::darkRed);
+    }
+    for (const auto& argument : schema->arguments) {
+      auto * argumentItem =
+        new QTreeWidgetItem(measureItem, {argument.name, measureArgumentTypeName(argument.type), valueText(argument.defaultValue),
+                                          argument.minValue ? QString::number(*argument.minValue) : QString(),
+                                          argument.maxValue ? QString::number(*argument.maxValue) : QString(), argument.required ? tr("yes") : QString()});
+      argumentItem->setToolTip(0, argument.choices.isEmpty() ? argument.displayName : argument.displayName + '\n' + argument.choices.join(", "));
+    }
+  }
 }
@@ -1,13 +1,27 @@
 #ifndef MAINWINDOW_HPP
 #define MAINWINDOW_HPP
 
+#include "jobscheduler.hpp"
+#include "measurelibrary.hpp"
+#include "runlogstore.hpp"
+
 #include <QMainWindow>
-#include <QProcess>
+#include <QMetaObject>
+
+#include <vector>
 
-class QTextEdit;
-class QTcpServer;
-class QTcpSocket;
+class QLabel;
+class QLineEdit;
+class QListView;
+class QSpinBox;
+class QTableView;
+class QTableWidget;
+class QTabWidget;
 class QToolButton;
+class QTreeWidget;
+class TimelineWidget;
+template <typename T>
+class QFutureWatcher;
 
 class MainWindow : public QMainWindow
 {
@@ -19,24 +33,57 @@ public:
 
 private:
     void playButtonClicked(bool t_checked);
+    void addWorkflowsClicked();
+    void openRunLogClicked();
 
-    void onRunProcessFinished(int exitCode, QProcess::ExitStatus status);
+    void onAllJobsFinished(qint64 wallTimeMs);
+    void onCancelFinished(int jobCount, int coresReturned, int forcedCount, qint64 latencyMs);
 
-    void onRunProcessErrored(QProcess::ProcessError error);
+    // Shows the log of the job at that row in the log view
+    void showJobLog(int row);
+    void showLogModel(QAbstractItemModel* logModel);
+    void updatePhaseStatistics();
+    // Lists the measures found next to the default workflow and the queued ones. The scan runs in the background, the
+    // tree is filled by onMeasuresScanned
+    void scanMeasures();
+    void onMeasuresScanned();
 
-    void onNewConnection();
+    RunLogIndex::StyleMask logStyleMask() const;
+    QString logSearchTerm() const;
+    bool isLogFiltered() const;
+    void applyLogFilter();
 
-    void onRunDataReady();
-    void readyReadStandardError();
-    void readyReadStandardOutput();
+    QToolButton* m_playButton;
+    QToolButton* m_addWorkflowsButton;
+    QToolButton* m_openRunLogButton;
+    QSpinBox* m_concurrencySpinBox;
+    QToolButton* m_reuseResultsButton;
+    QLabel* m_statusLabel;
 
+    JobScheduler* m_jobScheduler;
+    QTableView* m_jobsView;
 
-    QTextEdit* m_textInfo;
-    QProcess* m_runProcess;
-    QTcpServer* m_runTcpServer;
-    QTcpSocket* m_runSocket;
-    QToolButton* m_playButton;
-    bool m_hasSocketConnexion = false;
+    std::vector<QToolButton*> m_logLevelButtons;
+    QLineEdit* m_searchLineEdit;
+
+    QTabWidget* m_tabWidget;
+    QListView* m_logView;
+    // For finished runs and filtered views, read back from disk
+    RunLogStoreModel* m_storedLogModel;
+    QMetaObject::Connection m_storeRefreshConnections[2];
+    // Tail following for the log model currently shown
+    QMetaObject::Connection m_logAboutToInsertConnection;
+    QMetaObject::Connection m_logInsertedConnection;
+    bool m_logWasAtBottom = true;
+
+    TimelineWidget* m_timelineWidget;
+    QTableWidget* m_phaseStatisticsTable;
+
+    QLabel* m_measuresLabel;
+    QTreeWidget* m_measuresTree;
+    QFutureWatcher<MeasureLibrary::ScanResult>* m_measuresScanWatcher;
+    // Workflows were added while a scan was running: scan again once it's done
+    bool m_measuresRescan = false;
 
 };
 #endif // MAINWINDOW_HPP
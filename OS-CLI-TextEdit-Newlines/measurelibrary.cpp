@@ -0,0 +1,432 @@
+#include "measurelibrary.hpp"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QMutexLocker>
+#include <QObject>
+#include <QSaveFile>
+#include <QThreadPool>
+#include <QXmlStreamReader>
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+
+// Bump when the schemas change shape, the cache is parsed again from scratch
+static constexpr int CacheVersion = 3;
+
+static MeasureArgument::Type argumentType(QStringView name) {
+  if (name == QLatin1String("Boolean")) {
+    return MeasureArgument::Type::Boolean;
+  } else if (name == QLatin1String("Double")) {
+    return MeasureArgument::Type::Double;
+  } else if (name == QLatin1String("Integer")) {
+    return MeasureArgument::Type::Integer;
+  } else if (name == QLatin1String("String")) {
+    return MeasureArgument::Type::String;
+  } else if (name == QLatin1String("Choice")) {
+    return MeasureArgument::Type::Choice;
+  } else if (name == QLatin1String("Path")) {
+    return MeasureArgument::Type::Path;
+  }
+  return MeasureArgument::Type::Unknown;
+}
+
+static MeasureSchema::MeasureType measureType(QStringView name) {
+  if (name == QLatin1String("ModelMeasure")) {
+    return MeasureSchema::MeasureType::Model;
+  } else if (name == QLatin1String("EnergyPlusMeasure")) {
+    return MeasureSchema::MeasureType::EnergyPlus;
+  } else if (name == QLatin1String("ReportingMeasure")) {
+    return MeasureSchema::MeasureType::Reporting;
+  }
+  return MeasureSchema::MeasureType::Unknown;
+}
+
+QString measureArgumentTypeName(MeasureArgument::Type type) {
+  switch (type) {
+    case MeasureArgument::Type::Boolean:
+      return QStringLiteral("Boolean");
+    case MeasureArgument::Type::Double:
+      return QStringLiteral("Double");
+    case MeasureArgument::Type::Integer:
+      return QStringLiteral("Integer");
+    case MeasureArgument::Type::String:
+      return QStringLiteral("String");
+    case MeasureArgument::Type::Choice:
+      return QStringLiteral("Choice");
+    case MeasureArgument::Type::Path:
+      return QStringLiteral("Path");
+    case MeasureArgument::Type::Unknown:
+      break;
+  }
+  return QStringLiteral("Unknown");
+}
+
+QString measureTypeName(MeasureSchema::MeasureType type) {
+  switch (type) {
+    case MeasureSchema::MeasureType::Model:
+      return QStringLiteral("ModelMeasure");
+    case MeasureSchema::MeasureType::EnergyPlus:
+      return QStringLiteral("EnergyPlusMeasure");
+    case MeasureSchema::MeasureType::Reporting:
+      return QStringLiteral("ReportingMeasure");
+    case MeasureSchema::MeasureType::Unknown:
+      break;
+  }
+  return QStringLiteral("Unknown");
+}
+
+// measure.xml has every value as text
+static QJsonValue typedValue(MeasureArgument::Type type, const QString& text) {
+  switch (type) {
+    case MeasureArgument::Type::Boolean:
+      return QJsonValue(text.compare(QLatin1String("true"), Qt::CaseInsensitive) == 0);
+    case MeasureArgument::Type::Double:
+    case MeasureArgument::Type::Integer: {
+      bool ok = false;
+      const double value = text.toDouble(&ok);
+      return ok ? QJsonValue(value) : QJsonValue(text);
+    }
+    default:
+      break;
+  }
+  return QJsonValue(text);
+}
+
+static std::optional<double> optionalDouble(const QString& text) {
+  bool ok = false;
+  const double value = text.toDouble(&ok);
+  return ok ? std::optional<double>(value) : std::nullopt;
+}
+
+// On an <argument>, up to its end tag
+static MeasureArgument parseArgument(QXmlStreamReader& reader) {
+  MeasureArgument argument;
+  QString defaultText;
+  bool hasDefault = false;
+  QString minText;
+  QString maxText;
+  while (reader.readNextStartElement()) {
+    const QStringView name = reader.name();
+    if (name == QLatin1String("name")) {
+      argument.name = reader.readElementText();
+    } else if (name == QLatin1String("display_name")) {
+      argument.displayName = reader.readElementText();
+    } else if (name == QLatin1String("type")) {
+      argument.type = argumentType(reader.readElementText());
+    } else if (name == QLatin1String("required")) {
+      argument.required = reader.readElementText() == QLatin1String("true");
+    } else if (name == QLatin1String("model_dependent")) {
+      argument.modelDependent = reader.readElementText() == QLatin1String("true");
+    } else if (name == QLatin1String("default_value")) {
+      defaultText = reader.readElementText();
+      hasDefault = true;
+    } else if (name == QLatin1String("min_value")) {
+      minText = reader.readElementText();
+    } else if (name == QLatin1String("max_value")) {
+      maxText = reader.readElementText();
+    } else if (name == QLatin1String("choices")) {
+      while (reader.readNextStartElement()) {
+        if (reader.name() != QLatin1String("choice")) {
+          reader.skipCurrentElement();
+          continue;
+        }
+        QString value;
+        QString displayName;
+        while (reader.readNextStartElement()) {
+          if (reader.name() == QLatin1String("value")) {
+            value = reader.readElementText();
+          } else if (reader.name() == QLatin1String("display_name")) {
+            displayName = reader.readElementText();
+          } else {
+            reader.skipCurrentElement();
+          }
+        }
+        argument.choices << value;
+        argument.choiceDisplayNames << displayName;
+      }
+    } else {
+      reader.skipCurrentElement();
+    }
+  }
+  // Typed last, the type can come after the values
+  if (hasDefault) {
+    argument.defaultValue = typedValue(argument.type, defaultText);
+  }
+  argument.minValue = optionalDouble(minText);
+  argument.maxValue = optionalDouble(maxText);
+  return argument;
+}
+
+MeasureSchema parseMeasureXml(const QByteArray& xml) {
+  MeasureSchema schema;
+  QXmlStreamReader reader(xml);
+  if (!reader.readNextStartElement() || reader.name() != QLatin1String("measure")) {
+    schema.error = QObject::tr("not a measure.xml");
+    return schema;
+  }
+  while (reader.readNextStartElement()) {
+    const QStringView name = reader.name();
+    if (name == QLatin1String("name")) {
+      schema.name = reader.readElementText();
+    } else if (name == QLatin1String("class_name")) {
+      schema.className = reader.readElementText();
+    } else if (name == QLatin1String("display_name")) {
+      schema.displayName = reader.readElementText();
+    } else if (name == QLatin1String("arguments")) {
+      while (reader.readNextStartElement()) {
+        if (reader.name() == QLatin1String("argument")) {
+          schema.arguments.push_back(parseArgument(reader));
+        } else {
+          reader.skipCurrentElement();
+        }
+      }
+    } else if (name == QLatin1String("attributes")) {
+      while (reader.readNextStartElement()) {
+        QString attributeName;
+        QString attributeValue;
+        while (reader.readNextStartElement()) {
+          if (reader.name() == QLatin1String("name")) {
+            attributeName = reader.readElementText();
+          } else if (reader.name() == QLatin1String("value")) {
+            attributeValue = reader.readElementText();
+          } else {
+            reader.skipCurrentElement();
+          }
+        }
+        if (attributeName == QLatin1String("Measure Type")) {
+          schema.measureType = measureType(attributeValue);
+        }
+      }
+    } else {
+      reader.skipCurrentElement();
+    }
+  }
+  if (reader.hasError()) {
+    schema.error = QObject::tr("line %1: %2").arg(reader.lineNumber()).arg(reader.errorString());
+  }
+  return schema;
+}
+
+const MeasureArgument* MeasureSchema::argument(const QString& name) const {
+  const auto it = std::find_if(arguments.cbegin(), arguments.cend(), [&name](const MeasureArgument& argument) { return argument.name == name; });
+  return it == arguments.cend() ? nullptr : &*it;
+}
+
+QJsonObject MeasureSchema::toJson() const {
+  QJsonArray argumentArray;
+  for (const auto& argument : arguments) {
+    QJsonObject object;
+    object["name"] = argument.name;
+    object["display_name"] = argument.displayName;
+    object["type"] = measureArgumentTypeName(argument.type);
+    object["required"] = argument.required;
+    object["model_dependent"] = argument.modelDependent;
+    object["default_value"] = argument.defaultValue;
+    if (argument.minValue) {
+      object["min_value"] = *argument.minValue;
+    }
+    if (argument.maxValue) {
+      object["max_value"] = *argument.maxValue;
+    }
+    if (!argument.choices.isEmpty()) {
+      object["choices"] = QJsonArray::fromStringList(argument.choices);
+      object["choice_display_names"] = QJsonArray::fromStringList(argument.choiceDisplayNames);
+    }
+    argumentArray.append(object);
+  }
+  QJsonObject object;
+  object["directory"] = directory;
+  object["name"] = name;
+  object["class_name"] = className;
+  object["display_name"] = displayName;
+  object["measure_type"] = measureTypeName(measureType);
+  object["arguments"] = argumentArray;
+  object["checksum"] = QString::fromLatin1(checksum);
+  object["error"] = error;
+  return object;
+}
+
+MeasureSchema MeasureSchema::fromJson(const QJsonObject& object) {
+  MeasureSchema schema;
+  schema.directory = object.value("directory").toString();
+  schema.name = object.value("name").toString();
+  schema.className = object.value("class_name").toString();
+  schema.displayName = object.value("display_name").toString();
+  schema.measureType = ::measureType(object.value("measure_type").toString());
+  for (const QJsonValue& value : object.value("arguments").toArray()) {
+    const QJsonObject argumentObject = value.toObject();
+    MeasureArgument argument;
+    argument.name = argumentObject.value("name").toString();
+    argument.displayName = argumentObject.value("display_name").toString();
+    argument.type = argumentType(argumentObject.value("type").toString());
+    argument.required = argumentObject.value("required").toBool();
+    argument.modelDependent = argumentObject.value("model_dependent").toBool();
+    argument.defaultValue = argumentObject.value("default_value").isUndefined() ? QJsonValue() : argumentObject.value("default_value");
+    if (argumentObject.contains("min_value")) {
+      argument.minValue = argumentObject.value("min_value").toDouble();
+    }
+    if (argumentObject.contains("max_value")) {
+      argument.maxValue = argumentObject.value("max_value").toDouble();
+    }
+    const QJsonArray displayNames = argumentObject.value("choice_display_names").toArray();
+    for (const QJsonValue& choice : argumentObject.value("choices").toArray()) {
+      argument.choiceDisplayNames << displayNames.at(argument.choices.size()).toString();
+      argument.choices << choice.toString();
+    }
+    schema.arguments.push_back(argument);
+  }
+  schema.checksum = object.value("checksum").toString().toLatin1();
+  schema.error = object.value("error").toString();
+  return schema;
+}
+
+MeasureLibrary::MeasureLibrary(const QString& cachePath)
+    : m_cachePath(cachePath)
+{
+    load();
+}
+
+MeasureLibrary::~MeasureLibrary()
+{
+    save();
+}
+
+std::shared_ptr<const MeasureSchema> MeasureLibrary::schema(const QString& measureDir) {
+  bool parsed = false;
+  return schema(measureDir, &parsed);
+}
+
+std::shared_ptr<const MeasureSchema> MeasureLibrary::schema(const QString& measureDir, bool* parsed) {
+  *parsed = false;
+  const QString directory = QDir(measureDir).absolutePath();
+  const QFileInfo info(QDir(directory).filePath("measure.xml"));
+  if (!info.isFile()) {
+    return nullptr;
+  }
+  const qint64 modifiedMs = info.lastModified().toMSecsSinceEpoch();
+  {
+    QMutexLocker locker(&m_mutex);
+    const auto it = m_entries.constFind(directory);
+    if (it != m_entries.cend() && it->size == info.size() && it->modifiedMs == modifiedMs) {
+      return it->schema;
+    }
+  }
+
+  // Read and parsed unlocked, that's what the scan has all the threads for
+  QFile file(info.absoluteFilePath());
+  if (!file.open(QIODevice::ReadOnly)) {
+    return nullptr;
+  }
+  const QByteArray xml = file.readAll();
+  const QByteArray checksum = QCryptographicHash::hash(xml, QCryptographicHash::Sha256).toHex();
+  {
+    // Touched, or copied over, but the same content: no need to parse it again
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.find(directory);
+    if (it != m_entries.end() && it->schema->checksum == checksum) {
+      it->size = info.size();
+      it->modifiedMs = modifiedMs;
+      m_changed = true;
+      return it->schema;
+    }
+  }
+
+  auto schema = std::make_shared<MeasureSchema>(parseMeasureXml(xml));
+  schema->directory = directory;
+  schema->checksum = checksum;
+  *parsed = true;
+  QMutexLocker locker(&m_mutex);
+  m_entries.insert(directory, Entry{info.size(), modifiedMs, schema});
+  m_changed = true;
+  return schema;
+}
+
+MeasureLibrary::ScanResult MeasureLibrary::scan(const QStringList& directories) {
+  QElapsedTimer timer;
+  timer.start();
+
+  QStringList measureDirs;
+  for (const QString& directory : directories) {
+    for (const QFileInfo& info : QDir(directory).entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+      measureDirs << info.absoluteFilePath();
+    }
+  }
+  measureDirs.sort();
+  measureDirs.removeDuplicates();
+
+  // Each thread takes the next directory, until there are none left
+  std::vector<std::shared_ptr<const MeasureSchema>> schemas(static_cast<size_t>(measureDirs.size()));
+  std::atomic<qsizetype> next{0};
+  std::atomic<int> parsedCount{0};
+  QThreadPool pool;
+  const int threadCount = static_cast<int>(std::min<qsizetype>(pool.maxThreadCount(), measureDirs.size()));
+  for (int i = 0; i < threadCount; ++i) {
+    pool.start([&]() {
+      for (qsizetype index = next++; index < measureDirs.size(); index = next++) {
+        bool parsed = false;
+        schemas[static_cast<size_t>(index)] = schema(measureDirs[index], &parsed);
+        if (parsed) {
+          ++parsedCount;
+        }
+      }
+    });
+  }
+  pool.waitForDone();
+
+  ScanResult result;
+  // Directories without a measure.xml aren't measures
+  std::copy_if(schemas.begin(), schemas.end(), std::back_inserter(result.schemas), [](const auto& schema) { return schema != nullptr; });
+  result.parsedCount = parsedCount;
+  save();
+  result.elapsedMs = timer.elapsed();
+  return result;
+}
+
+void MeasureLibrary::load() {
+  QFile file(m_cachePath);
+  if (!file.open(QIODevice::ReadOnly)) {
+    return;
+  }
+  const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+  if (root.value("version").toInt() != CacheVersion) {
+    return;
+  }
+  const QJsonObject measures = root.value("measures").toObject();
+  for (auto it = measures.begin(); it != measures.end(); ++it) {
+    const QJsonObject object = it.value().toObject();
+    auto schema = std::make_shared<MeasureSchema>(MeasureSchema::fromJson(object.value("schema").toObject()));
+    m_entries.insert(it.key(), Entry{object.value("size").toInteger(-1), object.value("mtime_ms").toInteger(-1), schema});
+  }
+}
+
+void MeasureLibrary::save() {
+  QMutexLocker locker(&m_mutex);
+  if (!m_changed) {
+    return;
+  }
+  QJsonObject measures;
+  for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it) {
+    QJsonObject object;
+    object["size"] = it->size;
+    object["mtime_ms"] = it->modifiedMs;
+    object["schema"] = it->schema->toJson();
+    measures[it.key()] = object;
+  }
+  QJsonObject root;
+  root["version"] = CacheVersion;
+  root["measures"] = measures;
+
+  QDir().mkpath(QFileInfo(m_cachePath).absolutePath());
+  QSaveFile file(m_cachePath);
+  if (file.open(QIODevice::WriteOnly) && file.write(QJsonDocument(root).toJson(QJsonDocument::Compact)) >= 0 && file.commit()) {
+    m_changed = false;
+  }
+}
@@ -0,0 +1,128 @@
+#ifndef MEASURELIBRARY_HPP
+#define MEASURELIBRARY_HPP
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+// One argument of a measure, as declared in its measure.xml
+struct MeasureArgument
+{
+  enum class Type
+  {
+    Boolean,
+    Double,
+    Integer,
+    String,
+    Choice,
+    Path,
+    Unknown
+  };
+
+  QString name;
+  QString displayName;
+  Type type = Type::Unknown;
+  bool required = false;
+  // Null when there's none. Typed after the argument: bool, double or string
+  QJsonValue defaultValue;
+  std::optional<double> minValue;
+  std::optional<double> maxValue;
+  // Choice only. The CLI takes a choice's display name too, empty when it has none: same size as choices
+  QStringList choices;
+  QStringList choiceDisplayNames;
+  // Its choices come from the model (eg its space types): those in measure.xml are only the ones of an empty model
+  bool modelDependent = false;
+};
+
+// What the runner needs to know about a measure without running it: its type and its arguments
+struct MeasureSchema
+{
+  enum class MeasureType
+  {
+    Model,
+    EnergyPlus,
+    Reporting,
+    Unknown
+  };
+
+  QString directory;
+  QString name;
+  QString className;
+  QString displayName;
+  MeasureType measureType = MeasureType::Unknown;
+  std::vector<MeasureArgument> arguments;
+  // Hex SHA-256 of the measure.xml it was parsed from
+  QByteArray checksum;
+  // Why measure.xml couldn't be parsed, empty when it could
+  QString error;
+
+  const MeasureArgument* argument(const QString& name) const;
+
+  QJsonObject toJson() const;
+  static MeasureSchema fromJson(const QJsonObject& object);
+};
+
+QString measureArgumentTypeName(MeasureArgument::Type type);
+QString measureTypeName(MeasureSchema::MeasureType type);
+
+// Parses the content of a measure.xml
+MeasureSchema parseMeasureXml(const QByteArray& xml);
+
+// The measure.xml of every measure the runner has come across, parsed once: a schema is kept along with the checksum of
+// the file it came from, and the file's size and mtime. A measure.xml only gets read again once they change, and only
+// gets parsed again if its checksum changed too. Kept in a JSON file across sessions.
+// Thread safe: the scan parses on all cores, and the RunWorkers look measures up from their own threads.
+class MeasureLibrary
+{
+public:
+    struct ScanResult
+    {
+      std::vector<std::shared_ptr<const MeasureSchema>> schemas;
+      // Measures whose measure.xml had to be parsed, the others came from the cache
+      int parsedCount = 0;
+      qint64 elapsedMs = 0;
+    };
+
+    explicit MeasureLibrary(const QString& cachePath);
+    ~MeasureLibrary();
+
+    MeasureLibrary(const MeasureLibrary&) = delete;
+    MeasureLibrary& operator=(const MeasureLibrary&) = delete;
+
+    // Null if the directory has no measure.xml
+    std::shared_ptr<const MeasureSchema> schema(const QString& measureDir);
+
+    // Every measure directly under those directories, sorted by directory
+    ScanResult scan(const QStringList& directories);
+
+    // Writes the schemas parsed since the last time
+    void save();
+
+private:
+    struct Entry
+    {
+      qint64 size = -1;
+      qint64 modifiedMs = -1;
+      std::shared_ptr<const MeasureSchema> schema;
+    };
+
+    // parsed tells whether it took a parse, rather than the cache
+    std::shared_ptr<const MeasureSchema> schema(const QString& measureDir, bool* parsed);
+    void load();
+
+    QString m_cachePath;
+    QMutex m_mutex;
+    // By absolute measure directory
+    QHash<QString, Entry> m_entries;
+    bool m_changed = false;
+};
+
+#endif // MEASURELIBRARY_HPP
@@ -0,0 +1,210 @@
+#include "osmfile.hpp"
+
+#include <QObject>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+enum CharClass : unsigned char
+{
+  Value,
+  Space,
+  Comma,
+  Semicolon,
+  Comment
+};
+
+constexpr std::array<unsigned char, 256> makeCharClasses() {
+  std::array<unsigned char, 256> classes{};
+  classes[static_cast<unsigned char>(' ')] = Space;
+  classes[static_cast<unsigned char>('\t')] = Space;
+  classes[static_cast<unsigned char>('\r')] = Space;
+  classes[static_cast<unsigned char>('\n')] = Space;
+  classes[static_cast<unsigned char>(',')] = Comma;
+  classes[static_cast<unsigned char>(';')] = Semicolon;
+  classes[static_cast<unsigned char>('!')] = Comment;
+  return classes;
+}
+
+constexpr std::array<unsigned char, 256> CharClasses = makeCharClasses();
+
+}  // namespace
+
+static const std::vector<int> NoObjects;
+
+bool OsmFile::load(const QString& path, QString* error, int maxObjects) {
+  auto fail = [this, error](const QString& message) {
+    m_fields.clear();
+    m_objects.clear();
+    if (error) {
+      *error = message;
+    }
+    return false;
+  };
+
+  m_handles.clear();
+  m_objectsByType.clear();
+  m_types.clear();
+  m_fields.clear();
+  m_objects.clear();
+  m_content.clear();
+  m_file.close();
+  m_file.setFileName(path);
+  if (!m_file.open(QIODevice::ReadOnly)) {
+    return fail(QObject::tr("Cannot open %1").arg(path));
+  }
+  // Field spans are 32 bits, that's still 40x the largest models around
+  if (m_file.size() > std::numeric_limits<quint32>::max()) {
+    return fail(QObject::tr("%1 is too large").arg(path));
+  }
+  if (const uchar* mapped = m_file.size() > 0 ? m_file.map(0, m_file.size()) : nullptr) {
+    m_data = reinterpret_cast<const char*>(mapped);
+    m_size = m_file.size();
+  } else {
+    m_content = m_file.readAll();
+    m_data = m_content.constData();
+    m_size = m_content.size();
+  }
+
+  // About one field per 45 bytes, and 12 fields per object, in the models we have
+  if (maxObjects < 0) {
+    m_fields.reserve(static_cast<size_t>(m_size / 40));
+    m_objects.reserve(static_cast<size_t>(m_size / 500));
+  }
+
+  const char* const begin = m_data;
+  // Moved up to the end of the last object wanted, with maxObjects
+  const char* end = m_data + m_size;
+  const char* p = begin;
+  // Of the field being read, null until it has something else than whitespace
+  const char* valueBegin = nullptr;
+  const char* valueEnd = nullptr;
+  bool inObject = false;
+  auto addField = [&]() {
+    const Span span{valueBegin ? static_cast<quint32>(valueBegin - begin) : static_cast<quint32>(p - begin),
+                    valueBegin ? static_cast<quint32>(valueEnd - valueBegin) : 0u};
+    m_fields.push_back(span);
+    valueBegin = nullptr;
+  };
+
+  while (p < end) {
+    switch (CharClasses[static_cast<unsigned char>(*p)]) {
+      case Value:
+        if (!valueBegin) {
+          valueBegin = p;
+        }
+        // Runs of value characters, spaces inside a value included, in one go
+        do {
+          ++p;
+        } while (p < end && CharClasses[static_cast<unsigned char>(*p)] == Value);
+        valueEnd = p;
+        continue;
+      case Space:
+        break;
+      case Comment: {
+        const auto* newline = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        p = newline ? newline : end;
+        continue;
+      }
+      case Comma:
+      case Semicolon:
+        if (!inObject) {
+          if (!valueBegin) {
+            const int line = static_cast<int>(std::count(begin, p, '\n')) + 1;
+            return fail(QObject::tr("%1, line %2: '%3' without an object type").arg(path).arg(line).arg(QChar(*p)));
+          }
+          m_objects.push_back(Object{static_cast<quint32>(m_fields.size()), 0});
+          inObject = true;
+          addField();
+        } else {
+          addField();
+          ++m_objects.back().fieldCount;
+        }
+        if (*p == ';') {
+          inObject = false;
+          if (maxObjects >= 0 && objectCount() >= maxObjects) {
+            end = p + 1;
+          }
+        }
+        break;
+    }
+    ++p;
+  }
+
+  if (inObject || valueBegin) {
+    return fail(QObject::tr("%1: the last object has no ';'").arg(path));
+  }
+  buildIndexes();
+  return true;
+}
+
+void OsmFile::buildIndexes() {
+  m_handles.reserve(static_cast<qsizetype>(m_objects.size()));
+  for (int object = 0; object < objectCount(); ++object) {
+    const QByteArrayView objectHandle = handle(object);
+    if (!objectHandle.isEmpty()) {
+      // A duplicate handle is a broken model, the first object wins like it does in OpenStudio
+      if (!m_handles.contains(objectHandle)) {
+        m_handles.insert(objectHandle, object);
+      }
+    }
+    const QByteArrayView objectType = type(object);
+    auto it = m_objectsByType.find(objectType);
+    if (it == m_objectsByType.end()) {
+      it = m_objectsByType.insert(objectType, {});
+      m_types << objectType;
+    }
+    it->push_back(object);
+  }
+}
+
+QByteArrayView OsmFile::view(const Span& span) const {
+  return QByteArrayView(m_data + span.offset, span.size);
+}
+
+int OsmFile::objectCount() const {
+  return static_cast<int>(m_objects.size());
+}
+
+QByteArrayView OsmFile::type(int object) const {
+  return view(m_fields[m_objects[static_cast<size_t>(object)].firstField]);
+}
+
+int OsmFile::fieldCount(int object) const {
+  return static_cast<int>(m_objects[static_cast<size_t>(object)].fieldCount);
+}
+
+QByteArrayView OsmFile::field(int object, int index) const {
+  const Object& o = m_objects[static_cast<size_t>(object)];
+  if (index < 0 || static_cast<quint32>(index) >= o.fieldCount) {
+    return QByteArrayView();
+  }
+  return view(m_fields[o.firstField + 1 + static_cast<quint32>(index)]);
+}
+
+QByteArrayView OsmFile::handle(int object) const {
+  const QByteArrayView first = field(object, 0);
+  return first.startsWith('{') ? first : QByteArrayView();
+}
+
+int OsmFile::lineNumber(int object) const {
+  const char* objectBegin = type(object).data();
+  return static_cast<int>(std::count(m_data, objectBegin, '\n')) + 1;
+}
+
+int OsmFile::objectByHandle(QByteArrayView objectHandle) const {
+  return m_handles.value(objectHandle, -1);
+}
+
+const std::vector<int>& OsmFile::objectsOfType(QByteArrayView objectType) const {
+  const auto it = m_objectsByType.constFind(objectType);
+  return it == m_objectsByType.cend() ? NoObjects : *it;
+}
+
+QList<QByteArrayView> OsmFile::types() const {
+  return m_types;
+}
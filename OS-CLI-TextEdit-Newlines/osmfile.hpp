@@ -0,0 +1,83 @@
+#ifndef OSMFILE_HPP
+#define OSMFILE_HPP
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+#include <vector>
+
+// An OpenStudio model (.osm), readable without the OpenStudio SDK: objects, their fields, and lookups by handle and by
+// type. The file is memory mapped and tokenized in a single pass, fields are kept as spans into the mapping rather than
+// copied, so everything handed out is a view that lives as long as the OsmFile.
+//
+//   OS:Surface,
+//     {2f8e...},             !- Handle         <- field 0
+//     Surface 1,             !- Name           <- field 1
+//     ...;
+//
+// Comments ("!" to the end of the line) and the whitespace around the fields are left out.
+class OsmFile
+{
+public:
+    OsmFile() = default;
+    OsmFile(const OsmFile&) = delete;
+    OsmFile& operator=(const OsmFile&) = delete;
+
+    // False if the file can't be read or isn't valid IDF syntax, with the reason in error. With maxObjects, stops after
+    // that many objects: only the head of the file gets read, the rest isn't checked
+    bool load(const QString& path, QString* error = nullptr, int maxObjects = -1);
+
+    int objectCount() const;
+    // eg "OS:Surface"
+    QByteArrayView type(int object) const;
+    // Fields after the type
+    int fieldCount(int object) const;
+    // Empty for a field that's empty, or past fieldCount
+    QByteArrayView field(int object, int index) const;
+    // "{uuid}", the object's first field. Empty for the few IDF objects that have none
+    QByteArrayView handle(int object) const;
+    // 1-based line the object starts on, counted on demand
+    int lineNumber(int object) const;
+
+    // O(1), -1 if no object has that handle. With its braces, as it's written in the model
+    int objectByHandle(QByteArrayView handle) const;
+    // Objects of that type in file order, empty if there are none
+    const std::vector<int>& objectsOfType(QByteArrayView type) const;
+    // Every type in the model, in the order they first appear
+    QList<QByteArrayView> types() const;
+
+private:
+    struct Span
+    {
+      quint32 offset = 0;
+      quint32 size = 0;
+    };
+
+    struct Object
+    {
+      // m_fields[firstField] is the type, the fields follow
+      quint32 firstField = 0;
+      quint32 fieldCount = 0;
+    };
+
+    QByteArrayView view(const Span& span) const;
+    void buildIndexes();
+
+    QFile m_file;
+    // Only used when the file can't be mapped
+    QByteArray m_content;
+    const char* m_data = nullptr;
+    qsizetype m_size = 0;
+
+    std::vector<Span> m_fields;
+    std::vector<Object> m_objects;
+    QHash<QByteArrayView, int> m_handles;
+    QHash<QByteArrayView, std::vector<int>> m_objectsByType;
+    QList<QByteArrayView> m_types;
+};
+
+#endif // OSMFILE_HPP
@@ -0,0 +1,105 @@
+#include "processtree.hpp"
+
+#include <QTimer>
+
+#if defined(Q_OS_UNIX)
+#  include <cerrno>
+#  include <csignal>
+#  include <unistd.h>
+#endif
+
+// Short enough that the cancel latency is what it takes the tree to go, not what it takes to notice
+static constexpr int PollIntervalMs = 5;
+
+void startInOwnProcessGroup(QProcess* process) {
+#if defined(Q_OS_UNIX)
+  // Runs in the child between fork and exec: only async-signal-safe calls here
+  process->setChildProcessModifier([]() { ::setpgid(0, 0); });
+#else
+  Q_UNUSED(process);
+#endif
+}
+
+#if defined(Q_OS_UNIX)
+static bool signalGroup(qint64 pid, int signal) {
+  // The group is the leader's pid
+  return pid > 0 && ::kill(-static_cast<pid_t>(pid), signal) == 0;
+}
+#endif
+
+void killProcessTree(QProcess* process) {
+#if defined(Q_OS_UNIX)
+  if (signalGroup(process->processId(), SIGKILL)) {
+    return;
+  }
+#endif
+  process->kill();
+}
+
+ProcessTreeTerminator::ProcessTreeTerminator(QObject *parent)
+    : QObject(parent)
+{
+    m_pollTimer = new QTimer(this);
+    m_pollTimer->setInterval(PollIntervalMs);
+    connect(m_pollTimer, &QTimer::timeout, this, &ProcessTreeTerminator::poll);
+}
+
+void ProcessTreeTerminator::terminate(QProcess* process, int gracePeriodMs, int deadlineMs) {
+  m_process = process;
+  // Kept aside: the process may be reaped, and the QProcess deleted, while its children are still around
+  m_pid = process->processId();
+  m_gracePeriodMs = gracePeriodMs;
+  m_deadlineMs = deadlineMs;
+  m_forced = false;
+  m_timer.start();
+
+#if defined(Q_OS_UNIX)
+  if (!signalGroup(m_pid, SIGTERM)) {
+    // Not a group leader after all: at least the process itself
+    process->terminate();
+  }
+#else
+  // Nothing graceful to send a console process from here
+  process->kill();
+  m_forced = true;
+#endif
+  m_pollTimer->start();
+  poll();
+}
+
+bool ProcessTreeTerminator::isTreeAlive() const {
+#if defined(Q_OS_UNIX)
+  // Signal 0 only checks that something in the group is still there. EPERM: it is, just not ours to signal
+  if (m_pid > 0 && (::kill(-static_cast<pid_t>(m_pid), 0) == 0 || errno == EPERM)) {
+    return true;
+  }
+#endif
+  return m_process && m_process->state() != QProcess::NotRunning;
+}
+
+void ProcessTreeTerminator::poll() {
+  if (!isTreeAlive()) {
+    finish(true);
+    return;
+  }
+  const qint64 elapsed = m_timer.elapsed();
+  if (elapsed >= m_deadlineMs) {
+    finish(false);
+    return;
+  }
+  if (!m_forced && elapsed >= m_gracePeriodMs) {
+    m_forced = true;
+#if defined(Q_OS_UNIX)
+    signalGroup(m_pid, SIGKILL);
+#endif
+    if (m_process) {
+      m_process->kill();
+    }
+  }
+}
+
+void ProcessTreeTerminator::finish(bool complete) {
+  m_pollTimer->stop();
+  emit finished(m_timer.elapsed(), m_forced, complete);
+  deleteLater();
+}
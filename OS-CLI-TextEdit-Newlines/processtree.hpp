@@ -0,0 +1,55 @@
+#ifndef PROCESSTREE_HPP
+#define PROCESSTREE_HPP
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QPointer>
+#include <QProcess>
+
+class QTimer;
+
+// Makes the process the leader of a process group of its own once started, so everything it starts (the CLI's
+// EnergyPlus, ...) can be signalled along with it. Call before QProcess::start. Unix only, a no-op elsewhere
+void startInOwnProcessGroup(QProcess* process);
+
+// SIGKILL to the process and everything in its group, right away. Falls back to QProcess::kill where there are no
+// process groups
+void killProcessTree(QProcess* process);
+
+// Stops a process and the whole tree it started, within a bounded time: SIGTERM to its process group so the CLI and
+// EnergyPlus get to exit cleanly, then SIGKILL to whatever is left of the group once the grace period is over. The
+// group is polled until it's empty or the deadline is past.
+// Asynchronous: works from any thread with an event loop, and deletes itself once finished is out.
+class ProcessTreeTerminator : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DefaultGracePeriodMs = 1000;
+    static constexpr int DefaultDeadlineMs = 3000;
+
+    explicit ProcessTreeTerminator(QObject *parent = nullptr);
+
+    // process must have been started with startInOwnProcessGroup for its children to be stopped too
+    void terminate(QProcess* process, int gracePeriodMs = DefaultGracePeriodMs, int deadlineMs = DefaultDeadlineMs);
+
+signals:
+    // latencyMs: from terminate() until the last process of the tree was gone. forced: some of it had to be killed.
+    // complete: false if something was still there at the deadline
+    void finished(qint64 latencyMs, bool forced, bool complete);
+
+private:
+    void poll();
+    bool isTreeAlive() const;
+    void finish(bool complete);
+
+    QPointer<QProcess> m_process;
+    qint64 m_pid = 0;
+    int m_gracePeriodMs = DefaultGracePeriodMs;
+    int m_deadlineMs = DefaultDeadlineMs;
+    bool m_forced = false;
+    QElapsedTimer m_timer;
+    QTimer* m_pollTimer;
+};
+
+#endif // PROCESSTREE_HPP
@@ -0,0 +1,255 @@
+#include "resultcache.hpp"
+#include "filehashcache.hpp"
+#include "runlogstore.hpp"
+#include "workflowfiles.hpp"
+
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QUuid>
+
+#include <algorithm>
+
+static const QString EntryFileName = QStringLiteral("entry.json");
+static const QString LogBaseName = QStringLiteral("log");
+static const QString OutputsDirName = QStringLiteral("outputs");
+// What the CLI writes next to the OSW
+static const QStringList OutputDirNames = {"run", "reports"};
+// Bump when the key stops meaning the same thing
+static constexpr int KeyVersion = 1;
+// Least recently used entries go past either: a run's outputs (eplusout.sql, ...) easily take hundreds of MB
+static constexpr int MaxEntries = 100;
+static constexpr qint64 MaxBytes = qint64(10) * 1024 * 1024 * 1024;
+
+static QStringList logStorePaths(const QString& basePath) {
+  return {RunLogWriter::segmentPath(basePath), RunLogWriter::indexPath(basePath), RunLogWriter::signaturePath(basePath)};
+}
+
+// Replaces whatever was at destination. Adds the size of what was copied to bytes, if given
+static bool copyDirectory(const QString& source, const QString& destination, qint64* bytes = nullptr) {
+  QDir(destination).removeRecursively();
+  if (!QDir().mkpath(destination)) {
+    return false;
+  }
+  QDirIterator it(source, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden, QDirIterator::Subdirectories);
+  const QDir sourceDir(source);
+  const QDir destinationDir(destination);
+  while (it.hasNext()) {
+    const QString path = it.next();
+    const QString target = destinationDir.filePath(sourceDir.relativeFilePath(path));
+    if (it.fileInfo().isDir()) {
+      if (!QDir().mkpath(target)) {
+        return false;
+      }
+    } else if (!QFile::copy(path, target)) {
+      return false;
+    } else if (bytes) {
+      *bytes += it.fileInfo().size();
+    }
+  }
+  return true;
+}
+
+static qint64 directorySize(const QString& path) {
+  qint64 bytes = 0;
+  QDirIterator it(path, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+  while (it.hasNext()) {
+    it.next();
+    bytes += it.fileInfo().size();
+  }
+  return bytes;
+}
+
+WorkflowResultCache::WorkflowResultCache(const QString& directory, FileHashCache* fileHashes)
+    : m_directory(directory), m_fileHashes(fileHashes)
+{
+    QDir().mkpath(m_directory);
+}
+
+QString WorkflowResultCache::directory() const {
+  return m_directory;
+}
+
+QString WorkflowResultCache::computeKey(const QString& workflowJSONPath, const QString& program) {
+  WorkflowFiles files;
+  if (!files.load(workflowJSONPath)) {
+    return QString();
+  }
+
+  // Tagged, so eg a missing weather file and a missing seed don't hash the same
+  QCryptographicHash key(QCryptographicHash::Sha256);
+  auto addPart = [&key](const QByteArray& tag, const QByteArray& hash) {
+    key.addData(tag);
+    key.addData(QByteArrayView("\n"));
+    key.addData(hash.isEmpty() ? QByteArray("missing") : hash);
+    key.addData(QByteArrayView("\n"));
+  };
+
+  addPart("version", QByteArray::number(KeyVersion));
+  addPart("workflow", m_fileHashes->fileHash(files.workflowPath));
+  addPart("seed", files.seedPath.isEmpty() ? QByteArray() : m_fileHashes->fileHash(files.seedPath));
+  addPart("weather", files.weatherPath.isEmpty() ? QByteArray() : m_fileHashes->fileHash(files.weatherPath));
+  for (const auto& step : files.steps) {
+    addPart("measure " + step.measureDirName.toUtf8(), step.measureDir.isEmpty() ? QByteArray() : m_fileHashes->measureHash(step.measureDir));
+  }
+  addPart("cli", FileHashCache::programHash(program));
+
+  m_fileHashes->save();
+  return QString::fromLatin1(key.result().toHex());
+}
+
+bool WorkflowResultCache::lookup(const QString& key, Entry* entry) const {
+  if (key.isEmpty()) {
+    return false;
+  }
+  const QString entryDir = QDir(m_directory).filePath(key);
+  QFile file(QDir(entryDir).filePath(EntryFileName));
+  if (!file.open(QIODevice::ReadOnly)) {
+    return false;
+  }
+  const QJsonObject object = QJsonDocument::fromJson(file.readAll()).object();
+  if (object.value("key").toString() != key) {
+    return false;
+  }
+  entry->key = key;
+  entry->directory = entryDir;
+  entry->workflowJSONPath = object.value("workflow").toString();
+  entry->createdAt = QDateTime::fromString(object.value("created_at").toString(), Qt::ISODateWithMs);
+  entry->elapsedMs = object.value("elapsed_ms").toInteger(-1);
+  entry->lineCount = object.value("lines").toInteger();
+  file.close();
+  // Recently used, as far as prune() is concerned
+  if (file.open(QIODevice::ReadWrite)) {
+    file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+  }
+  return true;
+}
+
+bool WorkflowResultCache::restore(const Entry& entry, const QString& workflowJSONPath, const QString& logBasePath) const {
+  const QDir outputsDir(QDir(entry.directory).filePath(OutputsDirName));
+  const QDir workflowDir = QFileInfo(workflowJSONPath).absoluteDir();
+  for (const QString& name : OutputDirNames) {
+    if (outputsDir.exists(name) && !copyDirectory(outputsDir.filePath(name), workflowDir.filePath(name))) {
+      qDebug() << "Could not restore" << name << "from the result cache to" << workflowDir.filePath(name);
+      return false;
+    }
+  }
+
+  if (logBasePath.isEmpty()) {
+    return true;
+  }
+  QDir().mkpath(QFileInfo(logBasePath).absolutePath());
+  const QStringList sources = logStorePaths(QDir(entry.directory).filePath(LogBaseName));
+  const QStringList targets = logStorePaths(logBasePath);
+  for (int i = 0; i < sources.size(); ++i) {
+    QFile::remove(targets[i]);
+    // The signatures are optional, the rest isn't
+    if (QFile::exists(sources[i]) && !QFile::copy(sources[i], targets[i])) {
+      qDebug() << "Could not restore" << sources[i] << "from the result cache to" << targets[i];
+      return false;
+    }
+  }
+  return true;
+}
+
+bool WorkflowResultCache::store(const QString& key, const QString& workflowJSONPath, const QString& logBasePath, qint64 elapsedMs,
+                                qint64 lineCount) {
+  if (key.isEmpty()) {
+    return false;
+  }
+  // Filled aside then renamed into place: a lookup never sees half an entry, and two jobs storing the same key can't mix
+  const QDir cacheDir(m_directory);
+  const QString tempDir = cacheDir.filePath(key + ".tmp-" + QUuid::createUuid().toString(QUuid::WithoutBraces));
+  auto fail = [&tempDir](const QString& what) {
+    qDebug() << "Could not store the run in the result cache:" << what;
+    QDir(tempDir).removeRecursively();
+    return false;
+  };
+  if (!QDir().mkpath(tempDir)) {
+    return fail(tempDir);
+  }
+
+  qint64 bytes = 0;
+  const QDir workflowDir = QFileInfo(workflowJSONPath).absoluteDir();
+  for (const QString& name : OutputDirNames) {
+    if (workflowDir.exists(name) && !copyDirectory(workflowDir.filePath(name), QDir(tempDir).filePath(OutputsDirName + '/' + name), &bytes)) {
+      return fail(workflowDir.filePath(name));
+    }
+  }
+  if (!logBasePath.isEmpty()) {
+    const QStringList sources = logStorePaths(logBasePath);
+    const QStringList targets = logStorePaths(QDir(tempDir).filePath(LogBaseName));
+    for (int i = 0; i < sources.size(); ++i) {
+      if (QFile::exists(sources[i])) {
+        if (!QFile::copy(sources[i], targets[i])) {
+          return fail(sources[i]);
+        }
+        bytes += QFileInfo(sources[i]).size();
+      }
+    }
+  }
+
+  QJsonObject object;
+  object["key"] = key;
+  object["workflow"] = QFileInfo(workflowJSONPath).absoluteFilePath();
+  object["created_at"] = QDateTime::currentDateTime().toString(Qt::ISODateWithMs);
+  object["elapsed_ms"] = elapsedMs;
+  object["lines"] = lineCount;
+  object["bytes"] = bytes;
+  QFile file(QDir(tempDir).filePath(EntryFileName));
+  if (!file.open(QIODevice::WriteOnly) || file.write(QJsonDocument(object).toJson()) < 0) {
+    return fail(file.fileName());
+  }
+  file.close();
+
+  // Replaces an older entry for the same key: its inputs hash the same, so it's the same run
+  const QString entryDir = cacheDir.filePath(key);
+  QMutexLocker locker(&m_mutex);
+  QDir(entryDir).removeRecursively();
+  if (!cacheDir.rename(QFileInfo(tempDir).fileName(), key)) {
+    locker.unlock();
+    return fail(entryDir);
+  }
+  prune();
+  return true;
+}
+
+void WorkflowResultCache::prune() {
+  // By the time of their entry.json, which lookup() touches: newest first
+  QFileInfoList entries;
+  for (const QFileInfo& dir : QDir(m_directory).entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+    // Being stored, not an entry yet
+    if (dir.fileName().contains(".tmp-")) {
+      continue;
+    }
+    entries << QFileInfo(QDir(dir.absoluteFilePath()).filePath(EntryFileName));
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const QFileInfo& a, const QFileInfo& b) { return a.lastModified() > b.lastModified(); });
+
+  qint64 totalBytes = 0;
+  for (qsizetype i = 0; i < entries.size(); ++i) {
+    const QString entryDir = entries[i].absolutePath();
+    qint64 bytes = -1;
+    QFile file(entries[i].absoluteFilePath());
+    if (file.open(QIODevice::ReadOnly)) {
+      bytes = QJsonDocument::fromJson(file.readAll()).object().value("bytes").toInteger(-1);
+    }
+    if (bytes < 0) {
+      // Stored before entries knew their size
+      bytes = directorySize(entryDir);
+    }
+    // The newest one stays, however big
+    if (i > 0 && (i >= MaxEntries || totalBytes + bytes > MaxBytes)) {
+      QDir(entryDir).removeRecursively();
+    } else {
+      totalBytes += bytes;
+    }
+  }
+}
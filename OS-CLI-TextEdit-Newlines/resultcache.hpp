@@ -0,0 +1,58 @@
+#ifndef RESULTCACHE_HPP
+#define RESULTCACHE_HPP
+
+#include <QDateTime>
+#include <QMutex>
+#include <QString>
+
+class FileHashCache;
+
+// Results of the successful runs, keyed by everything that goes into one: the OSW, its seed model and weather file, each
+// measure it uses (measure.rb, measure.xml and resources/) and the CLI itself. Running an identical workflow again
+// restores the outputs and the run log of the previous run instead of launching the CLI.
+//
+// On disk, under the cache directory:
+//   <key>/entry.json       what was run, when, and how long it took
+//   <key>/log.*            the run's RunLogStore
+//   <key>/outputs/         copies of the run/ and reports/ directories the CLI wrote next to the OSW
+// Only the most recently used entries are kept, see MaxEntries and MaxBytes in resultcache.cpp.
+// The RunWorkers of all the jobs share one: every method is thread safe.
+class WorkflowResultCache
+{
+public:
+    struct Entry
+    {
+      QString key;
+      QString directory;
+      QString workflowJSONPath;
+      QDateTime createdAt;
+      qint64 elapsedMs = -1;
+      qint64 lineCount = 0;
+    };
+
+    // Inputs are hashed through fileHashes, which must outlive the cache
+    WorkflowResultCache(const QString& directory, FileHashCache* fileHashes);
+
+    QString directory() const;
+
+    // Hex SHA-256 of all the inputs, empty if the OSW can't be read. Only files that changed since the last call get read
+    QString computeKey(const QString& workflowJSONPath, const QString& program);
+
+    // A hit counts as a use: the least recently used entries are the first to go once the cache is full
+    bool lookup(const QString& key, Entry* entry) const;
+    // Puts the outputs back next to the OSW, and the log at logBasePath
+    bool restore(const Entry& entry, const QString& workflowJSONPath, const QString& logBasePath) const;
+    // Takes the outputs the CLI just wrote next to the OSW, and the (closed) store at logBasePath
+    bool store(const QString& key, const QString& workflowJSONPath, const QString& logBasePath, qint64 elapsedMs, qint64 lineCount);
+
+private:
+    QString m_directory;
+    FileHashCache* m_fileHashes;
+    // Only keeps the most recently used entries, under MaxEntries and MaxBytes. Called with m_mutex held
+    void prune();
+
+    // Around replacing an entry
+    QMutex m_mutex;
+};
+
+#endif // RESULTCACHE_HPP
@@ -0,0 +1,40 @@
+#include "runlogdelegate.hpp"
+
+#include <QFontMetrics>
+#include <QPainter>
+#include <QStyle>
+
+#include <algorithm>
+
+RunLogDelegate::RunLogDelegate(const QFont& baseFont, QObject *parent)
+    : QStyledItemDelegate(parent)
+{
+    for (int i = 0; i < LogStyleCount; ++i) {
+        const auto style = static_cast<LogStyle>(i);
+        QFont font(baseFont);
+        font.setPointSize(logStylePointSize(style));
+        m_fonts[i] = font;
+        m_colors[i] = logStyleColor(style);
+        m_rowHeight = std::max(m_rowHeight, QFontMetrics(font).height() + 2);
+    }
+}
+
+void RunLogDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const {
+  const int styleIndex = index.data(RunLogModel::StyleRole).toInt();
+  const QString text = index.data(Qt::DisplayRole).toString();
+
+  painter->save();
+  if (option.state & QStyle::State_Selected) {
+    painter->fillRect(option.rect, option.palette.highlight());
+    painter->setPen(option.palette.highlightedText().color());
+  } else {
+    painter->setPen(m_colors[styleIndex]);
+  }
+  painter->setFont(m_fonts[styleIndex]);
+  painter->drawText(option.rect.adjusted(4, 0, -4, 0), Qt::AlignLeft | Qt::AlignVCenter | Qt::TextSingleLine, text);
+  painter->restore();
+}
+
+QSize RunLogDelegate::sizeHint(const QStyleOptionViewItem& /*option*/, const QModelIndex& /*index*/) const {
+  return {0, m_rowHeight};
+}
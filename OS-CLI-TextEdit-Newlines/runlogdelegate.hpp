@@ -0,0 +1,29 @@
+#ifndef RUNLOGDELEGATE_HPP
+#define RUNLOGDELEGATE_HPP
+
+#include "runlogmodel.hpp"
+
+#include <QFont>
+#include <QStyledItemDelegate>
+
+#include <array>
+
+// Paints one run log row with the font / color of its LogStyle. All rows share the same height (the tallest style),
+// so the view can be set to uniformItemSizes and never has to measure rows that are not on screen.
+class RunLogDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    explicit RunLogDelegate(const QFont& baseFont, QObject *parent = nullptr);
+
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+    QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+private:
+    std::array<QFont, LogStyleCount> m_fonts;
+    std::array<QColor, LogStyleCount> m_colors;
+    int m_rowHeight = 0;
+};
+
+#endif // RUNLOGDELEGATE_HPP
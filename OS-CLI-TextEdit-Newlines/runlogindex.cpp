@@ -0,0 +1,102 @@
+#include "runlogindex.hpp"
+
+#include <array>
+#include <cstring>
+
+static constexpr std::array<unsigned char, 256> makeFoldTable() {
+  std::array<unsigned char, 256> table{};
+  for (int c = 0; c < 256; ++c) {
+    table[c] = static_cast<unsigned char>((c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c);
+  }
+  return table;
+}
+
+static constexpr std::array<unsigned char, 256> FoldTable = makeFoldTable();
+
+static inline unsigned char fold(char c) {
+  return FoldTable[static_cast<unsigned char>(c)];
+}
+
+TrigramSignature trigramSignature(std::string_view text) {
+  TrigramSignature signature;
+  for (size_t i = 0; i + 3 <= text.size(); ++i) {
+    const uint32_t trigram = (uint32_t(fold(text[i])) << 16) | (uint32_t(fold(text[i + 1])) << 8) | uint32_t(fold(text[i + 2]));
+    // Top 8 bits of a multiplicative hash pick one of the 256 bits
+    const unsigned bit = (trigram * 0x9E3779B1u + 0x7F4A7C15u) >> 24;
+    signature.bits[bit >> 6] |= uint64_t(1) << (bit & 63);
+  }
+  return signature;
+}
+
+FoldedSearcher::FoldedSearcher(std::string_view term) {
+  m_term.reserve(term.size());
+  for (char c : term) {
+    m_term.push_back(static_cast<char>(fold(c)));
+  }
+}
+
+bool FoldedSearcher::foundIn(std::string_view text) const {
+  const size_t length = m_term.size();
+  if (length == 0) {
+    return true;
+  }
+  if (text.size() < length) {
+    return false;
+  }
+  const char* term = m_term.data();
+  const char lower = term[0];
+  const char upper = (lower >= 'a' && lower <= 'z') ? static_cast<char>(lower - 'a' + 'A') : lower;
+  // memchr is vectorized by the C library, so look for either case of the first character with it, then compare the rest
+  const char* p = text.data();
+  const char* const last = text.data() + text.size() - length;
+  while (p <= last) {
+    const size_t remaining = static_cast<size_t>(last - p) + 1;
+    const char* a = static_cast<const char*>(std::memchr(p, lower, remaining));
+    if (upper != lower) {
+      const char* b = static_cast<const char*>(std::memchr(p, upper, a ? static_cast<size_t>(a - p) : remaining));
+      if (b) {
+        a = b;
+      }
+    }
+    if (!a) {
+      return false;
+    }
+    size_t j = 1;
+    while (j < length && fold(a[j]) == static_cast<unsigned char>(term[j])) {
+      ++j;
+    }
+    if (j == length) {
+      return true;
+    }
+    p = a + 1;
+  }
+  return false;
+}
+
+void RunLogIndex::addLine(uint8_t style) {
+  const size_t line = m_lineCount++;
+  const size_t word = line / 64;
+  if (line % 64 == 0) {
+    for (auto& bits : m_styleBits) {
+      bits.push_back(0);
+    }
+  }
+  m_styleBits[style % MaxStyles][word] |= uint64_t(1) << (line % 64);
+}
+
+void RunLogIndex::clear() {
+  m_lineCount = 0;
+  for (auto& bits : m_styleBits) {
+    bits.clear();
+  }
+}
+
+uint64_t RunLogIndex::styleWord(StyleMask styleMask, size_t word) const {
+  uint64_t bits = 0;
+  for (int style = 0; style < MaxStyles; ++style) {
+    if ((styleMask & (1u << style)) != 0) {
+      bits |= m_styleBits[style][word];
+    }
+  }
+  return bits;
+}
@@ -0,0 +1,106 @@
+#ifndef RUNLOGINDEX_HPP
+#define RUNLOGINDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 256 bit Bloom filter of the (ASCII case folded) trigrams of a line. A line can only contain a term if its signature has
+// every bit of the term's, so most lines are ruled out without reading their text. Computed once per line as it's
+// written, and stored next to the log (see RunLogWriter)
+struct TrigramSignature
+{
+  uint64_t bits[4] = {0, 0, 0, 0};
+
+  bool contains(const TrigramSignature& other) const {
+    uint64_t missing = 0;
+    for (int i = 0; i < 4; ++i) {
+      missing |= other.bits[i] & ~bits[i];
+    }
+    return missing == 0;
+  }
+};
+static_assert(sizeof(TrigramSignature) == 32, "TrigramSignature is stored as is");
+
+TrigramSignature trigramSignature(std::string_view text);
+
+// ASCII case insensitive substring search, built once per search term
+class FoldedSearcher
+{
+public:
+    explicit FoldedSearcher(std::string_view term);
+
+    bool foundIn(std::string_view text) const;
+
+    bool isEmpty() const {
+      return m_term.empty();
+    }
+
+private:
+    std::string m_term;  // folded
+};
+
+// Filter over the lines of a run log: one bitmap per style, so toggling levels is a few OR over 64 bit words, plus
+// the trigram signatures for text search. Grows incrementally, only the new lines are ever looked at.
+// Plain C++ on purpose: the text and signature of a line are fetched through callbacks.
+class RunLogIndex
+{
+public:
+    static constexpr int MaxStyles = 16;
+    using StyleMask = uint16_t;
+    static constexpr StyleMask AllStyles = 0xFFFF;
+
+    void addLine(uint8_t style);
+    void clear();
+
+    size_t lineCount() const {
+      return m_lineCount;
+    }
+
+    // Appends to matches the lines >= fromLine whose style is in styleMask and which contain term (ASCII case insensitive).
+    // lineSignature(uint32_t line) returns the TrigramSignature of a line, lineText(uint32_t line) its text: the text is
+    // only ever read for lines whose signature matches.
+    template <typename LineSignature, typename LineText>
+    void query(StyleMask styleMask, std::string_view term, LineSignature&& lineSignature, LineText&& lineText,
+               std::vector<uint32_t>& matches, size_t fromLine = 0) const {
+      const FoldedSearcher searcher(term);
+      const TrigramSignature termSignature = trigramSignature(term);
+
+      for (size_t word = fromLine / 64; word * 64 < m_lineCount; ++word) {
+        uint64_t bits = styleWord(styleMask, word);
+        if (word == fromLine / 64) {
+          bits &= ~uint64_t(0) << (fromLine % 64);
+        }
+        while (bits != 0) {
+          const uint32_t line = static_cast<uint32_t>(word * 64 + countTrailingZeros(bits));
+          bits &= bits - 1;
+          if (searcher.isEmpty() || (lineSignature(line).contains(termSignature) && searcher.foundIn(lineText(line)))) {
+            matches.push_back(line);
+          }
+        }
+      }
+    }
+
+private:
+    static unsigned countTrailingZeros(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+      return static_cast<unsigned>(__builtin_ctzll(bits));
+#else
+      unsigned n = 0;
+      while ((bits & 1) == 0) {
+        bits >>= 1;
+        ++n;
+      }
+      return n;
+#endif
+    }
+
+    uint64_t styleWord(StyleMask styleMask, size_t word) const;
+
+    size_t m_lineCount = 0;
+    std::vector<uint64_t> m_styleBits[MaxStyles];
+};
+
+#endif // RUNLOGINDEX_HPP
@@ -0,0 +1,159 @@
+#include "runlogmodel.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+QColor logStyleColor(LogStyle style) {
+  switch (style) {
+    case LogStyle::Debug:
+      return Qt::lightGray;
+    case LogStyle::Info:
+      return Qt::gray;
+    case LogStyle::Warn:
+      return Qt::darkYellow;
+    case LogStyle::Error:
+    case LogStyle::Stderr:
+      return Qt::darkRed;
+    case LogStyle::Fatal:
+    case LogStyle::ErrorH1:
+    case LogStyle::ErrorH2:
+    case LogStyle::ErrorText:
+      return Qt::red;
+    case LogStyle::Suppressed:
+      return Qt::darkCyan;
+    case LogStyle::Normal:
+    case LogStyle::H1:
+    case LogStyle::H2:
+      break;
+  }
+  return Qt::black;
+}
+
+int logStylePointSize(LogStyle style) {
+  switch (style) {
+    case LogStyle::Debug:
+    case LogStyle::Info:
+      return 10;
+    case LogStyle::Warn:
+    case LogStyle::Error:
+    case LogStyle::Normal:
+    case LogStyle::ErrorText:
+    case LogStyle::Suppressed:
+      return 12;
+    case LogStyle::Fatal:
+      return 14;
+    case LogStyle::H2:
+    case LogStyle::ErrorH2:
+      return 15;
+    case LogStyle::H1:
+    case LogStyle::ErrorH1:
+    case LogStyle::Stderr:
+      return 18;
+  }
+  return 12;
+}
+
+RunLogModel::RunLogModel(int capacity, QObject *parent)
+    : QAbstractListModel(parent), m_capacity(std::max(capacity, 1))
+{
+}
+
+int RunLogModel::rowCount(const QModelIndex& parent) const {
+  if (parent.isValid()) {
+    return 0;
+  }
+  return m_size;
+}
+
+QVariant RunLogModel::data(const QModelIndex& index, int role) const {
+  if (!index.isValid() || index.row() >= m_size) {
+    return {};
+  }
+
+  const LogLine& line = lineAt(index.row());
+  switch (role) {
+    case Qt::DisplayRole:
+      return line.text;
+    case Qt::ForegroundRole:
+      return logStyleColor(line.style);
+    case StyleRole:
+      return static_cast<int>(line.style);
+    default:
+      break;
+  }
+  return {};
+}
+
+const LogLine& RunLogModel::lineAt(int row) const {
+  return m_lines[(m_head + row) % m_capacity];
+}
+
+void RunLogModel::dropOldest(int count) {
+  if (count <= 0) {
+    return;
+  }
+  beginRemoveRows(QModelIndex(), 0, count - 1);
+  for (int i = 0; i < count; ++i) {
+    // Release the string now rather than when the slot gets overwritten
+    m_lines[(m_head + i) % m_capacity].text = QString();
+  }
+  m_head = (m_head + count) % m_capacity;
+  m_size -= count;
+  m_droppedLineCount += count;
+  endRemoveRows();
+}
+
+void RunLogModel::appendLine(const QString& text, LogStyle style) {
+  appendLines({LogLine{text, style}});
+}
+
+void RunLogModel::appendLines(const std::vector<LogLine>& lines) {
+  if (lines.empty()) {
+    return;
+  }
+
+  const int count = static_cast<int>(std::min<size_t>(lines.size(), m_capacity));
+  auto first = std::prev(lines.end(), count);
+
+  if (count == m_capacity) {
+    // The batch alone fills the buffer: cheaper to reset than to remove then insert everything
+    beginResetModel();
+    m_droppedLineCount += m_size + static_cast<qint64>(lines.size()) - count;
+    m_lines.assign(first, lines.end());
+    m_head = 0;
+    m_size = count;
+    endResetModel();
+    return;
+  }
+
+  dropOldest(m_size + count - m_capacity);
+
+  beginInsertRows(QModelIndex(), m_size, m_size + count - 1);
+  for (auto it = first; it != lines.end(); ++it) {
+    const size_t slot = (m_head + m_size) % m_capacity;
+    if (slot < m_lines.size()) {
+      m_lines[slot] = *it;
+    } else {
+      m_lines.push_back(*it);
+    }
+    ++m_size;
+  }
+  endInsertRows();
+}
+
+void RunLogModel::clear() {
+  beginResetModel();
+  m_lines.clear();
+  m_head = 0;
+  m_size = 0;
+  m_droppedLineCount = 0;
+  endResetModel();
+}
+
+int RunLogModel::capacity() const {
+  return m_capacity;
+}
+
+qint64 RunLogModel::droppedLineCount() const {
+  return m_droppedLineCount;
+}
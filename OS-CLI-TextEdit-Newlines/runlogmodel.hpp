@@ -0,0 +1,77 @@
+#ifndef RUNLOGMODEL_HPP
+#define RUNLOGMODEL_HPP
+
+#include <QAbstractListModel>
+#include <QColor>
+#include <QString>
+
+#include <vector>
+
+// How a line of the run log is rendered. Mirrors the setTextColor / setFontPointSize pairs we used to push into the QTextEdit
+enum class LogStyle : quint8
+{
+  Debug,      // lightGray, 10pt
+  Info,       // gray, 10pt
+  Warn,       // darkYellow, 12pt
+  Error,      // darkRed, 12pt
+  Fatal,      // red, 14pt
+  Normal,     // black, 12pt
+  H1,         // black, 18pt
+  H2,         // black, 15pt
+  ErrorH1,    // red, 18pt
+  ErrorH2,    // red, 15pt
+  ErrorText,  // red, 12pt
+  Stderr,     // darkRed, 18pt
+  Suppressed, // darkCyan, 12pt: live view only, stands for the lines it didn't show during a flood
+};
+
+constexpr int LogStyleCount = static_cast<int>(LogStyle::Suppressed) + 1;
+
+QColor logStyleColor(LogStyle style);
+int logStylePointSize(LogStyle style);
+
+struct LogLine
+{
+  QString text;
+  LogStyle style = LogStyle::Normal;
+};
+
+// Fixed-capacity ring buffer of log lines. Once full, the oldest lines are dropped so memory stays bounded no matter
+// how verbose the run is. Only the rows the view asks for are ever touched.
+class RunLogModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles
+    {
+      StyleRole = Qt::UserRole + 1,
+    };
+
+    static constexpr int DefaultCapacity = 200000;
+
+    explicit RunLogModel(int capacity = DefaultCapacity, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    void appendLine(const QString& text, LogStyle style);
+    void appendLines(const std::vector<LogLine>& lines);
+    void clear();
+
+    int capacity() const;
+    // Number of lines that were pushed out of the ring buffer since the last clear()
+    qint64 droppedLineCount() const;
+
+private:
+    const LogLine& lineAt(int row) const;
+    void dropOldest(int count);
+
+    std::vector<LogLine> m_lines;
+    int m_capacity;
+    int m_head = 0;
+    int m_size = 0;
+    qint64 m_droppedLineCount = 0;
+};
+
+#endif // RUNLOGMODEL_HPP
@@ -0,0 +1,359 @@
+#include "runlogstore.hpp"
+
+#include <QDir>
+#include <QFileInfo>
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+static constexpr char IndexMagic[8] = {'O', 'S', 'R', 'U', 'N', 'I', 'D', 'X'};
+static constexpr quint32 IndexVersion = 1;
+// Write to the files in chunks of about that size
+static constexpr int WriteBufferSize = 1 << 20;
+
+QString RunLogWriter::segmentPath(const QString& basePath) {
+  return basePath + ".log";
+}
+
+QString RunLogWriter::indexPath(const QString& basePath) {
+  return basePath + ".logidx";
+}
+
+QString RunLogWriter::signaturePath(const QString& basePath) {
+  return basePath + ".logsig";
+}
+
+RunLogWriter::~RunLogWriter() {
+  close();
+}
+
+bool RunLogWriter::open(const QString& basePath) {
+  close();
+
+  QDir().mkpath(QFileInfo(basePath).absolutePath());
+  m_segmentFile.setFileName(segmentPath(basePath));
+  m_indexFile.setFileName(indexPath(basePath));
+  m_signatureFile.setFileName(signaturePath(basePath));
+  if (!m_segmentFile.open(QIODevice::WriteOnly | QIODevice::Truncate) || !m_indexFile.open(QIODevice::WriteOnly | QIODevice::Truncate)
+      || !m_signatureFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    close();
+    return false;
+  }
+
+  RunLogIndexHeader header{};
+  std::memcpy(header.magic, IndexMagic, sizeof(IndexMagic));
+  header.version = IndexVersion;
+  m_indexBuffer.append(reinterpret_cast<const char*>(&header), sizeof(header));
+  return true;
+}
+
+void RunLogWriter::close() {
+  if (isOpen()) {
+    flush();
+  }
+  m_segmentFile.close();
+  m_indexFile.close();
+  m_signatureFile.close();
+  m_segmentBuffer.clear();
+  m_indexBuffer.clear();
+  m_signatureBuffer.clear();
+  m_offset = 0;
+  m_lineCount = 0;
+}
+
+bool RunLogWriter::isOpen() const {
+  return m_segmentFile.isOpen() && m_indexFile.isOpen() && m_signatureFile.isOpen();
+}
+
+void RunLogWriter::append(QByteArrayView utf8, LogStyle style) {
+  if (!isOpen()) {
+    return;
+  }
+
+  RunLogIndexEntry entry{};
+  entry.offset = m_offset;
+  entry.length = static_cast<quint32>(utf8.size());
+  entry.style = static_cast<quint8>(style);
+  m_indexBuffer.append(reinterpret_cast<const char*>(&entry), sizeof(entry));
+
+  // Done here, on the ingestion thread, so searching never has to go through the text of the whole run
+  const TrigramSignature signature = trigramSignature(std::string_view(utf8.data(), utf8.size()));
+  m_signatureBuffer.append(reinterpret_cast<const char*>(&signature), sizeof(signature));
+
+  m_segmentBuffer.append(utf8);
+  m_segmentBuffer.append('\n');
+  m_offset += static_cast<quint64>(utf8.size()) + 1;
+  ++m_lineCount;
+
+  if (m_segmentBuffer.size() >= WriteBufferSize) {
+    flush();
+  }
+}
+
+void RunLogWriter::flush() {
+  if (!isOpen()) {
+    return;
+  }
+  // Index last: a reader never sees an index entry before the text and signature it goes with
+  if (!m_segmentBuffer.isEmpty()) {
+    m_segmentFile.write(m_segmentBuffer);
+    m_segmentFile.flush();
+    m_segmentBuffer.clear();
+  }
+  if (!m_signatureBuffer.isEmpty()) {
+    m_signatureFile.write(m_signatureBuffer);
+    m_signatureFile.flush();
+    m_signatureBuffer.clear();
+  }
+  if (!m_indexBuffer.isEmpty()) {
+    m_indexFile.write(m_indexBuffer);
+    m_indexFile.flush();
+    m_indexBuffer.clear();
+  }
+}
+
+qint64 RunLogWriter::lineCount() const {
+  return m_lineCount;
+}
+
+RunLogStore::~RunLogStore() {
+  close();
+}
+
+bool RunLogStore::open(const QString& basePath) {
+  close();
+
+  m_segmentFile.setFileName(RunLogWriter::segmentPath(basePath));
+  m_indexFile.setFileName(RunLogWriter::indexPath(basePath));
+  if (!m_segmentFile.open(QIODevice::ReadOnly) || !m_indexFile.open(QIODevice::ReadOnly)) {
+    close();
+    return false;
+  }
+
+  const qint64 indexSize = m_indexFile.size();
+  if (indexSize < static_cast<qint64>(sizeof(RunLogIndexHeader))) {
+    close();
+    return false;
+  }
+  const uchar* index = m_indexFile.map(0, indexSize);
+  if (!index) {
+    close();
+    return false;
+  }
+  const auto* header = reinterpret_cast<const RunLogIndexHeader*>(index);
+  if (std::memcmp(header->magic, IndexMagic, sizeof(IndexMagic)) != 0 || header->version != IndexVersion) {
+    close();
+    return false;
+  }
+  m_entries = reinterpret_cast<const RunLogIndexEntry*>(index + sizeof(RunLogIndexHeader));
+  m_lineCount = (indexSize - static_cast<qint64>(sizeof(RunLogIndexHeader))) / static_cast<qint64>(sizeof(RunLogIndexEntry));
+
+  // Can't map an empty file, but then there's no line to point into it either
+  const qint64 segmentSize = m_segmentFile.size();
+  if (segmentSize > 0) {
+    m_segment = reinterpret_cast<const char*>(m_segmentFile.map(0, segmentSize));
+    if (!m_segment) {
+      close();
+      return false;
+    }
+  }
+
+  // Older stores don't have signatures, searching them just means reading every line
+  m_signatureFile.setFileName(RunLogWriter::signaturePath(basePath));
+  const qint64 signatureCount = m_signatureFile.size() / static_cast<qint64>(sizeof(TrigramSignature));
+  if (signatureCount > 0 && m_signatureFile.open(QIODevice::ReadOnly)) {
+    m_signatures = reinterpret_cast<const TrigramSignature*>(m_signatureFile.map(0, signatureCount * static_cast<qint64>(sizeof(TrigramSignature))));
+    if (m_signatures) {
+      m_lineCount = std::min(m_lineCount, signatureCount);
+    }
+  }
+
+  // A run killed mid-write can leave a tail of entries pointing past the end of the segment, just ignore them
+  while (m_lineCount > 0) {
+    const RunLogIndexEntry& last = m_entries[m_lineCount - 1];
+    if (last.offset + last.length <= static_cast<quint64>(segmentSize)) {
+      break;
+    }
+    --m_lineCount;
+  }
+  return true;
+}
+
+void RunLogStore::close() {
+  // Closing the files also unmaps them
+  m_segmentFile.close();
+  m_indexFile.close();
+  m_signatureFile.close();
+  m_segment = nullptr;
+  m_entries = nullptr;
+  m_signatures = nullptr;
+  m_lineCount = 0;
+}
+
+bool RunLogStore::isOpen() const {
+  return m_entries != nullptr;
+}
+
+qint64 RunLogStore::lineCount() const {
+  return m_lineCount;
+}
+
+QByteArrayView RunLogStore::lineData(qint64 line) const {
+  const RunLogIndexEntry& entry = m_entries[line];
+  if (entry.length == 0) {
+    return QByteArrayView();
+  }
+  return QByteArrayView(m_segment + entry.offset, static_cast<qsizetype>(entry.length));
+}
+
+LogStyle RunLogStore::lineStyle(qint64 line) const {
+  const quint8 style = m_entries[line].style;
+  return style < LogStyleCount ? static_cast<LogStyle>(style) : LogStyle::Normal;
+}
+
+const TrigramSignature& RunLogStore::lineSignature(qint64 line) const {
+  static const TrigramSignature full{{~uint64_t(0), ~uint64_t(0), ~uint64_t(0), ~uint64_t(0)}};
+  return m_signatures ? m_signatures[line] : full;
+}
+
+RunLogStoreModel::RunLogStoreModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+bool RunLogStoreModel::open(const QString& basePath) {
+  if (m_store.isOpen() && basePath == m_basePath) {
+    refresh();
+    return m_store.isOpen();
+  }
+
+  beginResetModel();
+  m_basePath = basePath;
+  m_index.clear();
+  m_rows.clear();
+  const bool ok = m_store.open(basePath);
+  if (ok) {
+    indexNewLines();
+    if (isFiltered()) {
+      filterLines(0, m_rows);
+    }
+  }
+  endResetModel();
+  return ok;
+}
+
+QString RunLogStoreModel::basePath() const {
+  return m_basePath;
+}
+
+void RunLogStoreModel::refresh() {
+  const qint64 oldLineCount = m_store.lineCount();
+  // Maps the files again, at their current size
+  if (!m_store.open(m_basePath) || m_store.lineCount() < oldLineCount) {
+    // Gone, or rewritten by another run
+    beginResetModel();
+    m_index.clear();
+    m_rows.clear();
+    indexNewLines();
+    if (isFiltered()) {
+      filterLines(0, m_rows);
+    }
+    endResetModel();
+    return;
+  }
+
+  const qint64 lineCount = m_store.lineCount();
+  if (lineCount == oldLineCount) {
+    return;
+  }
+  indexNewLines();
+
+  if (!isFiltered()) {
+    beginInsertRows(QModelIndex(), static_cast<int>(oldLineCount), static_cast<int>(std::min<qint64>(lineCount, INT_MAX)) - 1);
+    endInsertRows();
+    return;
+  }
+
+  std::vector<uint32_t> newRows;
+  filterLines(oldLineCount, newRows);
+  if (newRows.empty()) {
+    return;
+  }
+  const int first = static_cast<int>(m_rows.size());
+  beginInsertRows(QModelIndex(), first, first + static_cast<int>(newRows.size()) - 1);
+  m_rows.insert(m_rows.end(), newRows.begin(), newRows.end());
+  endInsertRows();
+}
+
+void RunLogStoreModel::setFilter(RunLogIndex::StyleMask styleMask, const QString& term) {
+  const QByteArray utf8Term = term.toUtf8();
+  if (styleMask == m_styleMask && utf8Term == m_term) {
+    return;
+  }
+
+  beginResetModel();
+  m_styleMask = styleMask;
+  m_term = utf8Term;
+  m_rows.clear();
+  if (isFiltered()) {
+    filterLines(0, m_rows);
+  }
+  endResetModel();
+}
+
+bool RunLogStoreModel::isFiltered() const {
+  return m_styleMask != RunLogIndex::AllStyles || !m_term.isEmpty();
+}
+
+void RunLogStoreModel::indexNewLines() {
+  // Styles come straight from the mapped index entries, that's a byte per line: even a million lines is only a few ms
+  for (qint64 line = static_cast<qint64>(m_index.lineCount()); line < m_store.lineCount(); ++line) {
+    m_index.addLine(static_cast<uint8_t>(m_store.lineStyle(line)));
+  }
+}
+
+void RunLogStoreModel::filterLines(qint64 fromLine, std::vector<uint32_t>& rows) const {
+  m_index.query(
+    m_styleMask, std::string_view(m_term.constData(), m_term.size()),
+    [this](uint32_t line) -> const TrigramSignature& { return m_store.lineSignature(line); },
+    [this](uint32_t line) {
+      const QByteArrayView data = m_store.lineData(line);
+      return std::string_view(data.data(), data.size());
+    },
+    rows, static_cast<size_t>(fromLine));
+}
+
+qint64 RunLogStoreModel::lineForRow(int row) const {
+  return isFiltered() ? static_cast<qint64>(m_rows[row]) : static_cast<qint64>(row);
+}
+
+int RunLogStoreModel::rowCount(const QModelIndex& parent) const {
+  if (parent.isValid()) {
+    return 0;
+  }
+  if (isFiltered()) {
+    return static_cast<int>(m_rows.size());
+  }
+  return static_cast<int>(std::min<qint64>(m_store.lineCount(), INT_MAX));
+}
+
+QVariant RunLogStoreModel::data(const QModelIndex& index, int role) const {
+  if (!index.isValid() || index.row() >= rowCount()) {
+    return {};
+  }
+
+  // Decoded on demand: only the rows on screen ever get turned into a QString
+  const qint64 line = lineForRow(index.row());
+  switch (role) {
+    case Qt::DisplayRole:
+      return QString::fromUtf8(m_store.lineData(line));
+    case Qt::ForegroundRole:
+      return logStyleColor(m_store.lineStyle(line));
+    case RunLogModel::StyleRole:
+      return static_cast<int>(m_store.lineStyle(line));
+    default:
+      break;
+  }
+  return {};
+}
@@ -0,0 +1,141 @@
+#ifndef RUNLOGSTORE_HPP
+#define RUNLOGSTORE_HPP
+
+#include "runlogindex.hpp"
+#include "runlogmodel.hpp"
+
+#include <QAbstractListModel>
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QFile>
+#include <QString>
+
+#include <vector>
+
+// On-disk log of a run, as files next to each other:
+//  - <base>.log: the UTF-8 text of the classified lines, one per line, so it stays readable with any editor
+//  - <base>.logidx: a small header then one fixed-size RunLogIndexEntry per line (offset / length / style)
+//  - <base>.logsig: one TrigramSignature per line, for text search. Optional, without it searches read every line
+// All are written in native byte order, they are a local cache and not meant to be moved between machines.
+
+struct RunLogIndexHeader
+{
+  char magic[8];
+  quint32 version;
+  quint32 reserved;
+};
+static_assert(sizeof(RunLogIndexHeader) == 16, "RunLogIndexHeader must stay packed");
+
+struct RunLogIndexEntry
+{
+  quint64 offset;
+  quint32 length;
+  quint8 style;  // LogStyle
+  quint8 reserved[3];
+};
+static_assert(sizeof(RunLogIndexEntry) == 16, "RunLogIndexEntry must stay packed");
+
+// Appends lines to a store, as they come. Writes are buffered, call flush() to push them to the files
+class RunLogWriter
+{
+public:
+    static QString segmentPath(const QString& basePath);
+    static QString indexPath(const QString& basePath);
+    static QString signaturePath(const QString& basePath);
+
+    RunLogWriter() = default;
+    ~RunLogWriter();
+
+    RunLogWriter(const RunLogWriter&) = delete;
+    RunLogWriter& operator=(const RunLogWriter&) = delete;
+
+    // Truncates whatever store was at basePath
+    bool open(const QString& basePath);
+    void close();
+    bool isOpen() const;
+
+    void append(QByteArrayView utf8, LogStyle style);
+    void flush();
+
+    qint64 lineCount() const;
+
+private:
+    QFile m_segmentFile;
+    QFile m_indexFile;
+    QFile m_signatureFile;
+    QByteArray m_segmentBuffer;
+    QByteArray m_indexBuffer;
+    QByteArray m_signatureBuffer;
+    quint64 m_offset = 0;
+    qint64 m_lineCount = 0;
+};
+
+// Read-only view of a store, memory mapped: opening costs the same for 100 lines or 10 million, and only the pages
+// of the lines actually looked at get read from disk
+class RunLogStore
+{
+public:
+    RunLogStore() = default;
+    ~RunLogStore();
+
+    RunLogStore(const RunLogStore&) = delete;
+    RunLogStore& operator=(const RunLogStore&) = delete;
+
+    bool open(const QString& basePath);
+    void close();
+    bool isOpen() const;
+
+    qint64 lineCount() const;
+    QByteArrayView lineData(qint64 line) const;
+    LogStyle lineStyle(qint64 line) const;
+    // All bits set when the store has no signatures, so nothing gets ruled out
+    const TrigramSignature& lineSignature(qint64 line) const;
+
+private:
+    QFile m_segmentFile;
+    QFile m_indexFile;
+    QFile m_signatureFile;
+    const char* m_segment = nullptr;
+    const RunLogIndexEntry* m_entries = nullptr;
+    const TrigramSignature* m_signatures = nullptr;
+    qint64 m_lineCount = 0;
+};
+
+// Shows a store in the log view, same roles as RunLogModel so RunLogDelegate renders it the same way.
+// Can be filtered on styles and on a search term, through a RunLogIndex that is kept up to date as the store grows
+class RunLogStoreModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit RunLogStoreModel(QObject *parent = nullptr);
+
+    // Just refreshes if that store is already open, so its index doesn't get rebuilt
+    bool open(const QString& basePath);
+    QString basePath() const;
+    // Picks up the lines written since the store was opened or last refreshed: only those get indexed and filtered
+    void refresh();
+
+    // styleMask has one bit per LogStyle. An empty term doesn't filter anything
+    void setFilter(RunLogIndex::StyleMask styleMask, const QString& term);
+    bool isFiltered() const;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+private:
+    void indexNewLines();
+    // Appends the lines >= fromLine that pass the filter to rows
+    void filterLines(qint64 fromLine, std::vector<uint32_t>& rows) const;
+    qint64 lineForRow(int row) const;
+
+    RunLogStore m_store;
+    QString m_basePath;
+    RunLogIndex m_index;
+    RunLogIndex::StyleMask m_styleMask = RunLogIndex::AllStyles;
+    QByteArray m_term;
+    // Lines shown, when filtered
+    std::vector<uint32_t> m_rows;
+};
+
+#endif // RUNLOGSTORE_HPP
@@ -0,0 +1,62 @@
+#include "runprotocol.hpp"
+
+#include <QtEndian>
+
+#include <cstring>
+
+QByteArray encodeRunMessage(const RunMessage& message) {
+  const auto payloadSize = static_cast<quint32>(RunMessageHeaderLength + message.message.size());
+
+  QByteArray frame(RunMessageSizeFieldLength + payloadSize, Qt::Uninitialized);
+  auto* data = reinterpret_cast<uchar*>(frame.data());
+  qToBigEndian<quint32>(payloadSize, data);
+  data[4] = static_cast<uchar>(static_cast<qint8>(message.level));
+  data[5] = static_cast<uchar>(message.event);
+  data[6] = static_cast<uchar>(message.state);
+  data[7] = 0;
+  qToBigEndian<qint32>(message.stepIndex, data + 8);
+  if (!message.message.isEmpty()) {
+    std::memcpy(data + RunMessageSizeFieldLength + RunMessageHeaderLength, message.message.data(), message.message.size());
+  }
+  return frame;
+}
+
+RunMessageParser::FrameResult RunMessageParser::parseFrame(QByteArrayView data, RunMessage& message, qsizetype& frameSize) {
+  if (data.size() < RunMessageSizeFieldLength) {
+    return FrameResult::Incomplete;
+  }
+
+  const auto* bytes = reinterpret_cast<const uchar*>(data.data());
+  const quint32 payloadSize = qFromBigEndian<quint32>(bytes);
+  if (payloadSize < RunMessageHeaderLength || payloadSize > RunMessageMaxPayloadSize) {
+    return FrameResult::Corrupt;
+  }
+  if (data.size() < RunMessageSizeFieldLength + payloadSize) {
+    return FrameResult::Incomplete;
+  }
+
+  const auto level = static_cast<qint8>(bytes[4]);
+  const quint8 event = bytes[5];
+  const quint8 state = bytes[6];
+  if (level < static_cast<qint8>(LineLevel::None) || level > static_cast<qint8>(LineLevel::Fatal)
+      || event > static_cast<quint8>(WorkflowEvent::Applied) || state > static_cast<quint8>(WorkflowState::Postprocess)) {
+    return FrameResult::Corrupt;
+  }
+
+  message.level = static_cast<LineLevel>(level);
+  message.event = static_cast<WorkflowEvent>(event);
+  message.state = static_cast<WorkflowState>(state);
+  message.stepIndex = qFromBigEndian<qint32>(bytes + 8);
+  message.message = data.sliced(RunMessageSizeFieldLength + RunMessageHeaderLength, payloadSize - RunMessageHeaderLength);
+  frameSize = RunMessageSizeFieldLength + payloadSize;
+  return FrameResult::Complete;
+}
+
+void RunMessageParser::reset() {
+  m_pending.clear();
+  m_hasError = false;
+}
+
+bool RunMessageParser::hasError() const {
+  return m_hasError;
+}
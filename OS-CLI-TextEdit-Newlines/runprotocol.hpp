@@ -0,0 +1,100 @@
+#ifndef RUNPROTOCOL_HPP
+#define RUNPROTOCOL_HPP
+
+#include "lineclassifier.hpp"
+
+#include <QByteArray>
+#include <QByteArrayView>
+
+// Messages sent by the CLI on the run socket (-s <port>), so the runner doesn't have to scrape stdout.
+//
+// Each frame is:
+//   quint32 payload size (big endian, everything below)
+//   qint8   level       (LineLevel, None if the message isn't a log line)
+//   quint8  event       (WorkflowEvent)
+//   quint8  state       (WorkflowState)
+//   quint8  reserved    (0)
+//   qint32  step index  (big endian, -1 outside of a measure step)
+//   message             (UTF-8, the text a human would have seen on stdout)
+struct RunMessage
+{
+  LineLevel level = LineLevel::None;
+  WorkflowEvent event = WorkflowEvent::None;
+  WorkflowState state = WorkflowState::None;
+  qint32 stepIndex = -1;
+  QByteArrayView message;
+};
+
+constexpr qsizetype RunMessageSizeFieldLength = 4;
+constexpr qsizetype RunMessageHeaderLength = 8;
+// Anything bigger means we lost sync with the stream
+constexpr quint32 RunMessageMaxPayloadSize = 16 * 1024 * 1024;
+
+QByteArray encodeRunMessage(const RunMessage& message);
+
+// Incremental frame parser: a frame can be split across reads, and one read can hold several frames.
+// Complete frames are parsed straight from the chunk, only an incomplete trailing frame is copied.
+class RunMessageParser
+{
+public:
+    // Calls onMessage for every complete frame. The message view is only valid during the callback.
+    // Returns false if the stream is corrupt, in which case nothing more will be parsed until reset()
+    template <typename OnMessage>
+    bool feed(QByteArrayView chunk, OnMessage&& onMessage);
+
+    void reset();
+
+    bool hasError() const;
+
+private:
+    enum class FrameResult
+    {
+      Complete,
+      Incomplete,
+      Corrupt
+    };
+
+    static FrameResult parseFrame(QByteArrayView data, RunMessage& message, qsizetype& frameSize);
+
+    QByteArray m_pending;
+    bool m_hasError = false;
+};
+
+template <typename OnMessage>
+bool RunMessageParser::feed(QByteArrayView chunk, OnMessage&& onMessage) {
+  if (m_hasError) {
+    return false;
+  }
+
+  const bool usePending = !m_pending.isEmpty();
+  if (usePending) {
+    m_pending.append(chunk.data(), chunk.size());
+  }
+  const QByteArrayView data = usePending ? QByteArrayView(m_pending) : chunk;
+
+  qsizetype pos = 0;
+  RunMessage message;
+  qsizetype frameSize = 0;
+  for (;;) {
+    const FrameResult result = parseFrame(data.sliced(pos), message, frameSize);
+    if (result == FrameResult::Incomplete) {
+      break;
+    }
+    if (result == FrameResult::Corrupt) {
+      m_hasError = true;
+      m_pending.clear();
+      return false;
+    }
+    onMessage(message);
+    pos += frameSize;
+  }
+
+  if (usePending) {
+    m_pending.remove(0, pos);
+  } else if (pos < data.size()) {
+    m_pending = data.sliced(pos).toByteArray();
+  }
+  return true;
+}
+
+#endif // RUNPROTOCOL_HPP
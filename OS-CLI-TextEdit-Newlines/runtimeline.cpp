@@ -0,0 +1,226 @@
+#include "runtimeline.hpp"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <cmath>
+
+static constexpr int HistoryVersion = 1;
+static const QString MeasureKeyPrefix = QStringLiteral("measure:");
+
+static QString stateName(WorkflowState state) {
+  const std::string_view name = workflowStateName(state);
+  return QString::fromLatin1(name.data(), static_cast<qsizetype>(name.size()));
+}
+
+QString formatDuration(qint64 ms) {
+  if (ms < 1000) {
+    return QString::number(ms) + " ms";
+  }
+  if (ms < 60 * 1000) {
+    return QString::number(ms / 1000.0, 'f', 1) + " s";
+  }
+  const qint64 seconds = ms / 1000;
+  return QString("%1 min %2 s").arg(seconds / 60).arg(seconds % 60, 2, 10, QChar('0'));
+}
+
+QString TimelineSpan::key() const {
+  return kind == Kind::Phase ? name : MeasureKeyPrefix + name;
+}
+
+void RunTimeline::start() {
+  m_spans.clear();
+  m_clock.start();
+  m_running = true;
+  m_endMs = 0;
+}
+
+void RunTimeline::handleEvent(WorkflowEvent event, WorkflowState state, int stepIndex, const QString& text, qint64 ms) {
+  switch (event) {
+    case WorkflowEvent::StateStarted: {
+      // States run one after the other, a missing "Returned" just ends where the next one starts
+      closeAll(ms);
+      TimelineSpan span;
+      span.kind = TimelineSpan::Kind::Phase;
+      span.state = state;
+      span.name = stateName(state);
+      span.startMs = ms;
+      m_spans.push_back(span);
+      break;
+    }
+    case WorkflowEvent::StateReturned:
+      closeAll(ms);
+      break;
+    case WorkflowEvent::Applying: {
+      closeMeasures(ms);
+      TimelineSpan span;
+      span.kind = TimelineSpan::Kind::Measure;
+      span.state = state;
+      if (span.state == WorkflowState::None) {
+        // Scraped from stdout, the line doesn't say: it belongs to the phase that's open
+        for (auto it = m_spans.crbegin(); it != m_spans.crend(); ++it) {
+          if (it->kind == TimelineSpan::Kind::Phase && it->isOpen()) {
+            span.state = it->state;
+            break;
+          }
+        }
+      }
+      span.stepIndex = stepIndex;
+      // "Applying <measure>"
+      span.name = text.section(' ', 1).trimmed();
+      span.startMs = ms;
+      m_spans.push_back(span);
+      break;
+    }
+    case WorkflowEvent::Applied:
+      closeMeasures(ms);
+      break;
+    case WorkflowEvent::Failure:
+    case WorkflowEvent::Complete:
+      closeAll(ms);
+      break;
+    case WorkflowEvent::Started:
+    case WorkflowEvent::None:
+      break;
+  }
+}
+
+void RunTimeline::finish(qint64 ms) {
+  closeAll(ms);
+  m_running = false;
+  m_endMs = ms;
+  for (const auto& span : m_spans) {
+    m_endMs = std::max(m_endMs, span.endMs);
+  }
+}
+
+bool RunTimeline::isRunning() const {
+  return m_running;
+}
+
+qint64 RunTimeline::currentMs() const {
+  return m_running ? m_clock.elapsed() : m_endMs;
+}
+
+const std::vector<TimelineSpan>& RunTimeline::spans() const {
+  return m_spans;
+}
+
+void RunTimeline::closeMeasures(qint64 ms) {
+  for (auto& span : m_spans) {
+    if (span.kind == TimelineSpan::Kind::Measure && span.isOpen()) {
+      span.endMs = std::max(ms, span.startMs);
+    }
+  }
+}
+
+void RunTimeline::closeAll(qint64 ms) {
+  for (auto& span : m_spans) {
+    if (span.isOpen()) {
+      span.endMs = std::max(ms, span.startMs);
+    }
+  }
+}
+
+bool PhaseDurationHistory::load(const QString& filePath) {
+  m_filePath = filePath;
+  m_samples.clear();
+
+  QFile file(filePath);
+  if (!file.open(QIODevice::ReadOnly)) {
+    return !file.exists();
+  }
+  const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+  if (root.value("version").toInt() != HistoryVersion) {
+    return false;
+  }
+  const QJsonObject samples = root.value("samples").toObject();
+  for (auto it = samples.constBegin(); it != samples.constEnd(); ++it) {
+    std::vector<qint64>& durations = m_samples[it.key()];
+    for (const QJsonValue& value : it.value().toArray()) {
+      durations.push_back(value.toInteger());
+    }
+  }
+  return true;
+}
+
+bool PhaseDurationHistory::save() const {
+  if (m_filePath.isEmpty()) {
+    return false;
+  }
+  QJsonObject samples;
+  for (const auto& [key, durations] : m_samples) {
+    QJsonArray array;
+    for (qint64 duration : durations) {
+      array.append(duration);
+    }
+    samples.insert(key, array);
+  }
+  QJsonObject root;
+  root.insert("version", HistoryVersion);
+  root.insert("samples", samples);
+
+  QDir().mkpath(QFileInfo(m_filePath).absolutePath());
+  // Several windows could finish runs at the same time: never leave a half written file behind
+  QSaveFile file(m_filePath);
+  if (!file.open(QIODevice::WriteOnly)) {
+    return false;
+  }
+  file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+  return file.commit();
+}
+
+void PhaseDurationHistory::addRun(const RunTimeline& timeline) {
+  for (const auto& span : timeline.spans()) {
+    if (span.isOpen() || span.name.isEmpty()) {
+      continue;
+    }
+    std::vector<qint64>& durations = m_samples[span.key()];
+    durations.push_back(span.endMs - span.startMs);
+    if (durations.size() > static_cast<size_t>(MaxSamplesPerKey)) {
+      durations.erase(durations.begin(), durations.end() - MaxSamplesPerKey);
+    }
+  }
+}
+
+std::vector<PhaseDurationHistory::Stats> PhaseDurationHistory::statistics() const {
+  // Nearest rank
+  auto percentile = [](const std::vector<qint64>& sorted, double p) {
+    const auto rank = static_cast<size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+  };
+  // Phases come in the order of WorkflowState, measures after them
+  auto order = [](const QString& key) {
+    for (int state = static_cast<int>(WorkflowState::Initialization); state <= static_cast<int>(WorkflowState::Postprocess); ++state) {
+      if (key == stateName(static_cast<WorkflowState>(state))) {
+        return state;
+      }
+    }
+    return static_cast<int>(WorkflowState::Postprocess) + 1;
+  };
+
+  std::vector<Stats> result;
+  for (const auto& [key, durations] : m_samples) {
+    if (durations.empty()) {
+      continue;
+    }
+    std::vector<qint64> sorted = durations;
+    std::sort(sorted.begin(), sorted.end());
+    Stats stats;
+    stats.key = key;
+    stats.count = static_cast<int>(durations.size());
+    stats.lastMs = durations.back();
+    stats.p50Ms = percentile(sorted, 0.50);
+    stats.p95Ms = percentile(sorted, 0.95);
+    result.push_back(stats);
+  }
+  // std::map already sorted them by key
+  std::stable_sort(result.begin(), result.end(), [&order](const Stats& a, const Stats& b) { return order(a.key) < order(b.key); });
+  return result;
+}
@@ -0,0 +1,99 @@
+#ifndef RUNTIMELINE_HPP
+#define RUNTIMELINE_HPP
+
+#include "lineclassifier.hpp"
+
+#include <QElapsedTimer>
+#include <QString>
+
+#include <map>
+#include <vector>
+
+// eg "850 ms", "12.3 s", "2 min 05 s"
+QString formatDuration(qint64 ms);
+
+// A workflow phase, from "Starting state <state>" to "Returned from state <state>", or a measure inside of it, from
+// "Applying <measure>" to "Applied <measure>" (or whatever comes next, if the CLI doesn't say)
+struct TimelineSpan
+{
+  enum class Kind
+  {
+    Phase,
+    Measure
+  };
+
+  Kind kind = Kind::Phase;
+  WorkflowState state = WorkflowState::None;
+  int stepIndex = -1;
+  QString name;
+  // In ms since the start of the run
+  qint64 startMs = 0;
+  qint64 endMs = -1;  // -1 while still open
+
+  bool isOpen() const {
+    return endMs < 0;
+  }
+
+  // Identifies the same phase or measure across runs: the state name, or "measure:<name>"
+  QString key() const;
+};
+
+// The spans of one run, built as the workflow events come in
+class RunTimeline
+{
+public:
+    // Forgets the previous run, and starts the clock the spans still open are drawn up to
+    void start();
+    // text is the line the event came from, ms is since the start of the run
+    void handleEvent(WorkflowEvent event, WorkflowState state, int stepIndex, const QString& text, qint64 ms);
+    // Closes whatever is still open
+    void finish(qint64 ms);
+
+    bool isRunning() const;
+    // Where the timeline currently ends: now while running, else the end of the run
+    qint64 currentMs() const;
+    const std::vector<TimelineSpan>& spans() const;
+
+private:
+    void closeMeasures(qint64 ms);
+    void closeAll(qint64 ms);
+
+    std::vector<TimelineSpan> m_spans;
+    QElapsedTimer m_clock;
+    bool m_running = false;
+    qint64 m_endMs = 0;
+};
+
+// Durations of the phases and measures of past runs, saved as a small JSON file so they add up across sessions
+class PhaseDurationHistory
+{
+public:
+    // Only the most recent ones are kept, so the percentiles follow changes to the workflows
+    static constexpr int MaxSamplesPerKey = 200;
+
+    struct Stats
+    {
+      QString key;
+      int count = 0;
+      qint64 lastMs = 0;
+      qint64 p50Ms = 0;
+      qint64 p95Ms = 0;
+    };
+
+    // A missing file is just an empty history
+    bool load(const QString& filePath);
+    bool save() const;
+
+    // Every closed span of the run
+    void addRun(const RunTimeline& timeline);
+
+    // Phases in workflow order first, then the measures by name
+    std::vector<Stats> statistics() const;
+
+private:
+    QString m_filePath;
+    // Oldest first
+    std::map<QString, std::vector<qint64>> m_samples;
+};
+
+#endif // RUNTIMELINE_HPP
@@ -0,0 +1,640 @@
+#include "runworker.hpp"
+#include "processtree.hpp"
+#include "resultcache.hpp"
+#include "workflowcheckpoints.hpp"
+#include "workflowvalidator.hpp"
+
+#include <QDebug>
+#include <QFileInfo>
+#include <QLocale>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+
+#include <algorithm>
+#include <iterator>
+
+// Up to that many batches can be waiting for the GUI, past that they're held in m_heldBatches until it catches up
+static constexpr size_t MaxQueuedBatches = 256;
+// Lines per batch, well under what the GUI drains in a frame so a batch never blows its budget
+static constexpr size_t MaxBatchLines = 4096;
+static constexpr int PublishRetryIntervalMs = 16;
+// Backlog (lines the GUI has yet to take) past which the chatty lines get sampled, about 5 frames worth of drain budget...
+static constexpr qint64 DegradeBacklogLines = 100000;
+// ... and under which everything is shown again. Far enough apart that it doesn't flap
+static constexpr qint64 RecoverBacklogLines = 20000;
+// While degraded, one DEBUG / INFO line in that many is still shown
+static constexpr qint64 SampleEvery = 100;
+// While degraded, the live view gets told what it misses at most that often
+static constexpr qint64 SuppressedMarkerIntervalMs = 1000;
+// How long a pooled run's socket gets to deliver the rest of its output once the worker says the job is done
+static constexpr int PooledRunDrainTimeoutMs = 1000;
+
+static LogStyle logStyleForLevel(LineLevel level) {
+  switch (level) {
+    case LineLevel::Trace:
+    case LineLevel::Debug:
+      return LogStyle::Debug;
+    case LineLevel::Info:
+      return LogStyle::Info;
+    case LineLevel::Warn:
+      return LogStyle::Warn;
+    case LineLevel::Error:
+      return LogStyle::Error;
+    case LineLevel::Fatal:
+      return LogStyle::Fatal;
+    case LineLevel::None:
+      break;
+  }
+  return LogStyle::Normal;
+}
+
+// Header shown when a workflow state starts, nullptr for the states we don't announce
+static const char* workflowStateHeader(WorkflowState state) {
+  switch (state) {
+    case WorkflowState::Initialization:
+      return "Initializing workflow.";
+    case WorkflowState::OsMeasures:
+      return "Processing OpenStudio Measures.";
+    case WorkflowState::Translator:
+      return "Translating the OpenStudio Model to EnergyPlus.";
+    case WorkflowState::EpMeasures:
+      return "Processing EnergyPlus Measures.";
+    case WorkflowState::Simulation:
+      return "Starting Simulation.";
+    case WorkflowState::ReportingMeasures:
+      return "Processing Reporting Measures.";
+    case WorkflowState::Postprocess:
+      return "Gathering Reports.";
+    case WorkflowState::Preprocess:  // ignore this state
+    case WorkflowState::None:
+      break;
+  }
+  return nullptr;
+}
+
+RunWorker::RunWorker(QObject *parent)
+    : QObject(parent), m_batches(MaxQueuedBatches)
+{
+    // Children move along with us in moveToThread
+    m_runProcess = new QProcess(this);
+    // EnergyPlus and whatever else the CLI starts go with it on abort
+    startInOwnProcessGroup(m_runProcess);
+    connect(m_runProcess, &QProcess::finished, this, &RunWorker::onRunProcessFinished);
+    connect(m_runProcess, &QProcess::errorOccurred, this, &RunWorker::onRunProcessErrored);
+    connect(m_runProcess, &QProcess::readyReadStandardError, this, &RunWorker::readyReadStandardError);
+    connect(m_runProcess, &QProcess::readyReadStandardOutput, this, &RunWorker::readyReadStandardOutput);
+
+    m_runTcpServer = new QTcpServer(this);
+    connect(m_runTcpServer, &QTcpServer::newConnection, this, &RunWorker::onNewConnection);
+
+    m_publishRetryTimer = new QTimer(this);
+    m_publishRetryTimer->setSingleShot(true);
+    m_publishRetryTimer->setInterval(PublishRetryIntervalMs);
+    connect(m_publishRetryTimer, &QTimer::timeout, this, &RunWorker::publishBatch);
+}
+
+RunWorker::~RunWorker()
+{
+    if (m_runProcess->state() != QProcess::NotRunning) {
+        m_runProcess->blockSignals(true);
+        killProcessTree(m_runProcess);
+        m_runProcess->waitForFinished(1000);
+    }
+}
+
+bool RunWorker::popBatch(LogBatch& batch) {
+  // Clear the flag before popping: anything pushed after this point will notify again
+  m_notifyPending.store(false, std::memory_order_release);
+  if (!m_batches.tryPop(batch)) {
+    return false;
+  }
+  m_backlogLines.fetch_sub(static_cast<qint64>(batch.size()), std::memory_order_relaxed);
+  return true;
+}
+
+qint64 RunWorker::suppressedLineCount() const {
+  return m_suppressedLineCount.load(std::memory_order_relaxed);
+}
+
+void RunWorker::setResultCache(WorkflowResultCache* resultCache, WorkflowCheckpoints* checkpoints, const QString& program) {
+  m_resultCache = resultCache;
+  m_checkpoints = checkpoints;
+  m_cacheProgram = program;
+}
+
+void RunWorker::setMeasureLibrary(MeasureLibrary* measureLibrary) {
+  m_measureLibrary = measureLibrary;
+}
+
+void RunWorker::appendLogLine(const QString& text, LogStyle style) {
+  if (m_logWriter.isOpen()) {
+    m_logWriter.append(text.toUtf8(), style);
+  }
+  if (!suppressLine(style)) {
+    m_batch.push_back(LogLine{text, style});
+  }
+}
+
+void RunWorker::appendRawLogLine(QByteArrayView utf8, LogStyle style) {
+  m_logWriter.append(utf8, style);
+  // Not even decoded when it's not going to be shown
+  if (!suppressLine(style)) {
+    m_batch.push_back(LogLine{QString::fromUtf8(utf8), style});
+  }
+}
+
+bool RunWorker::suppressLine(LogStyle style) {
+  if (!m_degraded) {
+    return false;
+  }
+  int counter = 0;
+  switch (style) {
+    case LogStyle::Debug:
+      counter = 0;
+      break;
+    case LogStyle::Info:
+      counter = 1;
+      break;
+    default:
+      // Warnings, errors, state transitions and measures always make it. So do plain lines: EnergyPlus' ** Severe **
+      // and Ruby backtraces have no level the classifier knows
+      return false;
+  }
+  if (++m_sampleCounter % SampleEvery == 0) {
+    return false;
+  }
+  ++m_suppressedCounts[counter];
+  m_suppressedLineCount.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+void RunWorker::updateDegradedMode() {
+  const qint64 backlog = m_backlogLines.load(std::memory_order_relaxed) + m_heldLineCount + static_cast<qint64>(m_batch.size());
+  // Once the process is done, whatever is left is the tail of the run: let it all through
+  if (!m_degraded && backlog > DegradeBacklogLines && m_isRunning) {
+    m_degraded = true;
+    m_sampleCounter = 0;
+    m_markerTimer.start();
+    m_batch.push_back(LogLine{tr("Output is coming in faster than it can be shown: only showing 1 in %1 DEBUG / INFO lines for now, "
+                                 "the run log keeps all of them")
+                                .arg(SampleEvery),
+                              LogStyle::Suppressed});
+  } else if (m_degraded && backlog < RecoverBacklogLines) {
+    appendSuppressedMarker();
+    m_degraded = false;
+  } else if (m_degraded && m_markerTimer.elapsed() >= SuppressedMarkerIntervalMs) {
+    appendSuppressedMarker();
+  }
+}
+
+void RunWorker::appendSuppressedMarker() {
+  const qint64 total = m_suppressedCounts[0] + m_suppressedCounts[1];
+  m_markerTimer.start();
+  if (total == 0) {
+    return;
+  }
+  const QLocale locale;
+  m_batch.push_back(LogLine{tr("%1 lines suppressed (%2 DEBUG, %3 INFO)")
+                              .arg(locale.toString(total), locale.toString(m_suppressedCounts[0]), locale.toString(m_suppressedCounts[1])),
+                            LogStyle::Suppressed});
+  std::fill(std::begin(m_suppressedCounts), std::end(m_suppressedCounts), 0);
+}
+
+void RunWorker::publishBatch() {
+  // The store keeps up with what the GUI is shown, whatever the GUI's backlog
+  m_logWriter.flush();
+  updateDegradedMode();
+  holdBatch();
+
+  bool published = false;
+  while (!m_heldBatches.empty()) {
+    // Counted before it's pushed, so the GUI can never take it off first
+    const auto lineCount = static_cast<qint64>(m_heldBatches.front().size());
+    m_backlogLines.fetch_add(lineCount, std::memory_order_relaxed);
+    if (!m_batches.tryPush(std::move(m_heldBatches.front()))) {
+      m_backlogLines.fetch_sub(lineCount, std::memory_order_relaxed);
+      // GUI is behind: hold on to the rest, and make sure it goes out even if the process goes quiet
+      if (!m_publishRetryTimer->isActive()) {
+        m_publishRetryTimer->start();
+      }
+      break;
+    }
+    m_heldBatches.pop_front();
+    m_heldLineCount -= lineCount;
+    published = true;
+  }
+  if (published && !m_notifyPending.exchange(true, std::memory_order_acq_rel)) {
+    emit batchesAvailable();
+  }
+  // Once runFinished is out, whoever owns us may tear the thread down: it waits for the last batch to be in the queue
+  if (m_finishing && m_heldBatches.empty()) {
+    m_finishing = false;
+    emit runFinished(m_finishExitCode, m_finishStatus);
+  }
+}
+
+void RunWorker::holdBatch() {
+  if (m_batch.empty()) {
+    return;
+  }
+  m_heldLineCount += static_cast<qint64>(m_batch.size());
+  if (m_heldBatches.empty() && m_batch.size() <= MaxBatchLines) {
+    // The usual case, the GUI keeps up and reads are small
+    m_heldBatches.push_back(std::move(m_batch));
+    m_batch = LogBatch();
+    return;
+  }
+  // Tops up the last held batch, then cuts the rest into new ones
+  for (LogLine& line : m_batch) {
+    if (m_heldBatches.empty() || m_heldBatches.back().size() >= MaxBatchLines) {
+      m_heldBatches.emplace_back();
+    }
+    m_heldBatches.back().push_back(std::move(line));
+  }
+  m_batch.clear();
+}
+
+void RunWorker::startRun(const QString& program, const QString& workflowJSONPath, const QString& logBasePath) {
+  if (refuseInvalidWorkflow(workflowJSONPath, logBasePath) || restoreFromCache(workflowJSONPath, logBasePath)) {
+    return;
+  }
+  const QStringList arguments = prepareRun(checkpointedWorkflow(workflowJSONPath), logBasePath);
+  m_runProcess->start(program, arguments);
+}
+
+void RunWorker::startPooledRun(const QString& workflowJSONPath, const QString& logBasePath) {
+  if (refuseInvalidWorkflow(workflowJSONPath, logBasePath) || restoreFromCache(workflowJSONPath, logBasePath)) {
+    return;
+  }
+  const QStringList arguments = prepareRun(checkpointedWorkflow(workflowJSONPath), logBasePath);
+  if (!m_hasSocketConnexion) {
+    // A warm worker's stdout isn't ours, the socket is the only way to get the output of the job
+    appendLogLine(tr("A pooled run needs the run socket."), LogStyle::ErrorH1);
+    finishRun(1, QProcess::NormalExit);
+    return;
+  }
+  emit pooledRunReady(arguments);
+}
+
+void RunWorker::finishPooledRun(int exitCode, QProcess::ExitStatus status) {
+  // The worker closes the run socket before it reports the end of the job, but that might not have reached us yet
+  if (!m_runSocket && m_runTcpServer->hasPendingConnections()) {
+    onNewConnection();
+  }
+  if (m_runSocket && m_runSocket->state() == QAbstractSocket::ConnectedState) {
+    m_runSocket->waitForDisconnected(PooledRunDrainTimeoutMs);
+  }
+  if (m_runSocket) {
+    onRunDataReady();
+  }
+  finishRun(exitCode, status);
+}
+
+bool RunWorker::refuseInvalidWorkflow(const QString& workflowJSONPath, const QString& logBasePath) {
+  m_preflightWarnings.clear();
+  m_preflightErrorCount = 0;
+  if (!m_measureLibrary) {
+    return false;
+  }
+  const WorkflowValidation validation = validateWorkflow(workflowJSONPath, m_measureLibrary);
+  qDebug() << "Workflow validated in" << validation.elapsedMs << "ms," << validation.issues.size() << "issues";
+  m_preflightErrorCount = validation.errorCount();
+  if (m_preflightErrorCount == 0) {
+    for (const WorkflowIssue& issue : validation.issues) {
+      m_preflightWarnings << issue.message;
+    }
+    return false;
+  }
+
+  // Nothing gets launched: only the store to open, for the log to say why
+  m_isRunning = true;
+  m_resultCacheKey.clear();
+  m_resumeStep = 0;
+  m_workflowJSONPath = workflowJSONPath;
+  m_logBasePath = logBasePath;
+  m_runTimer.start();
+  m_degraded = false;
+  m_logWriter.close();
+  if (!logBasePath.isEmpty() && !m_logWriter.open(logBasePath)) {
+    qDebug() << "Could not open run log store at " << logBasePath;
+  }
+  appendLogLine(tr("Workflow refused: the CLI would fail on %n problem(s), it was not launched", nullptr, m_preflightErrorCount),
+                LogStyle::ErrorH1);
+  appendLogLine(tr("Checked against the measures' schemas in %1 ms.").arg(validation.elapsedMs), LogStyle::Normal);
+  for (const WorkflowIssue& issue : validation.issues) {
+    appendLogLine(issue.message, issue.severity == WorkflowIssue::Severity::Error ? LogStyle::ErrorText : LogStyle::Warn);
+  }
+  emit workflowRefused(m_preflightErrorCount);
+  finishRun(1, QProcess::NormalExit);
+  return true;
+}
+
+bool RunWorker::restoreFromCache(const QString& workflowJSONPath, const QString& logBasePath) {
+  m_resultCacheKey.clear();
+  m_resumeStep = 0;
+  m_workflowJSONPath = workflowJSONPath;
+  m_logBasePath = logBasePath;
+  if (!m_resultCache) {
+    return false;
+  }
+
+  // Hashed before the run: whatever the inputs become while it runs, the outputs are those of these inputs
+  QElapsedTimer timer;
+  timer.start();
+  const QString key = m_resultCache->computeKey(workflowJSONPath, m_cacheProgram);
+  qDebug() << "Result cache key" << key << "computed in" << timer.elapsed() << "ms";
+  WorkflowResultCache::Entry entry;
+  if (!m_resultCache->lookup(key, &entry) || !m_resultCache->restore(entry, workflowJSONPath, logBasePath)) {
+    m_resultCacheKey = key;
+    return false;
+  }
+
+  // The store is the cached run's, copied over: the live view only gets told where the log is
+  const QLocale locale;
+  appendLogLine(tr("Restored from the result cache"), LogStyle::H1);
+  appendLogLine(tr("Same workflow, seed model, weather file, measures and CLI as the run of %1, which took %2 s.")
+                  .arg(locale.toString(entry.createdAt, QLocale::ShortFormat))
+                  .arg(entry.elapsedMs / 1000.0, 0, 'f', 1),
+                LogStyle::Normal);
+  appendLogLine(tr("Its outputs are back in %1, its log has %2 lines.")
+                  .arg(QFileInfo(workflowJSONPath).absolutePath(), locale.toString(entry.lineCount)),
+                LogStyle::Normal);
+  emit restoredFromCache(entry.createdAt, entry.elapsedMs);
+  finishRun(0, QProcess::NormalExit);
+  return true;
+}
+
+QString RunWorker::checkpointedWorkflow(const QString& workflowJSONPath) {
+  if (!m_checkpoints) {
+    return workflowJSONPath;
+  }
+  QElapsedTimer timer;
+  timer.start();
+  const WorkflowCheckpoints::Plan plan = m_checkpoints->prepare(workflowJSONPath, m_cacheProgram);
+  qDebug() << "Checkpoints planned in" << timer.elapsed() << "ms, running" << plan.workflowJSONPath;
+  m_resumeStep = plan.resumeStep;
+  if (m_resumeStep > 0) {
+    emit resumedFromCheckpoint(m_resumeStep);
+  }
+  return plan.workflowJSONPath;
+}
+
+QStringList RunWorker::prepareRun(const QString& workflowJSONPath, const QString& logBasePath) {
+  m_isRunning = true;
+
+  // The server has to listen from our own thread, so it's not done in the constructor
+  if (!m_runTcpServer->isListening()) {
+    m_runTcpServer->listen();
+  }
+
+  unsigned port = m_runTcpServer->serverPort();
+  m_hasSocketConnexion = (port != 0);
+  // NOTE: temp test, uncomment to see fallback to stdout
+  // m_hasSocketConnexion = false;
+
+  QStringList arguments;
+  arguments << "--verbose";
+
+  if (m_hasSocketConnexion) {
+    arguments << "run"
+              << "-s" << QString::number(port) << "-w" << workflowJSONPath;
+  } else {
+    arguments << "run"
+              << "--show-stdout"
+              // << "--style-stdout"
+              // << "--add-timings"
+              << "-w" << workflowJSONPath;
+  }
+  qDebug() << "run arguments = " << arguments.join(";");
+
+  m_stdoutFramer.reset();
+  m_stderrFramer.reset();
+  m_runTimer.start();
+  m_degraded = false;
+  std::fill(std::begin(m_suppressedCounts), std::end(m_suppressedCounts), 0);
+  m_suppressedLineCount.store(0, std::memory_order_relaxed);
+
+  m_logWriter.close();
+  if (!logBasePath.isEmpty() && !m_logWriter.open(logBasePath)) {
+    qDebug() << "Could not open run log store at " << logBasePath;
+  }
+
+  if (!m_preflightWarnings.isEmpty()) {
+    for (const QString& warning : m_preflightWarnings) {
+      appendLogLine(warning, LogStyle::Warn);
+    }
+    publishBatch();
+  }
+  if (m_resumeStep > 0) {
+    appendLogLine(tr("Resuming from a checkpoint: the first %1 steps are the same as in an earlier run, the CLI starts from the model they left")
+                    .arg(m_resumeStep),
+                  LogStyle::H2);
+    publishBatch();
+  }
+
+  if (!m_hasSocketConnexion) {
+    appendLogLine("Could not open socket connection to OpenStudio CLI.", LogStyle::ErrorH2);
+    appendLogLine("Falling back to stdout/stderr parsing, live updates might be slower.", LogStyle::ErrorText);
+    publishBatch();
+  }
+  return arguments;
+}
+
+void RunWorker::abortRun() {
+  m_isRunning = false;
+  // Whatever was still in flight belongs to the aborted run
+  m_publishRetryTimer->stop();
+  m_batch.clear();
+  m_heldBatches.clear();
+  m_heldLineCount = 0;
+  m_finishing = false;
+  closeRunSocket();
+  m_logWriter.close();
+
+  if (m_runProcess->state() == QProcess::NotRunning) {
+    emit runAborted(0, false, true);
+    return;
+  }
+  // The aborted run doesn't get a runFinished, runAborted says when its processes are gone instead
+  m_runProcess->blockSignals(true);
+  auto * terminator = new ProcessTreeTerminator(this);
+  connect(terminator, &ProcessTreeTerminator::finished, this, [this](qint64 latencyMs, bool forced, bool complete) {
+    if (m_runProcess->state() != QProcess::NotRunning) {
+      m_runProcess->waitForFinished(0);
+    }
+    m_runProcess->blockSignals(false);
+    emit runAborted(latencyMs, forced, complete);
+  });
+  terminator->terminate(m_runProcess);
+}
+
+void RunWorker::onNewConnection() {
+  m_runSocket = m_runTcpServer->nextPendingConnection();
+  m_runMessageParser.reset();
+  connect(m_runSocket, &QTcpSocket::readyRead, this, &RunWorker::onRunDataReady);
+}
+
+void RunWorker::closeRunSocket() {
+  if (m_runSocket) {
+    m_runSocket->disconnect(this);
+    m_runSocket->abort();
+    m_runSocket->deleteLater();
+  }
+  m_runSocket = nullptr;
+}
+
+void RunWorker::readyReadStandardOutput() {
+  const QByteArray data = m_runProcess->readAllStandardOutput();
+  m_stdoutFramer.feed(data, [this](QByteArrayView line) { handleStandardOutputLine(line); });
+  publishBatch();
+}
+
+void RunWorker::handleStandardOutputLine(QByteArrayView line) {
+  const QByteArrayView trimmed = trimmedView(line);
+  if (trimmed.isEmpty()) {
+    return;
+  }
+
+  if (m_runSocket != nullptr || m_hasSocketConnexion) {
+    // The socket carries everything structured, stdout is only scraped for its level: a WARN / ERROR there must
+    // keep its style, and not be sampled away with the INFO lines when degraded
+    const LineLevel level = classifyLevel(std::string_view(trimmed.data(), trimmed.size()));
+    appendRawLogLine(trimmed, level == LineLevel::None ? LogStyle::Info : logStyleForLevel(level));
+    return;
+  }
+
+  // For socket fall back
+  appendClassifiedLine(classifyLine(std::string_view(trimmed.data(), trimmed.size())), trimmed);
+}
+
+void RunWorker::appendClassifiedLine(const LineClass& lineClass, QByteArrayView line, int stepIndex) {
+
+  auto appendErrorText = [&](const QString& text) { appendLogLine(text, LogStyle::ErrorH1); };
+
+  auto appendH1Text = [&](const QString& text) { appendLogLine(text, LogStyle::H1); };
+
+  // Classification is done on the raw bytes, we only decode to UTF-16 what actually ends up in the log view
+  if (lineClass.level != LineLevel::None) {
+    appendRawLogLine(line, logStyleForLevel(lineClass.level));
+    return;
+  }
+
+  if (lineClass.event != WorkflowEvent::None) {
+    // Only a handful per run, next to the thousands of log lines
+    emit workflowEvent(lineClass.event, lineClass.state, stepIndex, QString::fromUtf8(line), m_runTimer.elapsed());
+  }
+
+  switch (lineClass.event) {
+    case WorkflowEvent::StateStarted:
+      if (const char* header = workflowStateHeader(lineClass.state)) {
+        appendH1Text(header);
+      }
+      break;
+    case WorkflowEvent::StateReturned:
+    case WorkflowEvent::Started:
+    case WorkflowEvent::Applied:
+      // no-op
+      break;
+    case WorkflowEvent::Failure:
+      appendErrorText("Failed.");
+      break;
+    case WorkflowEvent::Complete:
+      appendH1Text("Completed.");
+      break;
+    case WorkflowEvent::Applying:
+      appendRawLogLine(line, LogStyle::H2);
+      break;
+    case WorkflowEvent::None: {
+      // Socket messages may come without a level, the text still tells: only plain lines end up Normal
+      const LineLevel level = classifyLevel(std::string_view(line.data(), line.size()));
+      appendRawLogLine(line, level == LineLevel::None ? LogStyle::Normal : logStyleForLevel(level));
+      break;
+    }
+  }
+}
+
+void RunWorker::readyReadStandardError() {
+  const QByteArray data = m_runProcess->readAllStandardError();
+  m_stderrFramer.feed(data, [this](QByteArrayView line) { handleStandardErrorLine(line); });
+  publishBatch();
+}
+
+void RunWorker::handleStandardErrorLine(QByteArrayView line) {
+  auto appendErrorText = [&](const QString& text) { appendLogLine(text, LogStyle::Stderr); };
+
+  if (trimmedView(line).isEmpty()) {
+    return;
+  } else {
+    appendErrorText("stderr: " + QString::fromUtf8(line));
+  }
+}
+
+void RunWorker::onRunProcessErrored(QProcess::ProcessError error) {
+  QString text = tr("onRunProcessErrored: Simulation failed to run, QProcess::ProcessError: ") + QString::number(error);
+  appendLogLine(text, LogStyle::ErrorH1);
+  publishBatch();
+}
+
+void RunWorker::onRunProcessFinished(int exitCode, QProcess::ExitStatus status) {
+  if (status == QProcess::NormalExit) {
+    qDebug() << "run finished, exit code = " << exitCode;
+  }
+
+  // Drain whatever is left in the socket and the pipes, including a last line without a trailing newline
+  if (m_runSocket) {
+    onRunDataReady();
+  }
+  readyReadStandardOutput();
+  readyReadStandardError();
+  m_stdoutFramer.finish([this](QByteArrayView line) { handleStandardOutputLine(line); });
+  m_stderrFramer.finish([this](QByteArrayView line) { handleStandardErrorLine(line); });
+
+  finishRun(exitCode, status);
+}
+
+void RunWorker::finishRun(int exitCode, QProcess::ExitStatus status) {
+  m_isRunning = false;
+  // A refused workflow already said why
+  if ((exitCode != 0 || status == QProcess::CrashExit) && m_preflightErrorCount == 0) {
+    appendLogLine(tr("Simulation failed to run, with exit code ") + QString::number(exitCode), LogStyle::ErrorH1);
+  }
+  if (m_degraded) {
+    appendSuppressedMarker();
+    m_degraded = false;
+  }
+
+  closeRunSocket();
+  const qint64 lineCount = m_logWriter.lineCount();
+  m_logWriter.close();
+
+  if (!m_resultCacheKey.isEmpty() && exitCode == 0 && status == QProcess::NormalExit) {
+    m_resultCache->store(m_resultCacheKey, m_workflowJSONPath, m_logBasePath, m_runTimer.elapsed(), lineCount);
+  }
+  m_resultCacheKey.clear();
+
+  // runFinished goes out with the last batch, the retry timer keeps publishing until then if the GUI is behind
+  m_finishing = true;
+  m_finishExitCode = exitCode;
+  m_finishStatus = status;
+  publishBatch();
+}
+
+void RunWorker::onRunDataReady() {
+  if (!m_runSocket) {
+    return;
+  }
+  const QByteArray data = m_runSocket->readAll();
+  const bool ok = m_runMessageParser.feed(data, [this](const RunMessage& message) { handleRunMessage(message); });
+  if (!ok) {
+    appendLogLine("Received corrupt data from the OpenStudio CLI socket.", LogStyle::ErrorH2);
+    appendLogLine("Falling back to stdout/stderr parsing, live updates might be slower.", LogStyle::ErrorText);
+    closeRunSocket();
+    m_hasSocketConnexion = false;
+  }
+  publishBatch();
+}
+
+void RunWorker::handleRunMessage(const RunMessage& message) {
+  appendClassifiedLine(LineClass{message.level, message.event, message.state}, message.message, message.stepIndex);
+}
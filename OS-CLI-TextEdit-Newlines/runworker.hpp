@@ -0,0 +1,174 @@
+#ifndef RUNWORKER_HPP
+#define RUNWORKER_HPP
+
+#include "lineframer.hpp"
+#include "runlogmodel.hpp"
+#include "runlogstore.hpp"
+#include "runprotocol.hpp"
+#include "spscqueue.hpp"
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QProcess>
+#include <QStringList>
+
+#include <atomic>
+#include <deque>
+#include <vector>
+
+class QTcpServer;
+class QTcpSocket;
+class QTimer;
+class MeasureLibrary;
+class WorkflowCheckpoints;
+class WorkflowResultCache;
+
+using LogBatch = std::vector<LogLine>;
+
+// Owns the CLI process and the run socket, and does all the reading / framing / classifying / formatting of their output.
+// Meant to live on its own QThread: the GUI thread only ever gets ready-to-render batches, through a lock-free
+// single producer / single consumer queue.
+class RunWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RunWorker(QObject *parent = nullptr);
+    ~RunWorker();
+
+    // Consumer side, called from the GUI thread
+    bool popBatch(LogBatch& batch);
+    // Lines of the current run that were only written to the store, not shown live. Safe from any thread
+    qint64 suppressedLineCount() const;
+
+    // Before the run starts: identical workflows get restored from the result cache rather than run, successful runs go
+    // into it, and the others resume from the last checkpoint their steps still match. Either can be null.
+    // program is the CLI that will run the job, part of the keys
+    void setResultCache(WorkflowResultCache* resultCache, WorkflowCheckpoints* checkpoints, const QString& program);
+    // Workflows are checked against the schemas of their measures before the CLI gets launched, see validateWorkflow.
+    // Not checked when null
+    void setMeasureLibrary(MeasureLibrary* measureLibrary);
+
+    // These must run on the worker's thread, use QMetaObject::invokeMethod from the GUI.
+    // Every line of the run also goes to the RunLogStore at logBasePath, if not empty
+    void startRun(const QString& program, const QString& workflowJSONPath, const QString& logBasePath = QString());
+    // Same, for a job that runs on a warm worker of the WorkerPool rather than in a process of its own: emits
+    // pooledRunReady with the command line the worker has to run, the pool then reports the end with finishPooledRun
+    void startPooledRun(const QString& workflowJSONPath, const QString& logBasePath = QString());
+    void finishPooledRun(int exitCode, QProcess::ExitStatus status);
+    // Stops the CLI and everything it started, gracefully then forcibly, see ProcessTreeTerminator. Emits runAborted
+    // once it's done, rather than runFinished
+    void abortRun();
+
+signals:
+    // Emitted when the queue goes from empty to non-empty, not once per batch
+    void batchesAvailable();
+
+    // Workflow phases and measures as they start and end, for the run's timeline. text is the line the event came from,
+    // msSinceStart is timed here, as soon as the line is read
+    void workflowEvent(WorkflowEvent event, WorkflowState state, int stepIndex, const QString& text, qint64 msSinceStart);
+
+    void pooledRunReady(const QStringList& arguments);
+
+    // Right before runFinished, when the run was restored from the result cache instead. createdAt and elapsedMs are
+    // the original run's
+    void restoredFromCache(const QDateTime& createdAt, qint64 elapsedMs);
+    // The first skippedSteps steps of the OSW are left out, the run starts from the model they left
+    void resumedFromCheckpoint(int skippedSteps);
+    // Right before runFinished, when the workflow was refused without launching the CLI
+    void workflowRefused(int errorCount);
+
+    void runFinished(int exitCode, QProcess::ExitStatus status);
+    // The processes of an aborted run are gone (or complete is false, and some were still there at the deadline).
+    // latencyMs is how long it took them, 0 when there was no process
+    void runAborted(qint64 latencyMs, bool forced, bool complete);
+
+private:
+    // Listens on the run socket, opens the store and resets the state of the previous run. Returns the CLI arguments
+    QStringList prepareRun(const QString& workflowJSONPath, const QString& logBasePath);
+    // Validates the workflow, and finishes the run right away if the CLI would fail on it anyway
+    bool refuseInvalidWorkflow(const QString& workflowJSONPath, const QString& logBasePath);
+    // Looks the workflow up in the result cache, and finishes the run right away with what's there if it can
+    bool restoreFromCache(const QString& workflowJSONPath, const QString& logBasePath);
+    // The OSW the CLI actually has to run, see WorkflowCheckpoints
+    QString checkpointedWorkflow(const QString& workflowJSONPath);
+    void onRunProcessFinished(int exitCode, QProcess::ExitStatus status);
+    // Publishes everything that's left, then emits runFinished: right away, or once the GUI has made room for it
+    void finishRun(int exitCode, QProcess::ExitStatus status);
+    void onRunProcessErrored(QProcess::ProcessError error);
+    void onNewConnection();
+    void onRunDataReady();
+    void readyReadStandardError();
+    void readyReadStandardOutput();
+    void handleStandardOutputLine(QByteArrayView line);
+    void handleStandardErrorLine(QByteArrayView line);
+    void handleRunMessage(const RunMessage& message);
+    void appendClassifiedLine(const LineClass& lineClass, QByteArrayView line, int stepIndex = -1);
+
+    void appendLogLine(const QString& text, LogStyle style);
+    // Same, for text we still have as raw bytes: spares the round trip through UTF-16 for the store
+    void appendRawLogLine(QByteArrayView utf8, LogStyle style);
+    // Whether a line that is going to the store should stay out of the live view: see updateDegradedMode
+    bool suppressLine(LogStyle style);
+    // Switches sampling on when the GUI has too many lines left to take, and back off once it has caught up
+    void updateDegradedMode();
+    // Tells the live view how many lines it missed since the last time
+    void appendSuppressedMarker();
+    // Hands the lines gathered so far over to the GUI
+    void publishBatch();
+    // Moves m_batch to the end of m_heldBatches, cut to size
+    void holdBatch();
+    void closeRunSocket();
+
+    QProcess* m_runProcess;
+    QTcpServer* m_runTcpServer;
+    QTcpSocket* m_runSocket = nullptr;
+    bool m_hasSocketConnexion = false;
+    bool m_isRunning = false;
+
+    LineFramer m_stdoutFramer;
+    LineFramer m_stderrFramer;
+    RunMessageParser m_runMessageParser;
+
+    RunLogWriter m_logWriter;
+    WorkflowResultCache* m_resultCache = nullptr;
+    WorkflowCheckpoints* m_checkpoints = nullptr;
+    QString m_cacheProgram;
+    MeasureLibrary* m_measureLibrary = nullptr;
+    // Pre-flight warnings of the current run, shown once its log is open
+    QStringList m_preflightWarnings;
+    // Pre-flight errors of the current run, which then doesn't get to the CLI
+    int m_preflightErrorCount = 0;
+    // Steps of the OSW the current run skips
+    int m_resumeStep = 0;
+    // Of the current run, empty when it isn't going to be cached
+    QString m_resultCacheKey;
+    QString m_workflowJSONPath;
+    QString m_logBasePath;
+    QElapsedTimer m_runTimer;
+
+    LogBatch m_batch;
+    // Batches of at most MaxBatchLines lines, waiting for room in m_batches
+    std::deque<LogBatch> m_heldBatches;
+    qint64 m_heldLineCount = 0;
+    QTimer* m_publishRetryTimer;
+    // The run is over, runFinished is held back until everything is published
+    bool m_finishing = false;
+    int m_finishExitCode = 0;
+    QProcess::ExitStatus m_finishStatus = QProcess::NormalExit;
+    SpscQueue<LogBatch> m_batches;
+    std::atomic<bool> m_notifyPending{false};
+    // Lines pushed to m_batches that the GUI hasn't popped yet
+    std::atomic<qint64> m_backlogLines{0};
+
+    // Degraded mode: DEBUG / INFO lines are sampled, everything else still goes through
+    bool m_degraded = false;
+    qint64 m_sampleCounter = 0;
+    // Since the last marker, DEBUG / INFO
+    qint64 m_suppressedCounts[2] = {0, 0};
+    QElapsedTimer m_markerTimer;
+    std::atomic<qint64> m_suppressedLineCount{0};
+};
+
+#endif // RUNWORKER_HPP
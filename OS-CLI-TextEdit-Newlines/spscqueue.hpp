@@ -0,0 +1,67 @@
+#ifndef SPSCQUEUE_HPP
+#define SPSCQUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread.
+// Neither side ever blocks: tryPush fails when full, tryPop fails when empty.
+template <typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(size_t capacity) : m_slots(roundUpToPowerOfTwo(capacity)), m_mask(m_slots.size() - 1) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer side
+    bool tryPush(T&& value) {
+      const size_t head = m_head.load(std::memory_order_relaxed);
+      if (head - m_tail.load(std::memory_order_acquire) == m_slots.size()) {
+        return false;
+      }
+      m_slots[head & m_mask] = std::move(value);
+      m_head.store(head + 1, std::memory_order_release);
+      return true;
+    }
+
+    // Consumer side
+    bool tryPop(T& value) {
+      const size_t tail = m_tail.load(std::memory_order_relaxed);
+      if (tail == m_head.load(std::memory_order_acquire)) {
+        return false;
+      }
+      value = std::move(m_slots[tail & m_mask]);
+      m_tail.store(tail + 1, std::memory_order_release);
+      return true;
+    }
+
+    // Only a snapshot when called while the other side is running
+    size_t sizeApprox() const {
+      return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const {
+      return m_slots.size();
+    }
+
+private:
+    static size_t roundUpToPowerOfTwo(size_t value) {
+      size_t result = 1;
+      while (result < value) {
+        result <<= 1;
+      }
+      return result;
+    }
+
+    std::vector<T> m_slots;
+    const size_t m_mask;
+    // Each index is written by one side only, keep them on their own cache lines so the two threads don't fight over it
+    alignas(64) std::atomic<size_t> m_head{0};
+    alignas(64) std::atomic<size_t> m_tail{0};
+};
+
+#endif // SPSCQUEUE_HPP
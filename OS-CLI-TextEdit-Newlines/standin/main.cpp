@@ -0,0 +1,462 @@
+// Stand-in for the openstudio CLI, so the runner can be exercised without an OpenStudio install.
+//
+// Understands the same command line the runner builds:
+//   openstudio-standin [--verbose] run [-s <port>] [--show-stdout] -w <workflow.osw>
+//
+// It walks the workflow states and the steps of the OSW like the real CLI does. With -s, the states / steps / log
+// lines go to the run socket using the framed protocol (runprotocol.hpp). Otherwise they're printed to stdout.
+// The runner's SaveModelCheckpoint steps (workflowcheckpoints.hpp) write a placeholder model where they're told to.
+//
+// On top of that it can generate load, to benchmark the ingestion path (see bench/ingestion_benchmark.cpp):
+//   --flood <lines>          extra logger lines during the simulation state, mixed with the EnergyPlus progress lines
+//   --rate <lines/s>         pace the flood, 0 (the default) for as fast as possible
+//   --mix <d,i,w,e>          relative weights of DEBUG / INFO / WARN / ERROR lines in the flood, default 70,20,8,2
+//   --partial-lines          cut the output into random sized writes, so lines arrive split across reads
+//   --socket-logs            send the flood through the run socket (when there is one) instead of stdout
+//   --ignore-socket          ignore -s, and print everything to stdout
+//   --state-delay <ms>       time spent in each workflow state, default 20
+//   --seed <n>               seed of the random generator, default 1
+//   --startup-delay <ms>     time spent "loading" before doing anything, like the real CLI's Ruby and gems, default 0
+// Since the runner builds the command line itself, these can also be given in the OPENSTUDIO_STANDIN_ARGS environment
+// variable, eg OPENSTUDIO_STANDIN_ARGS="--flood 1000000 --partial-lines"
+//
+// It can also be a warm worker of the runner's WorkerPool (workerpool.hpp):
+//   openstudio-standin --serve <local server name> [load options]
+// pays the startup delay once, then runs one workflow per "run" command it gets. Everything it would have printed to
+// stdout goes to the run socket of the job instead, since its stdout is shared by all of them.
+
+#include "../runprotocol.hpp"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHostAddress>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocalSocket>
+#include <QStringList>
+#include <QTcpSocket>
+#include <QThread>
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+
+namespace {
+
+struct Options
+{
+  bool verbose = false;
+  quint16 port = 0;
+  QString workflowPath;
+
+  qint64 floodLines = 0;
+  int rate = 0;
+  int mix[4] = {70, 20, 8, 2};
+  bool partialLines = false;
+  bool socketLogs = false;
+  bool ignoreSocket = false;
+  int stateDelayMs = 20;
+  quint32 seed = 1;
+  int startupDelayMs = 0;
+  QString serveName;
+};
+
+bool parseArguments(const QStringList& args, Options& options) {
+  bool hasRun = false;
+  for (int i = 1; i < args.size(); ++i) {
+    const QString& arg = args[i];
+    if (arg == "--verbose") {
+      options.verbose = true;
+    } else if (arg == "run") {
+      hasRun = true;
+    } else if ((arg == "-s" || arg == "--socket") && i + 1 < args.size()) {
+      options.port = args[++i].toUShort();
+    } else if ((arg == "-w" || arg == "--workflow") && i + 1 < args.size()) {
+      options.workflowPath = args[++i];
+    } else if (arg == "--show-stdout" || arg == "--style-stdout" || arg == "--add-timings") {
+      // Output always goes to stdout when there is no socket
+    } else if (arg == "--flood" && i + 1 < args.size()) {
+      options.floodLines = args[++i].toLongLong();
+    } else if (arg == "--rate" && i + 1 < args.size()) {
+      options.rate = args[++i].toInt();
+    } else if (arg == "--mix" && i + 1 < args.size()) {
+      const QStringList weights = args[++i].split(',');
+      if (weights.size() != 4) {
+        std::fprintf(stderr, "--mix takes 4 comma separated weights\n");
+        return false;
+      }
+      for (int level = 0; level < 4; ++level) {
+        options.mix[level] = std::max(0, weights[level].toInt());
+      }
+      if (std::all_of(std::begin(options.mix), std::end(options.mix), [](int weight) { return weight == 0; })) {
+        std::fprintf(stderr, "--mix needs at least one non zero weight\n");
+        return false;
+      }
+    } else if (arg == "--partial-lines") {
+      options.partialLines = true;
+    } else if (arg == "--socket-logs") {
+      options.socketLogs = true;
+    } else if (arg == "--ignore-socket") {
+      options.ignoreSocket = true;
+    } else if (arg == "--state-delay" && i + 1 < args.size()) {
+      options.stateDelayMs = args[++i].toInt();
+    } else if (arg == "--seed" && i + 1 < args.size()) {
+      options.seed = args[++i].toUInt();
+    } else if (arg == "--startup-delay" && i + 1 < args.size()) {
+      options.startupDelayMs = args[++i].toInt();
+    } else if (arg == "--serve" && i + 1 < args.size()) {
+      options.serveName = args[++i];
+    } else {
+      std::fprintf(stderr, "Unknown argument '%s'\n", qPrintable(arg));
+      return false;
+    }
+  }
+  return !options.serveName.isEmpty() || (hasRun && !options.workflowPath.isEmpty());
+}
+
+struct Step
+{
+  QString measureDirName;
+  // Only the runner's SaveModelCheckpoint steps have one
+  QString checkpointPath;
+};
+
+QList<Step> readMeasureSteps(const QString& workflowPath) {
+  QList<Step> result;
+  QFile file(workflowPath);
+  if (!file.open(QIODevice::ReadOnly)) {
+    return result;
+  }
+  const QJsonObject workflow = QJsonDocument::fromJson(file.readAll()).object();
+  for (const auto& value : workflow["steps"].toArray()) {
+    const QJsonObject step = value.toObject();
+    result << Step{step["measure_dir_name"].toString(), step["arguments"].toObject()["checkpoint_path"].toString()};
+  }
+  return result;
+}
+
+class Emitter
+{
+public:
+  Emitter(QTcpSocket* socket, const Options& options)
+    : m_socket(socket),
+      m_partialLines(options.partialLines),
+      m_stdoutToSocket(socket != nullptr && !options.serveName.isEmpty()),
+      m_random(options.seed) {}
+
+  bool hasSocket() const {
+    return m_socket != nullptr;
+  }
+
+  // A line of the human readable output: goes to the socket if we have one, stdout otherwise
+  void message(LineLevel level, WorkflowEvent event, WorkflowState state, int stepIndex, const QByteArray& text) {
+    if (m_socket) {
+      socketWrite(encodeRunMessage(RunMessage{level, event, state, stepIndex, text}));
+    } else {
+      stdoutLine(text);
+    }
+  }
+
+  void log(LineLevel level, const QByteArray& text) {
+    message(level, WorkflowEvent::None, WorkflowState::None, -1, text);
+  }
+
+  // What the CLI prints no matter what, eg the --verbose logger or EnergyPlus
+  void stdoutLine(const QByteArray& text) {
+    if (m_stdoutToSocket) {
+      socketWrite(encodeRunMessage(RunMessage{LineLevel::None, WorkflowEvent::None, WorkflowState::None, -1, text}));
+      return;
+    }
+    if (!m_partialLines) {
+      std::fwrite(text.constData(), 1, text.size(), stdout);
+      std::fputc('\n', stdout);
+      return;
+    }
+    // Windows line endings now and then too, the runner has to cope with both
+    m_stdoutPending += text;
+    m_stdoutPending += (m_random() % 8 == 0) ? "\r\n" : "\n";
+    while (m_stdoutPending.size() >= m_stdoutChunk) {
+      std::fwrite(m_stdoutPending.constData(), 1, m_stdoutChunk, stdout);
+      std::fflush(stdout);
+      m_stdoutPending.remove(0, m_stdoutChunk);
+      m_stdoutChunk = nextChunkSize();
+    }
+  }
+
+  void flush() {
+    if (!m_stdoutPending.isEmpty()) {
+      std::fwrite(m_stdoutPending.constData(), 1, m_stdoutPending.size(), stdout);
+      m_stdoutPending.clear();
+    }
+    std::fflush(stdout);
+    if (m_socket) {
+      if (!m_socketPending.isEmpty()) {
+        m_socket->write(m_socketPending);
+        m_socketPending.clear();
+      }
+      m_socket->flush();
+      m_socket->waitForBytesWritten(1000);
+    }
+  }
+
+  std::mt19937& random() {
+    return m_random;
+  }
+
+private:
+  // Anywhere between a few bytes and a few lines, so writes end mid-line (or mid-frame) most of the time
+  int nextChunkSize() {
+    return 1 + static_cast<int>(m_random() % 300);
+  }
+
+  void socketWrite(const QByteArray& frame) {
+    if (!m_partialLines) {
+      m_socket->write(frame);
+    } else {
+      m_socketPending += frame;
+      while (m_socketPending.size() >= m_socketChunk) {
+        m_socket->write(m_socketPending.constData(), m_socketChunk);
+        m_socket->flush();
+        m_socketPending.remove(0, m_socketChunk);
+        m_socketChunk = nextChunkSize();
+      }
+    }
+    // Without an event loop nothing gets sent until we ask, and a flood would pile up in memory
+    if (m_socket->bytesToWrite() > (1 << 20)) {
+      m_socket->waitForBytesWritten(1000);
+    }
+  }
+
+  QTcpSocket* m_socket;
+  const bool m_partialLines;
+  const bool m_stdoutToSocket;
+  std::mt19937 m_random;
+  QByteArray m_stdoutPending;
+  QByteArray m_socketPending;
+  int m_stdoutChunk = 1;
+  int m_socketChunk = 1;
+};
+
+QByteArray stateName(WorkflowState state) {
+  switch (state) {
+    case WorkflowState::Initialization:
+      return "initialization";
+    case WorkflowState::OsMeasures:
+      return "os_measures";
+    case WorkflowState::Translator:
+      return "translator";
+    case WorkflowState::EpMeasures:
+      return "ep_measures";
+    case WorkflowState::Preprocess:
+      return "preprocess";
+    case WorkflowState::Simulation:
+      return "simulation";
+    case WorkflowState::ReportingMeasures:
+      return "reporting_measures";
+    case WorkflowState::Postprocess:
+      return "postprocess";
+    case WorkflowState::None:
+      break;
+  }
+  return {};
+}
+
+// --flood: logger lines at the requested rate and mix, with the EnergyPlus progress lines in between
+void flood(Emitter& emitter, const Options& options) {
+  static const char* const levelTags[4] = {"<-2>", "<-1>", "<0>", "<1>"};
+  static const LineLevel levels[4] = {LineLevel::Debug, LineLevel::Info, LineLevel::Warn, LineLevel::Error};
+  static const char* const loggers[4] = {"[utilities.idf.WorkspaceObject]", "[openstudio.measure.OSRunner]", "[openstudio.energyplus.ForwardTranslator]",
+                                         "[openstudio.model.Space]"};
+  static const char* const texts[4] = {"Setting field %1 of OS:Surface, Surface %2", "Zone %2 has %1 surfaces",
+                                       "Surface %2 has no construction, using default construction %1", "Space %2 is not enclosed, %1 gaps found"};
+
+  std::discrete_distribution<int> mix(std::begin(options.mix), std::end(options.mix));
+  std::mt19937& random = emitter.random();
+  const bool toSocket = options.socketLogs && emitter.hasSocket();
+
+  QElapsedTimer timer;
+  timer.start();
+  for (qint64 i = 0; i < options.floodLines; ++i) {
+    const int level = mix(random);
+    const QByteArray text = QByteArray(loggers[level]) + ' ' + levelTags[level] + ' '
+                            + QByteArray(texts[level]).replace("%1", QByteArray::number(i % 97)).replace("%2", QByteArray::number(i));
+    if (toSocket) {
+      emitter.log(levels[level], text);
+    } else {
+      emitter.stdoutLine(text);
+    }
+
+    if (i % 1000 == 999) {
+      emitter.stdoutLine("Continuing Simulation at 01/" + QByteArray::number(1 + (i / 1000) % 31) + " for RUN PERIOD 1");
+    }
+    if (options.rate > 0 && i % 64 == 63) {
+      const qint64 dueMs = (i + 1) * 1000 / options.rate;
+      const qint64 aheadMs = dueMs - timer.elapsed();
+      if (aheadMs > 0) {
+        emitter.flush();
+        QThread::msleep(static_cast<unsigned long>(aheadMs));
+      }
+    }
+  }
+  emitter.flush();
+}
+
+// There's no model to save here, just something that looks like one
+void saveCheckpoint(const QString& path) {
+  const QString tempPath = path + '.' + QString::number(QCoreApplication::applicationPid()) + ".tmp";
+  QFile file(tempPath);
+  if (!file.open(QIODevice::WriteOnly)) {
+    return;
+  }
+  file.write("\nOS:Version,\n  {00000000-0000-0000-0000-000000000000}, !- Handle\n  3.4.0;                                  !- Version Identifier\n");
+  file.close();
+  QFile::remove(path);
+  QFile::rename(tempPath, path);
+}
+
+void runState(Emitter& emitter, const Options& options, WorkflowState state, const QList<Step>& steps) {
+  const QByteArray name = stateName(state);
+  emitter.message(LineLevel::None, WorkflowEvent::StateStarted, state, -1, "Starting state " + name);
+
+  if (options.verbose) {
+    emitter.stdoutLine("[openstudio.workflow.Run] <-2> Entering state " + name);
+  }
+
+  if (state == WorkflowState::OsMeasures) {
+    for (int i = 0; i < steps.size(); ++i) {
+      const QByteArray measure = steps[i].measureDirName.toUtf8();
+      emitter.message(LineLevel::None, WorkflowEvent::Applying, state, i, "Applying " + measure);
+      emitter.log(LineLevel::Info, "[openstudio.measure.OSRunner] <-1> Running " + measure);
+      if (options.verbose) {
+        for (int j = 0; j < 20; ++j) {
+          emitter.stdoutLine("[openstudio.model.Model] <-2> Setting field " + QByteArray::number(j) + " of " + measure);
+        }
+      }
+      if (!steps[i].checkpointPath.isEmpty()) {
+        saveCheckpoint(steps[i].checkpointPath);
+      }
+      emitter.message(LineLevel::None, WorkflowEvent::Applied, state, i, "Applied " + measure);
+      emitter.flush();
+    }
+  } else if (state == WorkflowState::Translator) {
+    emitter.log(LineLevel::Warn, "[openstudio.energyplus.ForwardTranslator] <0> Surface has no construction, using default");
+  } else if (state == WorkflowState::Simulation) {
+    emitter.stdoutLine("EnergyPlus Starting");
+    for (int day = 1; day <= 31; ++day) {
+      emitter.stdoutLine("Continuing Simulation at 01/" + QByteArray::number(day) + " for RUN PERIOD 1");
+    }
+    flood(emitter, options);
+    emitter.stdoutLine("EnergyPlus Completed Successfully.");
+  }
+
+  emitter.message(LineLevel::None, WorkflowEvent::StateReturned, state, -1, "Returned from state " + name);
+  emitter.flush();
+  if (options.stateDelayMs > 0) {
+    QThread::msleep(static_cast<unsigned long>(options.stateDelayMs));
+  }
+}
+
+// One workflow, start to end. Returns the exit code
+int runWorkflow(const Options& options) {
+  QTcpSocket socket;
+  QTcpSocket* runSocket = nullptr;
+  if (options.port != 0 && !options.ignoreSocket) {
+    socket.connectToHost(QHostAddress::LocalHost, options.port);
+    if (socket.waitForConnected(3000)) {
+      runSocket = &socket;
+    } else {
+      std::fprintf(stderr, "Could not connect to port %u, writing to stdout instead\n", options.port);
+    }
+  }
+
+  Emitter emitter(runSocket, options);
+
+  if (!QFile::exists(options.workflowPath)) {
+    emitter.log(LineLevel::Error, "[openstudio.workflow.Run] <1> Cannot find workflow " + options.workflowPath.toUtf8());
+    emitter.message(LineLevel::None, WorkflowEvent::Failure, WorkflowState::None, -1, "Failure");
+    emitter.flush();
+    return 1;
+  }
+  const QList<Step> steps = readMeasureSteps(options.workflowPath);
+
+  emitter.message(LineLevel::None, WorkflowEvent::Started, WorkflowState::None, -1, "Started");
+  for (auto state : {WorkflowState::Initialization, WorkflowState::OsMeasures, WorkflowState::Translator, WorkflowState::EpMeasures,
+                     WorkflowState::Preprocess, WorkflowState::Simulation, WorkflowState::ReportingMeasures, WorkflowState::Postprocess}) {
+    runState(emitter, options, state, steps);
+  }
+  emitter.message(LineLevel::None, WorkflowEvent::Complete, WorkflowState::None, -1, "Complete");
+  emitter.flush();
+
+  if (runSocket) {
+    runSocket->disconnectFromHost();
+    if (runSocket->state() != QAbstractSocket::UnconnectedState) {
+      runSocket->waitForDisconnected(1000);
+    }
+  }
+  return 0;
+}
+
+// Warm worker: "ready\t<pid>" once started, then for every "run\t<arg>\t<arg>..." line runs that command line, and
+// answers "done\t<exit code>". Stops on "quit", or when the runner goes away
+int serve(const Options& serveOptions) {
+  QLocalSocket control;
+  control.connectToServer(serveOptions.serveName);
+  if (!control.waitForConnected(3000)) {
+    std::fprintf(stderr, "Could not connect to worker pool '%s'\n", qPrintable(serveOptions.serveName));
+    return 1;
+  }
+  control.write("ready\t" + QByteArray::number(QCoreApplication::applicationPid()) + '\n');
+  control.waitForBytesWritten(1000);
+
+  for (;;) {
+    while (!control.canReadLine()) {
+      if (control.state() != QLocalSocket::ConnectedState || !control.waitForReadyRead(-1)) {
+        return 0;
+      }
+    }
+    const QList<QByteArray> fields = control.readLine().trimmed().split('\t');
+    if (fields.first() == "quit") {
+      return 0;
+    }
+    if (fields.first() != "run") {
+      std::fprintf(stderr, "Unknown worker command '%s'\n", fields.first().constData());
+      continue;
+    }
+
+    // The load options of the worker stay, the job only brings its own socket and workflow
+    Options options = serveOptions;
+    options.port = 0;
+    options.workflowPath.clear();
+    options.socketLogs = true;
+    QStringList args{"openstudio-standin"};
+    for (qsizetype i = 1; i < fields.size(); ++i) {
+      args << QString::fromUtf8(fields[i]);
+    }
+    const int exitCode = parseArguments(args, options) ? runWorkflow(options) : 1;
+    control.write("done\t" + QByteArray::number(exitCode) + '\n');
+    control.waitForBytesWritten(1000);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  QCoreApplication app(argc, argv);
+
+  QStringList arguments = app.arguments();
+  arguments << qEnvironmentVariable("OPENSTUDIO_STANDIN_ARGS").split(' ', Qt::SkipEmptyParts);
+
+  Options options;
+  if (!parseArguments(arguments, options)) {
+    std::fprintf(stderr, "Usage: openstudio-standin [--verbose] run [-s <port>] [--show-stdout] -w <workflow.osw> [load options]\n"
+                         "       openstudio-standin --serve <local server name> [load options]\n");
+    return 1;
+  }
+
+  if (options.startupDelayMs > 0) {
+    QThread::msleep(static_cast<unsigned long>(options.startupDelayMs));
+  }
+  return options.serveName.isEmpty() ? runWorkflow(options) : serve(options);
+}
@@ -0,0 +1,172 @@
+#include "timelinewidget.hpp"
+
+#include <QHelpEvent>
+#include <QPainter>
+#include <QTimer>
+#include <QToolTip>
+
+#include <algorithm>
+
+static constexpr int Margin = 6;
+static constexpr int LaneSpacing = 4;
+static constexpr int RepaintIntervalMs = 250;
+// Ticks get at least that far apart
+static constexpr int MinTickSpacing = 80;
+
+static QColor spanColor(const TimelineSpan& span, int measureIndex) {
+  const int hue = (static_cast<int>(span.state) * 40) % 360;
+  if (span.kind == TimelineSpan::Kind::Phase) {
+    return QColor::fromHsv(hue, 110, 225);
+  }
+  // Alternate shades, so back to back measures don't merge into one bar
+  return QColor::fromHsv(hue, measureIndex % 2 == 0 ? 150 : 80, 235);
+}
+
+// 1, 2 or 5 times a power of ten, the smallest that is at least minStepMs
+static qint64 tickStep(qint64 minStepMs) {
+  qint64 power = 1;
+  for (;;) {
+    for (qint64 factor : {1, 2, 5}) {
+      if (factor * power >= minStepMs) {
+        return factor * power;
+      }
+    }
+    power *= 10;
+  }
+}
+
+TimelineWidget::TimelineWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    setMouseTracking(true);
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+
+    m_repaintTimer = new QTimer(this);
+    m_repaintTimer->setInterval(RepaintIntervalMs);
+    connect(m_repaintTimer, &QTimer::timeout, this, [this]() {
+        if (!m_timeline || !m_timeline->isRunning()) {
+            m_repaintTimer->stop();
+        }
+        update();
+    });
+}
+
+void TimelineWidget::setTimeline(const RunTimeline* timeline) {
+  m_timeline = timeline;
+  if (m_timeline && m_timeline->isRunning()) {
+    m_repaintTimer->start();
+  }
+  update();
+}
+
+QSize TimelineWidget::sizeHint() const {
+  return QSize(600, minimumSizeHint().height());
+}
+
+QSize TimelineWidget::minimumSizeHint() const {
+  return QSize(labelWidth() + 100, 2 * Margin + 2 * laneHeight() + LaneSpacing + fontMetrics().height() + 6);
+}
+
+int TimelineWidget::laneHeight() const {
+  return fontMetrics().height() * 2;
+}
+
+int TimelineWidget::labelWidth() const {
+  return std::max(fontMetrics().horizontalAdvance(tr("Phases")), fontMetrics().horizontalAdvance(tr("Measures"))) + Margin;
+}
+
+qint64 TimelineWidget::totalMs() const {
+  return m_timeline ? std::max<qint64>(1, m_timeline->currentMs()) : 1;
+}
+
+QRectF TimelineWidget::spanRect(const TimelineSpan& span, qint64 totalMs) const {
+  const double x0 = Margin + labelWidth();
+  const double axisWidth = std::max(1, width() - labelWidth() - 2 * Margin);
+  const qint64 endMs = span.isOpen() ? std::max(span.startMs, m_timeline->currentMs()) : span.endMs;
+  const double left = x0 + axisWidth * static_cast<double>(span.startMs) / static_cast<double>(totalMs);
+  const double right = x0 + axisWidth * static_cast<double>(endMs) / static_cast<double>(totalMs);
+  const int lane = span.kind == TimelineSpan::Kind::Phase ? 0 : 1;
+  // Even the shortest span stays visible
+  return QRectF(left, Margin + lane * (laneHeight() + LaneSpacing), std::max(1.0, right - left), laneHeight());
+}
+
+const TimelineSpan* TimelineWidget::spanAt(const QPoint& pos) const {
+  if (!m_timeline) {
+    return nullptr;
+  }
+  const qint64 total = totalMs();
+  for (const auto& span : m_timeline->spans()) {
+    if (spanRect(span, total).contains(pos)) {
+      return &span;
+    }
+  }
+  return nullptr;
+}
+
+bool TimelineWidget::event(QEvent* event) {
+  if (event->type() == QEvent::ToolTip) {
+    const auto* helpEvent = static_cast<QHelpEvent*>(event);
+    if (const TimelineSpan* span = spanAt(helpEvent->pos())) {
+      const qint64 endMs = span->isOpen() ? m_timeline->currentMs() : span->endMs;
+      QString text = QString("%1: %2").arg(span->name, formatDuration(endMs - span->startMs));
+      if (span->isOpen()) {
+        text += tr(" (running)");
+      }
+      text += tr("\nfrom %1 to %2").arg(formatDuration(span->startMs), formatDuration(endMs));
+      QToolTip::showText(helpEvent->globalPos(), text, this);
+    } else {
+      QToolTip::hideText();
+      event->ignore();
+    }
+    return true;
+  }
+  return QWidget::event(event);
+}
+
+void TimelineWidget::paintEvent(QPaintEvent* /*event*/) {
+  QPainter painter(this);
+  painter.fillRect(rect(), palette().base());
+
+  const int lane = laneHeight();
+  painter.setPen(palette().color(QPalette::Text));
+  painter.drawText(QRect(Margin, Margin, labelWidth(), lane), Qt::AlignLeft | Qt::AlignVCenter, tr("Phases"));
+  painter.drawText(QRect(Margin, Margin + lane + LaneSpacing, labelWidth(), lane), Qt::AlignLeft | Qt::AlignVCenter, tr("Measures"));
+
+  // Time axis
+  const int x0 = Margin + labelWidth();
+  const int axisWidth = std::max(1, width() - labelWidth() - 2 * Margin);
+  const int axisY = Margin + 2 * lane + LaneSpacing + 2;
+  const qint64 total = totalMs();
+  painter.setPen(palette().color(QPalette::Mid));
+  painter.drawLine(x0, axisY, x0 + axisWidth, axisY);
+  const qint64 step = tickStep(std::max<qint64>(1, total * MinTickSpacing / axisWidth));
+  for (qint64 ms = 0; ms <= total; ms += step) {
+    const int x = x0 + static_cast<int>(static_cast<double>(axisWidth) * static_cast<double>(ms) / static_cast<double>(total));
+    painter.setPen(palette().color(QPalette::Mid));
+    painter.drawLine(x, Margin, x, axisY + 3);
+    painter.setPen(palette().color(QPalette::Text));
+    painter.drawText(QRect(x + 2, axisY + 2, MinTickSpacing, fontMetrics().height()), Qt::AlignLeft | Qt::AlignTop, formatDuration(ms));
+  }
+
+  if (!m_timeline) {
+    return;
+  }
+
+  int measureIndex = 0;
+  for (const auto& span : m_timeline->spans()) {
+    const QRectF bar = spanRect(span, total);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(spanColor(span, measureIndex));
+    painter.drawRect(bar);
+    if (span.kind == TimelineSpan::Kind::Measure) {
+      ++measureIndex;
+    }
+
+    // Names only where they fit, the tooltip has them all
+    const QRectF textRect = bar.adjusted(3, 0, -3, 0);
+    if (textRect.width() > fontMetrics().averageCharWidth() * 3) {
+      painter.setPen(Qt::black);
+      painter.drawText(textRect, Qt::AlignLeft | Qt::AlignVCenter, fontMetrics().elidedText(span.name, Qt::ElideRight, static_cast<int>(textRect.width())));
+    }
+  }
+}
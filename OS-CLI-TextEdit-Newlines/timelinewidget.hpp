@@ -0,0 +1,41 @@
+#ifndef TIMELINEWIDGET_HPP
+#define TIMELINEWIDGET_HPP
+
+#include "runtimeline.hpp"
+
+#include <QRectF>
+#include <QWidget>
+
+class QTimer;
+
+// Draws a RunTimeline: one lane for the phases, one for the measures, over a time axis. Hovering a span shows its duration
+class TimelineWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit TimelineWidget(QWidget *parent = nullptr);
+
+    // Not owned, must outlive the widget or be replaced first. Repaints on its own while the run goes on
+    void setTimeline(const RunTimeline* timeline);
+
+    QSize sizeHint() const override;
+    QSize minimumSizeHint() const override;
+
+protected:
+    bool event(QEvent* event) override;
+    void paintEvent(QPaintEvent* event) override;
+
+private:
+    int laneHeight() const;
+    int labelWidth() const;
+    // Whole length of the axis, in ms
+    qint64 totalMs() const;
+    QRectF spanRect(const TimelineSpan& span, qint64 totalMs) const;
+    const TimelineSpan* spanAt(const QPoint& pos) const;
+
+    const RunTimeline* m_timeline = nullptr;
+    QTimer* m_repaintTimer;
+};
+
+#endif // TIMELINEWIDGET_HPP
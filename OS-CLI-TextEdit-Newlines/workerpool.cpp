@@ -0,0 +1,243 @@
+#include "workerpool.hpp"
+#include "processtree.hpp"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QLocalServer>
+#include <QLocalSocket>
+
+#include <algorithm>
+
+// Time a worker gets to quit on its own when the pool goes away, before it's killed
+static constexpr int QuitTimeoutMs = 1000;
+
+WorkerPool::WorkerPool(QObject *parent)
+    : QObject(parent)
+{
+    m_server = new QLocalServer(this);
+    connect(m_server, &QLocalServer::newConnection, this, &WorkerPool::onNewConnection);
+}
+
+WorkerPool::~WorkerPool()
+{
+    for (auto& worker : m_workers) {
+        worker->process->disconnect(this);
+        if (worker->socket) {
+            worker->socket->disconnect(this);
+            worker->socket->write("quit\n");
+            worker->socket->flush();
+        }
+    }
+    for (auto& worker : m_workers) {
+        if (!worker->process->waitForFinished(QuitTimeoutMs)) {
+            killProcessTree(worker->process);
+            worker->process->waitForFinished(QuitTimeoutMs);
+        }
+    }
+}
+
+void WorkerPool::setProgram(const QString& program, const QStringList& arguments) {
+  m_program = program;
+  m_arguments = arguments;
+  if (m_program.isEmpty()) {
+    return;
+  }
+  if (!m_server->isListening()) {
+    // Unique per pool, and per process so two runners don't pick up each other's workers
+    const QString name = QString("openstudio-runner-%1-%2").arg(QCoreApplication::applicationPid()).arg(reinterpret_cast<quintptr>(this), 0, 16);
+    QLocalServer::removeServer(name);
+    if (!m_server->listen(name)) {
+      qWarning() << "Worker pool could not listen on" << name << ":" << m_server->errorString();
+      m_program.clear();
+      return;
+    }
+  }
+  launchWorkers();
+}
+
+bool WorkerPool::isEnabled() const {
+  return !m_program.isEmpty();
+}
+
+void WorkerPool::setSize(int size) {
+  m_size = std::max(0, size);
+  launchWorkers();
+}
+
+QString WorkerPool::program() const {
+  return m_program;
+}
+
+int WorkerPool::size() const {
+  return m_size;
+}
+
+int WorkerPool::acquireIdleWorker() {
+  for (auto& worker : m_workers) {
+    if (worker->state == WorkerState::Idle) {
+      worker->state = WorkerState::Busy;
+      return worker->id;
+    }
+  }
+  return -1;
+}
+
+void WorkerPool::runJob(int workerId, const QStringList& arguments) {
+  Worker* worker = findWorker(workerId);
+  if (!worker || worker->state != WorkerState::Busy) {
+    return;
+  }
+  worker->socket->write("run\t" + arguments.join('\t').toUtf8() + '\n');
+  worker->socket->flush();
+}
+
+void WorkerPool::releaseWorker(int workerId) {
+  Worker* worker = findWorker(workerId);
+  if (!worker || worker->state != WorkerState::Busy) {
+    return;
+  }
+  worker->state = WorkerState::Idle;
+  launchWorkers();
+  emit workerIdle();
+}
+
+void WorkerPool::abortJob(int workerId) {
+  Worker* worker = findWorker(workerId);
+  if (!worker || worker->state != WorkerState::Busy) {
+    emit jobAborted(workerId, 0, false, true);
+    return;
+  }
+  // Whoever aborted already knows: no jobFinished for it
+  worker->state = WorkerState::Stopping;
+  auto * terminator = new ProcessTreeTerminator(this);
+  connect(terminator, &ProcessTreeTerminator::finished, this,
+          [this, workerId](qint64 latencyMs, bool forced, bool complete) { emit jobAborted(workerId, latencyMs, forced, complete); });
+  terminator->terminate(worker->process);
+}
+
+qint64 WorkerPool::startupMs(int workerId) const {
+  const Worker* worker = findWorker(workerId);
+  return worker ? worker->startupMs : -1;
+}
+
+void WorkerPool::launchWorkers() {
+  if (!isEnabled()) {
+    return;
+  }
+
+  int activeCount = 0;
+  for (auto& worker : m_workers) {
+    if (worker->state == WorkerState::Stopping) {
+      continue;
+    }
+    if (activeCount < m_size) {
+      ++activeCount;
+    } else if (worker->state == WorkerState::Idle) {
+      // One too many: busy ones get to finish their job first, see onControlReadyRead
+      worker->state = WorkerState::Stopping;
+      worker->socket->write("quit\n");
+      worker->socket->flush();
+    }
+  }
+
+  for (; activeCount < m_size; ++activeCount) {
+    auto worker = std::make_unique<Worker>();
+    worker->id = m_nextWorkerId++;
+    worker->process = new QProcess(this);
+    worker->process->setProcessChannelMode(QProcess::ForwardedChannels);
+    // So an aborted job takes whatever the worker started for it along
+    startInOwnProcessGroup(worker->process);
+    const int workerId = worker->id;
+    connect(worker->process, &QProcess::finished, this, [this, workerId]() { onWorkerFinished(workerId); });
+    connect(worker->process, &QProcess::errorOccurred, this, [this, workerId](QProcess::ProcessError error) {
+      if (error == QProcess::FailedToStart) {
+        onWorkerFinished(workerId);
+      }
+    });
+    worker->launchTimer.start();
+    worker->process->start(m_program, QStringList(m_arguments) << "--serve" << m_server->fullServerName());
+    m_workers.push_back(std::move(worker));
+  }
+}
+
+void WorkerPool::onNewConnection() {
+  while (QLocalSocket* socket = m_server->nextPendingConnection()) {
+    // Anonymous until it says which process it is
+    connect(socket, &QLocalSocket::readyRead, this, [this, socket]() { onControlReadyRead(socket); });
+    // Once bound, the socket goes away with its worker
+    connect(socket, &QLocalSocket::disconnected, this, [this, socket]() {
+      if (std::none_of(m_workers.cbegin(), m_workers.cend(), [socket](const auto& worker) { return worker->socket == socket; })) {
+        socket->deleteLater();
+      }
+    });
+  }
+}
+
+void WorkerPool::onControlReadyRead(QLocalSocket* socket) {
+  while (socket->canReadLine()) {
+    const QList<QByteArray> fields = socket->readLine().trimmed().split('\t');
+    const QByteArray& command = fields.first();
+
+    if (command == "ready" && fields.size() == 2) {
+      const qint64 pid = fields[1].toLongLong();
+      const auto it = std::find_if(m_workers.begin(), m_workers.end(),
+                                   [pid](const auto& worker) { return worker->socket == nullptr && worker->process->processId() == pid; });
+      if (it == m_workers.end()) {
+        socket->disconnectFromServer();
+        return;
+      }
+      Worker& worker = **it;
+      worker.socket = socket;
+      worker.startupMs = worker.launchTimer.elapsed();
+      if (worker.state == WorkerState::Starting) {
+        worker.state = WorkerState::Idle;
+        emit workerIdle();
+      }
+    } else if (command == "done" && fields.size() == 2) {
+      const auto it = std::find_if(m_workers.begin(), m_workers.end(), [socket](const auto& worker) { return worker->socket == socket; });
+      if (it == m_workers.end() || (*it)->state != WorkerState::Busy) {
+        continue;
+      }
+      Worker& worker = **it;
+      worker.state = WorkerState::Idle;
+      const int workerId = worker.id;
+      // Might be one too many now, if the pool was made smaller during the job
+      launchWorkers();
+      emit jobFinished(workerId, fields[1].toInt(), false);
+      emit workerIdle();
+    } else {
+      qWarning() << "Worker pool: unexpected message" << fields.join(' ');
+    }
+  }
+}
+
+void WorkerPool::onWorkerFinished(int workerId) {
+  const auto it = std::find_if(m_workers.begin(), m_workers.end(), [workerId](const auto& worker) { return worker->id == workerId; });
+  if (it == m_workers.end()) {
+    return;
+  }
+  const WorkerState state = (*it)->state;
+  (*it)->process->deleteLater();
+  if ((*it)->socket) {
+    (*it)->socket->disconnect(this);
+    (*it)->socket->deleteLater();
+  }
+  m_workers.erase(it);
+
+  if (state == WorkerState::Starting) {
+    // Most likely the program doesn't know --serve: don't keep launching it, jobs go back to cold runs
+    qWarning() << "Worker" << m_program << "died while starting, the worker pool is disabled";
+    m_program.clear();
+    emit workerIdle();
+    return;
+  }
+  if (state == WorkerState::Busy) {
+    emit jobFinished(workerId, -1, true);
+  }
+  launchWorkers();
+}
+
+WorkerPool::Worker* WorkerPool::findWorker(int workerId) const {
+  const auto it = std::find_if(m_workers.cbegin(), m_workers.cend(), [workerId](const auto& worker) { return worker->id == workerId; });
+  return it == m_workers.cend() ? nullptr : it->get();
+}
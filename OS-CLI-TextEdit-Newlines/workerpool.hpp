@@ -0,0 +1,96 @@
+#ifndef WORKERPOOL_HPP
+#define WORKERPOOL_HPP
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QProcess>
+#include <QStringList>
+
+#include <memory>
+#include <vector>
+
+class QLocalServer;
+class QLocalSocket;
+
+// Long-lived CLI processes, started ahead of time so a job doesn't pay the interpreter / gem loading on every run.
+//
+// Each worker is launched as `<program> <arguments> --serve <server name>` and connects back to our local server. The
+// control protocol is one UTF-8 line per message, fields separated by tabs:
+//   worker -> pool   "ready\t<pid>"                  done starting up, idle
+//                    "done\t<exit code>"             the job is over, idle again
+//   pool -> worker   "run\t<arg>\t<arg>..."          run that CLI command line, eg "--verbose run -s <port> -w <osw>"
+//                    "quit"
+// A job's output only goes through its run socket (-s), exactly like a normal run: the worker's own stdout / stderr
+// are shared by all its jobs and just forwarded to ours.
+// See the --serve mode of openstudio-standin for a worker.
+class WorkerPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit WorkerPool(QObject *parent = nullptr);
+    ~WorkerPool();
+
+    // Nothing gets launched until then
+    void setProgram(const QString& program, const QStringList& arguments = QStringList());
+    bool isEnabled() const;
+    QString program() const;
+
+    // Launches workers up to that many, or stops the idle extra ones
+    void setSize(int size);
+    int size() const;
+
+    // Marks an idle worker as busy and returns its id, -1 if none is idle
+    int acquireIdleWorker();
+    void runJob(int workerId, const QStringList& arguments);
+    // Gives back a worker that was acquired but never got its job
+    void releaseWorker(int workerId);
+    // Stops the worker and everything it started for its job, gracefully then forcibly (see ProcessTreeTerminator).
+    // A fresh one gets launched in its place. Emits jobAborted once it's done
+    void abortJob(int workerId);
+
+    // How long that worker took to start: what a cold run would have paid on top of the job
+    qint64 startupMs(int workerId) const;
+
+signals:
+    // A worker is ready to take a job
+    void workerIdle();
+    // crashed: the worker died in the middle of the job, rather than reporting its end
+    void jobFinished(int workerId, int exitCode, bool crashed);
+    // The processes of an aborted job are gone, see RunWorker::runAborted. Right away if there was nothing to stop
+    void jobAborted(int workerId, qint64 latencyMs, bool forced, bool complete);
+
+private:
+    enum class WorkerState
+    {
+      Starting,
+      Idle,
+      Busy,
+      Stopping
+    };
+
+    struct Worker
+    {
+      int id = -1;
+      QProcess* process = nullptr;
+      QLocalSocket* socket = nullptr;
+      WorkerState state = WorkerState::Starting;
+      QElapsedTimer launchTimer;
+      qint64 startupMs = -1;
+    };
+
+    void launchWorkers();
+    void onNewConnection();
+    void onControlReadyRead(QLocalSocket* socket);
+    void onWorkerFinished(int workerId);
+    Worker* findWorker(int workerId) const;
+
+    QLocalServer* m_server;
+    QString m_program;
+    QStringList m_arguments;
+    int m_size = 0;
+    int m_nextWorkerId = 0;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+};
+
+#endif // WORKERPOOL_HPP
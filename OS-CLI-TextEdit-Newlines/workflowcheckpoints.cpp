@@ -0,0 +1,213 @@
+#include "workflowcheckpoints.hpp"
+#include "filehashcache.hpp"
+#include "measurelibrary.hpp"
+#include "workflowfiles.hpp"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QSaveFile>
+
+const QString WorkflowCheckpoints::SaveMeasureDirName = QStringLiteral("SaveModelCheckpoint");
+
+// Least recently used ones go past that
+static constexpr int MaxCheckpoints = 500;
+// Bump when the keys stop meaning the same thing
+static constexpr int KeyVersion = 1;
+
+static const char* const SaveMeasureScript = R"(# Written by the runner, see workflowcheckpoints.hpp
+class SaveModelCheckpoint < OpenStudio::Measure::ModelMeasure
+  def name
+    return 'Save Model Checkpoint'
+  end
+
+  def arguments(model)
+    args = OpenStudio::Measure::OSArgumentVector.new
+    args << OpenStudio::Measure::OSArgument.makeStringArgument('checkpoint_path', true)
+    return args
+  end
+
+  def run(model, runner, user_arguments)
+    super(model, runner, user_arguments)
+    return false unless runner.validateUserArguments(arguments(model), user_arguments)
+
+    # Saved aside then renamed, so a run that dies halfway never leaves half a checkpoint
+    path = runner.getStringArgumentValue('checkpoint_path', user_arguments)
+    temp_path = "#{path}.#{Process.pid}.tmp"
+    model.save(OpenStudio::Path.new(temp_path), true)
+    File.rename(temp_path, path)
+    runner.registerInfo("Model checkpoint saved to #{path}")
+    return true
+  end
+end
+
+SaveModelCheckpoint.new.registerWithApplication
+)";
+
+static const char* const SaveMeasureXml = R"(<?xml version="1.0"?>
+<measure>
+  <schema_version>3.0</schema_version>
+  <name>save_model_checkpoint</name>
+  <uid>3b0e0a9c-6f55-4a8e-9d4b-5d3c4a7f2c11</uid>
+  <class_name>SaveModelCheckpoint</class_name>
+  <display_name>Save Model Checkpoint</display_name>
+  <description>Saves the model as it is at this step of the workflow, so the runner can restart from there.</description>
+  <modeler_description>Added by the runner, not meant to be used in a workflow by hand.</modeler_description>
+  <arguments>
+    <argument>
+      <name>checkpoint_path</name>
+      <display_name>Checkpoint Path</display_name>
+      <type>String</type>
+      <required>true</required>
+      <model_dependent>false</model_dependent>
+    </argument>
+  </arguments>
+  <outputs/>
+  <provenances/>
+  <tags/>
+  <attributes>
+    <attribute>
+      <name>Measure Type</name>
+      <value>ModelMeasure</value>
+      <datatype>string</datatype>
+    </attribute>
+  </attributes>
+  <files>
+    <file>
+      <filename>measure.rb</filename>
+      <filetype>rb</filetype>
+      <usage_type>script</usage_type>
+    </file>
+  </files>
+</measure>
+)";
+
+// Only writes when the content differs, so the file hashes stay valid
+static void writeFileIfChanged(const QString& path, const QByteArray& content) {
+  QFile existing(path);
+  if (existing.open(QIODevice::ReadOnly) && existing.readAll() == content) {
+    return;
+  }
+  existing.close();
+  QSaveFile file(path);
+  if (!file.open(QIODevice::WriteOnly) || file.write(content) < 0 || !file.commit()) {
+    qDebug() << "Could not write" << path;
+  }
+}
+
+WorkflowCheckpoints::WorkflowCheckpoints(const QString& directory, FileHashCache* fileHashes, MeasureLibrary* measureLibrary)
+    : m_directory(directory), m_fileHashes(fileHashes), m_measureLibrary(measureLibrary)
+{
+    const QDir dir(m_directory);
+    dir.mkpath("models");
+    dir.mkpath("workflows");
+    dir.mkpath("measures/" + SaveMeasureDirName);
+    writeFileIfChanged(dir.filePath("measures/" + SaveMeasureDirName + "/measure.rb"), SaveMeasureScript);
+    writeFileIfChanged(dir.filePath("measures/" + SaveMeasureDirName + "/measure.xml"), SaveMeasureXml);
+}
+
+QString WorkflowCheckpoints::directory() const {
+  return m_directory;
+}
+
+WorkflowCheckpoints::Plan WorkflowCheckpoints::prepare(const QString& workflowJSONPath, const QString& program) {
+  Plan plan;
+  plan.workflowJSONPath = workflowJSONPath;
+
+  WorkflowFiles files;
+  if (!files.load(workflowJSONPath) || files.seedPath.isEmpty()) {
+    return plan;
+  }
+
+  // The OpenStudio measures come first in a workflow, only those can be checkpointed
+  const QDir dir(m_directory);
+  QStringList keys;
+  QCryptographicHash base(QCryptographicHash::Sha256);
+  base.addData("version\n" + QByteArray::number(KeyVersion) + "\nseed\n" + m_fileHashes->fileHash(files.seedPath) + "\nweather\n"
+               + (files.weatherPath.isEmpty() ? QByteArray("missing") : m_fileHashes->fileHash(files.weatherPath)) + "\ncli\n"
+               + FileHashCache::programHash(program));
+  QByteArray previousKey = base.result().toHex();
+  for (const auto& step : files.steps) {
+    if (step.measureDir.isEmpty()) {
+      break;
+    }
+    const auto schema = m_measureLibrary->schema(step.measureDir);
+    if (!schema || schema->measureType != MeasureSchema::MeasureType::Model) {
+      break;
+    }
+    QCryptographicHash key(QCryptographicHash::Sha256);
+    key.addData(previousKey + '\n' + step.measureDirName.toUtf8() + '\n' + m_fileHashes->measureHash(step.measureDir) + '\n'
+                // Keys are sorted: the same arguments always give the same bytes
+                + QJsonDocument(step.arguments).toJson(QJsonDocument::Compact));
+    previousKey = key.result().toHex();
+    keys << QString::fromLatin1(previousKey);
+  }
+  m_fileHashes->save();
+  if (keys.isEmpty()) {
+    return plan;
+  }
+
+  auto modelPath = [&dir](const QString& key) { return dir.filePath("models/" + key + ".osm"); };
+  for (int step = static_cast<int>(keys.size()); step > 0; --step) {
+    if (QFile::exists(modelPath(keys[step - 1]))) {
+      plan.resumeStep = step;
+      break;
+    }
+  }
+
+  const QJsonArray originalSteps = files.workflow.value("steps").toArray();
+  QJsonArray steps;
+  for (int step = plan.resumeStep; step < originalSteps.size(); ++step) {
+    steps.append(originalSteps[step]);
+    if (step < keys.size() && !QFile::exists(modelPath(keys[step]))) {
+      QJsonObject arguments;
+      arguments["checkpoint_path"] = modelPath(keys[step]);
+      QJsonObject saveStep;
+      saveStep["measure_dir_name"] = SaveMeasureDirName;
+      saveStep["arguments"] = arguments;
+      steps.append(saveStep);
+      ++plan.saveCount;
+    }
+  }
+
+  // Same root as the original, so its relative paths still resolve and the outputs land in the same place
+  QJsonObject workflow = files.workflow;
+  workflow["root"] = files.rootDir;
+  workflow["steps"] = steps;
+  QJsonArray measurePaths = QJsonArray::fromStringList(files.measurePaths());
+  measurePaths.append(dir.filePath("measures"));
+  workflow["measure_paths"] = measurePaths;
+  if (plan.resumeStep > 0) {
+    const QString checkpointPath = modelPath(keys[plan.resumeStep - 1]);
+    workflow["seed_file"] = checkpointPath;
+    // Recently used, as far as prune() is concerned
+    QFile checkpoint(checkpointPath);
+    if (checkpoint.open(QIODevice::ReadWrite)) {
+      checkpoint.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    }
+  }
+
+  const QByteArray content = QJsonDocument(workflow).toJson();
+  const QString path = dir.filePath("workflows/" + QFileInfo(workflowJSONPath).completeBaseName() + '_'
+                                    + QCryptographicHash::hash(content, QCryptographicHash::Sha256).toHex().left(16) + ".osw");
+  QMutexLocker locker(&m_mutex);
+  writeFileIfChanged(path, content);
+  plan.workflowJSONPath = path;
+  prune();
+  return plan;
+}
+
+void WorkflowCheckpoints::prune() {
+  QFileInfoList models = QDir(QDir(m_directory).filePath("models")).entryInfoList({"*.osm"}, QDir::Files, QDir::Time);
+  // Newest first
+  for (qsizetype i = MaxCheckpoints; i < models.size(); ++i) {
+    QFile::remove(models[i].absoluteFilePath());
+  }
+}
@@ -0,0 +1,59 @@
+#ifndef WORKFLOWCHECKPOINTS_HPP
+#define WORKFLOWCHECKPOINTS_HPP
+
+#include <QMutex>
+#include <QString>
+
+class FileHashCache;
+class MeasureLibrary;
+
+// Intermediate models of the runs, one after each OpenStudio measure step, so a workflow whose first steps didn't change
+// starts from the model they left rather than from the seed.
+//
+// A checkpoint is keyed by everything that went into its model: the seed, the weather file, the CLI, and every step up to
+// it (its measure's files and its arguments). The first step without a checkpoint is the first one whose inputs changed:
+// the run restarts from the checkpoint just before it, through a copy of the OSW with that checkpoint as seed_file and
+// only the steps left. The copy also gets a SaveModelCheckpoint step after each OpenStudio measure step that doesn't have
+// its checkpoint yet, so the next run can skip it.
+// Only OpenStudio measures are checkpointed: past them the model is translated and simulated, and the CLI has no way to
+// start from there. A changed EnergyPlus or reporting measure still skips all the OpenStudio ones.
+//
+// On disk, under the checkpoint directory:
+//   models/<key>.osm                  the model after a step
+//   measures/SaveModelCheckpoint/     the measure that saves them
+//   workflows/<name>_<hash>.osw       the OSWs that actually get run
+// The RunWorkers of all the jobs share one: every method is thread safe.
+class WorkflowCheckpoints
+{
+public:
+    static const QString SaveMeasureDirName;
+
+    struct Plan
+    {
+      // What to run: the original OSW when there's nothing to checkpoint
+      QString workflowJSONPath;
+      // Steps that are skipped, 0 for a run from the seed
+      int resumeStep = 0;
+      // Checkpoints the run is going to save
+      int saveCount = 0;
+    };
+
+    // Inputs are hashed through fileHashes, and measures told apart through measureLibrary. Both must outlive the checkpoints
+    WorkflowCheckpoints(const QString& directory, FileHashCache* fileHashes, MeasureLibrary* measureLibrary);
+
+    QString directory() const;
+
+    // Falls back to the original OSW if anything is off, eg it can't be read or a measure can't be found
+    Plan prepare(const QString& workflowJSONPath, const QString& program);
+
+private:
+    // Only keeps the most recently used models
+    void prune();
+
+    QString m_directory;
+    FileHashCache* m_fileHashes;
+    MeasureLibrary* m_measureLibrary;
+    QMutex m_mutex;
+};
+
+#endif // WORKFLOWCHECKPOINTS_HPP
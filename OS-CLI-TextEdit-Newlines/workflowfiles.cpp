@@ -0,0 +1,105 @@
+#include "workflowfiles.hpp"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QObject>
+
+// Same defaults as the CLI's WorkflowJSON
+static const QStringList DefaultFilePaths = {"files", "weather", "../../files", "../../weather", "./"};
+static const QStringList DefaultMeasurePaths = {"measures", "../../measures", "./"};
+
+static QStringList stringList(const QJsonValue& value, const QStringList& defaultValue) {
+  if (!value.isArray()) {
+    return defaultValue;
+  }
+  QStringList result;
+  for (const QJsonValue& item : value.toArray()) {
+    result << item.toString();
+  }
+  return result;
+}
+
+// First match of name in searchPaths (relative to rootDir), empty if there is none
+static QString findPath(const QString& rootDir, const QStringList& searchPaths, const QString& name, bool isDir) {
+  if (name.isEmpty()) {
+    return QString();
+  }
+  auto exists = [isDir](const QString& path) {
+    const QFileInfo info(path);
+    return isDir ? info.isDir() : info.isFile();
+  };
+  if (QDir::isAbsolutePath(name)) {
+    return exists(name) ? QDir::cleanPath(name) : QString();
+  }
+  for (const QString& searchPath : searchPaths) {
+    const QString path = QDir::cleanPath(QDir(QDir(rootDir).absoluteFilePath(searchPath)).absoluteFilePath(name));
+    if (exists(path)) {
+      return path;
+    }
+  }
+  return QString();
+}
+
+bool WorkflowFiles::load(const QString& path, QString* error) {
+  *this = WorkflowFiles();
+  workflowPath = QFileInfo(path).absoluteFilePath();
+
+  QFile file(workflowPath);
+  if (!file.open(QIODevice::ReadOnly)) {
+    if (error) {
+      *error = QObject::tr("Cannot open %1").arg(workflowPath);
+    }
+    return false;
+  }
+  QJsonParseError parseError;
+  const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+  if (!document.isObject()) {
+    if (error) {
+      *error = QObject::tr("%1 is not a valid workflow: %2").arg(workflowPath, parseError.errorString());
+    }
+    return false;
+  }
+  workflow = document.object();
+
+  const QDir workflowDir = QFileInfo(workflowPath).absoluteDir();
+  const QString root = workflow.value("root").toString();
+  rootDir = root.isEmpty() ? workflowDir.absolutePath() : QDir::cleanPath(workflowDir.absoluteFilePath(root));
+
+  seedFile = workflow.value("seed_file").toString();
+  seedPath = findPath(rootDir, filePaths(), seedFile, false);
+  weatherFile = workflow.value("weather_file").toString();
+  weatherPath = findPath(rootDir, filePaths(), weatherFile, false);
+
+  const QStringList measureSearchPaths = measurePaths();
+  for (const QJsonValue& value : workflow.value("steps").toArray()) {
+    const QJsonObject stepObject = value.toObject();
+    Step step;
+    step.measureDirName = stepObject.value("measure_dir_name").toString();
+    step.measureDir = findPath(rootDir, measureSearchPaths, step.measureDirName, true);
+    step.arguments = stepObject.value("arguments").toObject();
+    steps.push_back(step);
+  }
+  return true;
+}
+
+QStringList WorkflowFiles::filePaths() const {
+  return stringList(workflow.value("file_paths"), DefaultFilePaths);
+}
+
+QStringList WorkflowFiles::measurePaths() const {
+  return stringList(workflow.value("measure_paths"), DefaultMeasurePaths);
+}
+
+QStringList WorkflowFiles::measureSearchDirs() const {
+  QStringList result;
+  for (const QString& searchPath : measurePaths()) {
+    const QString path = QDir::cleanPath(QDir(rootDir).absoluteFilePath(searchPath));
+    if (QFileInfo(path).isDir() && !result.contains(path)) {
+      result << path;
+    }
+  }
+  return result;
+}
@@ -0,0 +1,42 @@
+#ifndef WORKFLOWFILES_HPP
+#define WORKFLOWFILES_HPP
+
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+
+#include <vector>
+
+// An OSW and the files it refers to, found the way the CLI looks for them: absolute paths as is, otherwise through
+// "file_paths" (seed and weather files) and "measure_paths" (measure directories), relative to the workflow's root
+// directory. A file that can't be found has an empty path.
+struct WorkflowFiles
+{
+  struct Step
+  {
+    QString measureDirName;
+    // Empty when not found
+    QString measureDir;
+    QJsonObject arguments;
+  };
+
+  QString workflowPath;
+  QJsonObject workflow;
+  QString rootDir;
+
+  QString seedFile;  // as written in the OSW, may be empty
+  QString seedPath;
+  QString weatherFile;
+  QString weatherPath;
+  std::vector<Step> steps;
+
+  // False if the OSW can't be read or isn't a JSON object, with the reason in error
+  bool load(const QString& workflowPath, QString* error = nullptr);
+
+  QStringList filePaths() const;
+  QStringList measurePaths() const;
+  // measurePaths() that exist, as absolute directories
+  QStringList measureSearchDirs() const;
+};
+
+#endif // WORKFLOWFILES_HPP
@@ -0,0 +1,215 @@
+#include "workflowvalidator.hpp"
+#include "epwfile.hpp"
+#include "measurelibrary.hpp"
+#include "osmfile.hpp"
+#include "workflowfiles.hpp"
+
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QObject>
+
+#include <algorithm>
+#include <cmath>
+
+// Objects read from the head of the seed model, OS:Version being the first one when it's there
+static constexpr int SeedHeadObjects = 16;
+
+int WorkflowValidation::errorCount() const {
+  return static_cast<int>(
+    std::count_if(issues.cbegin(), issues.cend(), [](const WorkflowIssue& issue) { return issue.severity == WorkflowIssue::Severity::Error; }));
+}
+
+// As it's written in the OSW
+static QString jsonText(const QJsonValue& value) {
+  switch (value.type()) {
+    case QJsonValue::Bool:
+      return value.toBool() ? QStringLiteral("true") : QStringLiteral("false");
+    case QJsonValue::Double:
+      return QString::number(value.toDouble());
+    case QJsonValue::String:
+      return '"' + value.toString() + '"';
+    case QJsonValue::Array:
+      return QStringLiteral("a list");
+    case QJsonValue::Object:
+      return QStringLiteral("an object");
+    default:
+      break;
+  }
+  return QStringLiteral("null");
+}
+
+// The CLI takes numbers as strings too, it converts them
+static bool numberValue(const QJsonValue& value, double* number) {
+  if (value.isDouble()) {
+    *number = value.toDouble();
+    return true;
+  }
+  bool ok = false;
+  if (value.isString()) {
+    *number = value.toString().trimmed().toDouble(&ok);
+  }
+  return ok;
+}
+
+// Empty when the value fits the argument
+static QString checkArgumentValue(const MeasureArgument& argument, const QJsonValue& value) {
+  if (value.isArray() || value.isObject() || value.isNull()) {
+    return QObject::tr("expects a %1, got %2").arg(measureArgumentTypeName(argument.type), jsonText(value));
+  }
+
+  switch (argument.type) {
+    case MeasureArgument::Type::Boolean: {
+      const QString text = value.toString();
+      if (!value.isBool() && text.compare(QLatin1String("true"), Qt::CaseInsensitive) != 0
+          && text.compare(QLatin1String("false"), Qt::CaseInsensitive) != 0) {
+        return QObject::tr("expects a Boolean, got %1").arg(jsonText(value));
+      }
+      break;
+    }
+    case MeasureArgument::Type::Double:
+    case MeasureArgument::Type::Integer: {
+      double number = 0.0;
+      if (!numberValue(value, &number) || !std::isfinite(number)) {
+        return QObject::tr("expects a %1, got %2").arg(measureArgumentTypeName(argument.type), jsonText(value));
+      }
+      if (argument.type == MeasureArgument::Type::Integer && std::floor(number) != number) {
+        return QObject::tr("expects an Integer, got %1").arg(jsonText(value));
+      }
+      if (argument.minValue && number < *argument.minValue) {
+        return QObject::tr("is %1, under its minimum of %2").arg(number).arg(*argument.minValue);
+      }
+      if (argument.maxValue && number > *argument.maxValue) {
+        return QObject::tr("is %1, over its maximum of %2").arg(number).arg(*argument.maxValue);
+      }
+      break;
+    }
+    case MeasureArgument::Type::Choice: {
+      const QString text = value.isString() ? value.toString() : jsonText(value);
+      // Model dependent choices are only known once the model is loaded, measure.xml has none or only some of them
+      if (!argument.modelDependent && !argument.choices.isEmpty() && !argument.choices.contains(text)
+          && (text.isEmpty() || !argument.choiceDisplayNames.contains(text))) {
+        return QObject::tr("is %1, not one of %2").arg(jsonText(value), argument.choices.join(", "));
+      }
+      break;
+    }
+    case MeasureArgument::Type::String:
+    case MeasureArgument::Type::Path:
+    case MeasureArgument::Type::Unknown:
+      break;
+  }
+  return QString();
+}
+
+static void checkStep(const WorkflowFiles& files, int stepIndex, MeasureLibrary* measureLibrary, std::vector<WorkflowIssue>& issues) {
+  const WorkflowFiles::Step& step = files.steps[static_cast<size_t>(stepIndex)];
+  const QJsonObject stepObject = files.workflow.value("steps").toArray().at(stepIndex).toObject();
+  auto addIssue = [&](WorkflowIssue::Severity severity, const QString& message) {
+    const QString name = step.measureDirName.isEmpty() ? QString() : QStringLiteral(" (%1)").arg(step.measureDirName);
+    issues.push_back(WorkflowIssue{severity, stepIndex, QObject::tr("Step %1%2: %3").arg(stepIndex + 1).arg(name, message)});
+  };
+
+  if (step.measureDirName.isEmpty()) {
+    addIssue(WorkflowIssue::Severity::Error, QObject::tr("no measure_dir_name"));
+    return;
+  }
+  if (step.measureDir.isEmpty()) {
+    addIssue(WorkflowIssue::Severity::Error, QObject::tr("measure not found in the measure paths (%1)").arg(files.measurePaths().join(", ")));
+    return;
+  }
+  if (stepObject.contains("arguments") && !stepObject.value("arguments").isObject()) {
+    addIssue(WorkflowIssue::Severity::Error, QObject::tr("arguments is %1, not an object").arg(jsonText(stepObject.value("arguments"))));
+    return;
+  }
+
+  const auto schema = measureLibrary->schema(step.measureDir);
+  if (!schema) {
+    addIssue(WorkflowIssue::Severity::Error, QObject::tr("%1 has no measure.xml").arg(step.measureDir));
+    return;
+  }
+  if (!schema->error.isEmpty()) {
+    // Its arguments can't be known, the CLI gets to decide
+    addIssue(WorkflowIssue::Severity::Warning, QObject::tr("measure.xml can't be read, arguments not checked: %1").arg(schema->error));
+    return;
+  }
+
+  for (auto it = step.arguments.begin(); it != step.arguments.end(); ++it) {
+    const MeasureArgument* argument = schema->argument(it.key());
+    if (!argument) {
+      addIssue(WorkflowIssue::Severity::Warning, QObject::tr("%1 is not an argument of the measure").arg(it.key()));
+      continue;
+    }
+    const QString problem = checkArgumentValue(*argument, it.value());
+    if (!problem.isEmpty()) {
+      addIssue(WorkflowIssue::Severity::Error, QObject::tr("argument %1 %2").arg(it.key(), problem));
+    }
+  }
+  for (const MeasureArgument& argument : schema->arguments) {
+    if (argument.required && argument.defaultValue.isNull() && !step.arguments.contains(argument.name)) {
+      addIssue(WorkflowIssue::Severity::Error, QObject::tr("required argument %1 has no value and no default").arg(argument.name));
+    }
+  }
+}
+
+WorkflowValidation validateWorkflow(const QString& workflowJSONPath, MeasureLibrary* measureLibrary) {
+  QElapsedTimer timer;
+  timer.start();
+  WorkflowValidation validation;
+  auto& issues = validation.issues;
+
+  WorkflowFiles files;
+  QString error;
+  if (!files.load(workflowJSONPath, &error)) {
+    issues.push_back(WorkflowIssue{WorkflowIssue::Severity::Error, -1, error});
+    validation.elapsedMs = timer.elapsed();
+    return validation;
+  }
+
+  if (!files.seedFile.isEmpty() && files.seedPath.isEmpty()) {
+    issues.push_back(WorkflowIssue{WorkflowIssue::Severity::Error, -1,
+                                   QObject::tr("Seed model %1 not found in the file paths (%2)").arg(files.seedFile, files.filePaths().join(", "))});
+  } else if (files.seedPath.endsWith(".osm", Qt::CaseInsensitive)) {
+    // Only its head: OpenStudio writes OS:Version first, and reading the whole of a large model takes way longer than
+    // the rest of the checks put together
+    OsmFile osm;
+    QString osmError;
+    if (!osm.load(files.seedPath, &osmError, SeedHeadObjects)) {
+      issues.push_back(WorkflowIssue{WorkflowIssue::Severity::Error, -1, QObject::tr("Seed model: %1").arg(osmError)});
+    } else if (osm.objectsOfType("OS:Version").empty()) {
+      issues.push_back(WorkflowIssue{WorkflowIssue::Severity::Error, -1, QObject::tr("Seed model %1 has no OS:Version object").arg(files.seedPath)});
+    }
+  }
+  if (!files.weatherFile.isEmpty() && files.weatherPath.isEmpty()) {
+    issues.push_back(WorkflowIssue{WorkflowIssue::Severity::Error, -1,
+                                   QObject::tr("Weather file %1 not found in the file paths (%2)").arg(files.weatherFile, files.filePaths().join(", "))});
+  } else if (!files.weatherPath.isEmpty()) {
+    // Well under a millisecond, and EnergyPlus would only find out once the simulation starts
+    EpwFile epw;
+    QString epwError;
+    if (!epw.load(files.weatherPath, &epwError)) {
+      issues.push_back(WorkflowIssue{WorkflowIssue::Severity::Error, -1, QObject::tr("Weather file: %1").arg(epwError)});
+    } else if (epw.rowCount == 0) {
+      issues.push_back(WorkflowIssue{WorkflowIssue::Severity::Error, -1, QObject::tr("Weather file %1 has no data").arg(files.weatherPath)});
+    }
+  }
+
+  const QJsonValue steps = files.workflow.value("steps");
+  if (!steps.isUndefined() && !steps.isArray()) {
+    issues.push_back(WorkflowIssue{WorkflowIssue::Severity::Error, -1, QObject::tr("steps is %1, not a list").arg(jsonText(steps))});
+  }
+  const QJsonArray stepArray = steps.toArray();
+  for (int stepIndex = 0; stepIndex < static_cast<int>(files.steps.size()); ++stepIndex) {
+    if (!stepArray.at(stepIndex).isObject()) {
+      issues.push_back(WorkflowIssue{WorkflowIssue::Severity::Error, stepIndex,
+                                     QObject::tr("Step %1: %2, not an object").arg(stepIndex + 1).arg(jsonText(stepArray.at(stepIndex)))});
+      continue;
+    }
+    checkStep(files, stepIndex, measureLibrary, issues);
+  }
+
+  // Schemas parsed on the way are kept for the next time
+  measureLibrary->save();
+  validation.elapsedMs = timer.elapsed();
+  return validation;
+}
@@ -0,0 +1,42 @@
+#ifndef WORKFLOWVALIDATOR_HPP
+#define WORKFLOWVALIDATOR_HPP
+
+#include <QString>
+
+#include <vector>
+
+class MeasureLibrary;
+
+// Something wrong with a workflow that shows without running it
+struct WorkflowIssue
+{
+  enum class Severity
+  {
+    // The CLI would get past it
+    Warning,
+    // The CLI would fail on it
+    Error
+  };
+
+  Severity severity = Severity::Error;
+  // -1 when it's about the workflow rather than one of its steps
+  int stepIndex = -1;
+  QString message;
+};
+
+struct WorkflowValidation
+{
+  std::vector<WorkflowIssue> issues;
+  qint64 elapsedMs = 0;
+
+  int errorCount() const;
+};
+
+// Pre-flight check of an OSW: everything the CLI would only trip on after starting up, loading the seed model and
+// getting to the step. That's the OSW itself, its seed model (the head of it, for its OS:Version, see OsmFile) and
+// weather file (parsed, see EpwFile), each step's measure directory, and each step's arguments against its measure's
+// schema (type, min / max, choices, required ones missing).
+// Only reads what the measure library doesn't have cached yet, a few ms for a whole workflow.
+WorkflowValidation validateWorkflow(const QString& workflowJSONPath, MeasureLibrary* measureLibrary);
+
+#endif // WORKFLOWVALIDATOR_HPP